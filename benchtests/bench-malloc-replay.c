@@ -0,0 +1,647 @@
+/* Benchmark malloc by replaying allocation traces.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Usage: bench-malloc-replay [TRACE]
+
+   TRACE is either a log written by mtrace (see MALLOC_TRACE), which has
+   no thread information and is replayed by a single thread, or a file
+   with one event per line:
+
+     THREAD m ID SIZE		malloc (SIZE)
+     THREAD c ID SIZE		calloc (1, SIZE)
+     THREAD r ID NEWID SIZE	realloc (ID, SIZE)
+     THREAD f ID		free (ID)
+
+   where THREAD and ID are arbitrary numbers, and lines starting with #
+   are comments.  A block may be freed by another thread than the one
+   which allocated it.  Each thread of the trace is replayed by its own
+   thread, in trace order; a thread which frees a block allocated by
+   another waits until the block exists.  Without TRACE, a synthetic trace
+   of a server handling requests is replayed.
+
+   The benchmark reports the throughput, the median and 99th percentile
+   latency of the calls, the peak RSS, and the fragmentation, which is
+   the memory obtained by malloc from the system at the end of the replay
+   divided by the bytes live at that point.  The growth of the peak RSS
+   during the replay is also compared to the peak of the live bytes.  The
+   trace data is kept in mappings, so that it does not disturb the
+   heap.  */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bench-timing.h"
+#include "json-lib.h"
+
+#define MAX_THREADS		256
+
+/* Parameters of the synthetic trace.  */
+#define SYNTH_THREADS		4
+#define SYNTH_REQUESTS		20000
+#define SYNTH_MAX_OBJECTS	30
+#define SYNTH_CACHE_SIZE	1024
+#define RAND_SEED		88
+
+enum op_kind
+{
+  op_malloc,
+  op_calloc,
+  op_realloc,
+  op_free,
+};
+
+struct op
+{
+  uint32_t kind;
+  uint32_t thread;
+  /* Block allocated by the operation, or freed by op_free.  */
+  uint32_t slot;
+  /* Block resized by op_realloc.  */
+  uint32_t old_slot;
+  size_t size;
+};
+
+static struct op *ops;
+static size_t nops;
+static size_t nslots;
+
+/* Blocks of the trace, published by the allocating thread.  */
+static void **slots;
+/* Placeholder for blocks which realloc freed by returning NULL.  */
+#define SLOT_FREED ((void *) 1)
+
+static unsigned int nthreads;
+
+struct thread_data
+{
+  pthread_t thread;
+  /* Indices of the operations of the thread, in trace order.  */
+  size_t *ops;
+  size_t nops;
+  /* Latency of each allocation call.  */
+  timing_t *latencies;
+  size_t nlatencies;
+};
+
+static struct thread_data threads[MAX_THREADS];
+static pthread_barrier_t start_barrier;
+
+/* Bytes live at the end of the trace, and at most during it.  */
+static size_t live_bytes;
+static size_t peak_live_bytes;
+
+static void
+error_exit (const char *msg)
+{
+  fprintf (stderr, "bench-malloc-replay: %s\n", msg);
+  exit (1);
+}
+
+/* Allocate SIZE bytes for the benchmark data, outside the heap.  */
+static void *
+xmap (size_t size)
+{
+  if (size == 0)
+    size = 1;
+  void *p = mmap (NULL, size, PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    error_exit ("out of memory for trace data");
+  return p;
+}
+
+/* Map from trace block ids to slots, with open addressing.  Ids are
+   never removed: allocating an id again replaces its slot.  */
+static uint64_t *id_keys;
+static uint32_t *id_slots;
+static size_t id_mask;
+
+static void
+id_map_init (size_t capacity)
+{
+  size_t size = 16;
+  while (size < 2 * capacity)
+    size *= 2;
+  id_keys = xmap (size * sizeof (*id_keys));
+  id_slots = xmap (size * sizeof (*id_slots));
+  id_mask = size - 1;
+}
+
+static size_t
+id_index (uint64_t id)
+{
+  size_t i = (id * 0x9e3779b97f4a7c15ULL) >> 20;
+  /* Slot 0 is never used, so that id_slots is 0 for empty entries.  */
+  while (id_slots[i & id_mask] != 0 && id_keys[i & id_mask] != id)
+    ++i;
+  return i & id_mask;
+}
+
+/* Return the slot of a new block with ID.  */
+static uint32_t
+id_new (uint64_t id)
+{
+  size_t i = id_index (id);
+  id_keys[i] = id;
+  id_slots[i] = ++nslots;
+  return nslots;
+}
+
+/* Return the slot of the live block with ID, or 0 if there is none.  */
+static uint32_t
+id_lookup (uint64_t id)
+{
+  return id_slots[id_index (id)];
+}
+
+static unsigned int
+thread_index (unsigned long id)
+{
+  static unsigned long ids[MAX_THREADS];
+  for (unsigned int i = 0; i < nthreads; ++i)
+    if (ids[i] == id)
+      return i;
+  if (nthreads == MAX_THREADS)
+    error_exit ("too many threads in trace");
+  ids[nthreads] = id;
+  return nthreads++;
+}
+
+static void
+add_op (enum op_kind kind, unsigned int thread, uint32_t slot,
+	uint32_t old_slot, size_t size)
+{
+  ops[nops++] = (struct op) { kind, thread, slot, old_slot, size };
+}
+
+/* Parse a line of an mtrace log.  PENDING is the slot of a block whose
+   realloc has been logged by a "<" line, waiting for the ">" line.  */
+static void
+parse_mtrace_line (char *line, uint32_t *pending)
+{
+  /* The lines look like "@ CALLER + ADDR SIZE", where CALLER may
+     contain spaces, so look for the last operator.  */
+  char *op = NULL;
+  for (char *p = line; (p = strpbrk (p, "+-<>")) != NULL; ++p)
+    if (p[-1] == ' ' && p[1] == ' ')
+      op = p;
+  if (line[0] != '@' || op == NULL)
+    return;
+
+  char *end;
+  uint64_t addr = strtoull (op + 2, &end, 16);
+  size_t size = strtoull (end, NULL, 16);
+  if (addr == 0)
+    return;
+
+  switch (*op)
+    {
+    case '+':
+      add_op (op_malloc, 0, id_new (addr), 0, size);
+      break;
+    case '-':
+      {
+	uint32_t slot = id_lookup (addr);
+	if (slot != 0)
+	  add_op (op_free, 0, slot, 0, 0);
+      }
+      break;
+    case '<':
+      *pending = id_lookup (addr);
+      break;
+    case '>':
+      if (*pending != 0)
+	add_op (op_realloc, 0, id_new (addr), *pending, size);
+      else
+	add_op (op_malloc, 0, id_new (addr), 0, size);
+      *pending = 0;
+      break;
+    }
+}
+
+static void
+parse_native_line (char *line)
+{
+  unsigned long thread;
+  char kind;
+  unsigned long long id, new_id;
+  size_t size;
+
+  if (line[0] == '#' || line[0] == '\0')
+    return;
+  if (sscanf (line, "%lu %c %llu", &thread, &kind, &id) != 3)
+    error_exit ("invalid trace line");
+
+  unsigned int t = thread_index (thread);
+  switch (kind)
+    {
+    case 'm':
+    case 'c':
+      if (sscanf (line, "%*u %*c %*u %zu", &size) != 1)
+	error_exit ("invalid allocation in trace");
+      add_op (kind == 'm' ? op_malloc : op_calloc, t, id_new (id), 0, size);
+      break;
+    case 'r':
+      {
+	if (sscanf (line, "%*u %*c %*u %llu %zu", &new_id, &size) != 2)
+	  error_exit ("invalid realloc in trace");
+	uint32_t old_slot = id_lookup (id);
+	if (old_slot != 0)
+	  add_op (op_realloc, t, id_new (new_id), old_slot, size);
+	else
+	  add_op (op_malloc, t, id_new (new_id), 0, size);
+      }
+      break;
+    case 'f':
+      {
+	uint32_t slot = id_lookup (id);
+	if (slot != 0)
+	  add_op (op_free, t, slot, 0, 0);
+      }
+      break;
+    default:
+      error_exit ("invalid operation in trace");
+    }
+}
+
+static void
+load_trace (const char *name)
+{
+  int fd = open (name, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat (fd, &st) != 0)
+    error_exit ("cannot open trace");
+
+  /* Copy the file to a private mapping with a terminating null byte,
+     so that its lines can be parsed in place.  */
+  char *data = xmap (st.st_size + 1);
+  for (off_t done = 0; done < st.st_size; )
+    {
+      ssize_t n = read (fd, data + done, st.st_size - done);
+      if (n <= 0)
+	error_exit ("cannot read trace");
+      done += n;
+    }
+  close (fd);
+
+  size_t lines = 1;
+  for (char *p = data; (p = memchr (p, '\n', data + st.st_size - p)) != NULL;
+       ++p)
+    ++lines;
+  ops = xmap (lines * sizeof (*ops));
+  id_map_init (lines);
+
+  bool mtrace = strncmp (data, "= Start", 7) == 0 || data[0] == '@';
+  uint32_t pending = 0;
+  for (char *line = data, *next; line != NULL; line = next)
+    {
+      next = strchr (line, '\n');
+      if (next != NULL)
+	*next++ = '\0';
+      if (mtrace)
+	parse_mtrace_line (line, &pending);
+      else
+	parse_native_line (line);
+    }
+  if (mtrace)
+    nthreads = 1;
+
+  munmap (data, st.st_size + 1);
+}
+
+/* Random numbers for the synthetic trace, independent of the libc
+   state.  */
+static uint64_t rand_state = RAND_SEED;
+
+static uint32_t
+synth_rand (void)
+{
+  rand_state = rand_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return rand_state >> 33;
+}
+
+/* Request sizes: mostly small objects, some buffers, few large ones.  */
+static size_t
+synth_size (void)
+{
+  uint32_t r = synth_rand () % 100;
+  if (r < 70)
+    return 16 + synth_rand () % 240;
+  if (r < 95)
+    return 256 + synth_rand () % 3840;
+  return 4096 + synth_rand () % 61440;
+}
+
+/* Generate the trace of SYNTH_THREADS threads, each handling requests
+   in turn.  A request allocates some objects and frees most of them
+   again before it ends.  The others go to a shared cache, and are freed
+   by the thread which evicts them.  The cache is still live at the end
+   of the trace.  */
+static void
+generate_trace (void)
+{
+  size_t max_ops = (size_t) SYNTH_THREADS * SYNTH_REQUESTS
+		   * SYNTH_MAX_OBJECTS * 2 + SYNTH_CACHE_SIZE;
+  ops = xmap (max_ops * sizeof (*ops));
+  nthreads = SYNTH_THREADS;
+
+  static uint32_t cache[SYNTH_CACHE_SIZE];
+  uint32_t objects[SYNTH_MAX_OBJECTS];
+
+  for (unsigned int r = 0; r < SYNTH_REQUESTS; ++r)
+    for (unsigned int t = 0; t < SYNTH_THREADS; ++t)
+      {
+	unsigned int n = 1 + synth_rand () % SYNTH_MAX_OBJECTS;
+	for (unsigned int i = 0; i < n; ++i)
+	  {
+	    objects[i] = ++nslots;
+	    add_op (i % 4 == 0 ? op_calloc : op_malloc, t, objects[i], 0,
+		    synth_size ());
+	  }
+
+	/* Some requests grow a buffer.  */
+	if (synth_rand () % 8 == 0)
+	  {
+	    uint32_t old_slot = objects[0];
+	    objects[0] = ++nslots;
+	    add_op (op_realloc, t, objects[0], old_slot,
+		    2 * ops[nops - n].size + synth_rand () % 1024);
+	  }
+
+	/* Free in a different order than allocated.  */
+	for (unsigned int i = n - 1; i > 0; --i)
+	  {
+	    unsigned int j = synth_rand () % (i + 1);
+	    uint32_t tmp = objects[i];
+	    objects[i] = objects[j];
+	    objects[j] = tmp;
+	  }
+
+	for (unsigned int i = 0; i < n; ++i)
+	  if (synth_rand () % 10 == 0)
+	    {
+	      uint32_t *entry = &cache[synth_rand () % SYNTH_CACHE_SIZE];
+	      if (*entry != 0)
+		add_op (op_free, t, *entry, 0, 0);
+	      *entry = objects[i];
+	    }
+	  else
+	    add_op (op_free, t, objects[i], 0, 0);
+      }
+
+}
+
+/* Compute the bytes live at the end and at most, and distribute the
+   operations to the threads.  */
+static void
+prepare_replay (void)
+{
+  size_t *sizes = xmap ((nslots + 1) * sizeof (*sizes));
+  for (size_t i = 0; i < nops; ++i)
+    {
+      struct op *op = &ops[i];
+      if (op->kind == op_realloc)
+	live_bytes -= sizes[op->old_slot];
+      if (op->kind == op_free)
+	live_bytes -= sizes[op->slot];
+      else
+	{
+	  sizes[op->slot] = op->size;
+	  live_bytes += op->size;
+	}
+      if (live_bytes > peak_live_bytes)
+	peak_live_bytes = live_bytes;
+      ++threads[op->thread].nops;
+    }
+  munmap (sizes, (nslots + 1) * sizeof (*sizes));
+
+  for (unsigned int t = 0; t < nthreads; ++t)
+    {
+      threads[t].ops = xmap (threads[t].nops * sizeof (size_t));
+      threads[t].latencies = xmap (threads[t].nops * sizeof (timing_t));
+      threads[t].nops = 0;
+    }
+  for (size_t i = 0; i < nops; ++i)
+    {
+      struct thread_data *td = &threads[ops[i].thread];
+      td->ops[td->nops++] = i;
+    }
+
+  slots = xmap ((nslots + 1) * sizeof (*slots));
+
+  /* Fault in the data written during the replay, so that it is not
+     counted in the growth of the RSS.  */
+  memset (slots, 0, (nslots + 1) * sizeof (*slots));
+  for (unsigned int t = 0; t < nthreads; ++t)
+    memset (threads[t].latencies, 0, threads[t].nops * sizeof (timing_t));
+}
+
+/* Wait until the block in SLOT has been allocated, possibly by another
+   thread, and return it.  */
+static void *
+wait_slot (uint32_t slot)
+{
+  void *p;
+  while ((p = __atomic_load_n (&slots[slot], __ATOMIC_ACQUIRE)) == NULL)
+    sched_yield ();
+  return p;
+}
+
+/* Write to every page of a new block, as its user would.  */
+static void
+touch (char *p, size_t size)
+{
+  for (size_t i = 0; i < size; i += 4096)
+    p[i] = 1;
+}
+
+static void *
+replay_thread (void *closure)
+{
+  struct thread_data *td = closure;
+  timing_t start, stop, elapsed;
+
+  pthread_barrier_wait (&start_barrier);
+
+  for (size_t i = 0; i < td->nops; ++i)
+    {
+      struct op *op = &ops[td->ops[i]];
+      void *p = NULL;
+
+      switch (op->kind)
+	{
+	case op_malloc:
+	  TIMING_NOW (start);
+	  p = malloc (op->size);
+	  TIMING_NOW (stop);
+	  break;
+	case op_calloc:
+	  TIMING_NOW (start);
+	  p = calloc (1, op->size);
+	  TIMING_NOW (stop);
+	  break;
+	case op_realloc:
+	  {
+	    void *old = wait_slot (op->old_slot);
+	    if (old == SLOT_FREED)
+	      old = NULL;
+	    TIMING_NOW (start);
+	    p = realloc (old, op->size);
+	    TIMING_NOW (stop);
+	    if (p == NULL && op->size == 0)
+	      p = SLOT_FREED;
+	  }
+	  break;
+	case op_free:
+	  p = wait_slot (op->slot);
+	  if (p != SLOT_FREED)
+	    {
+	      TIMING_NOW (start);
+	      free (p);
+	      TIMING_NOW (stop);
+	      TIMING_DIFF (elapsed, start, stop);
+	      td->latencies[td->nlatencies++] = elapsed;
+	    }
+	  continue;
+	}
+
+      if (p == NULL)
+	error_exit ("allocation failed");
+      TIMING_DIFF (elapsed, start, stop);
+      td->latencies[td->nlatencies++] = elapsed;
+      if (p != SLOT_FREED)
+	touch (p, op->size);
+      __atomic_store_n (&slots[op->slot], p, __ATOMIC_RELEASE);
+    }
+
+  return NULL;
+}
+
+static int
+compare_timing (const void *a, const void *b)
+{
+  timing_t ta = *(const timing_t *) a;
+  timing_t tb = *(const timing_t *) b;
+  return ta < tb ? -1 : ta > tb;
+}
+
+int
+main (int argc, char **argv)
+{
+  json_ctx_t json_ctx;
+  timing_t start, stop, elapsed;
+  struct rusage usage;
+
+  if (argc > 2)
+    {
+      fprintf (stderr, "usage: %s [TRACE]\n", argv[0]);
+      return 1;
+    }
+  if (argc == 2)
+    load_trace (argv[1]);
+  else
+    generate_trace ();
+  if (nops == 0)
+    error_exit ("empty trace");
+  prepare_replay ();
+
+  getrusage (RUSAGE_SELF, &usage);
+  long max_rss_before = usage.ru_maxrss;
+
+  pthread_barrier_init (&start_barrier, NULL, nthreads + 1);
+  for (unsigned int t = 0; t < nthreads; ++t)
+    if (pthread_create (&threads[t].thread, NULL, replay_thread,
+			&threads[t]) != 0)
+      error_exit ("cannot create thread");
+
+  pthread_barrier_wait (&start_barrier);
+  TIMING_NOW (start);
+  for (unsigned int t = 0; t < nthreads; ++t)
+    pthread_join (threads[t].thread, NULL);
+  TIMING_NOW (stop);
+  TIMING_DIFF (elapsed, start, stop);
+
+  getrusage (RUSAGE_SELF, &usage);
+  struct mallinfo2 mi = mallinfo2 ();
+  size_t system_bytes = mi.arena + mi.hblkhd;
+
+  /* Merge the latencies of all threads.  */
+  size_t nlatencies = 0;
+  for (unsigned int t = 0; t < nthreads; ++t)
+    nlatencies += threads[t].nlatencies;
+  timing_t *latencies = xmap (nlatencies * sizeof (*latencies));
+  nlatencies = 0;
+  for (unsigned int t = 0; t < nthreads; ++t)
+    {
+      memcpy (latencies + nlatencies, threads[t].latencies,
+	      threads[t].nlatencies * sizeof (*latencies));
+      nlatencies += threads[t].nlatencies;
+    }
+  qsort (latencies, nlatencies, sizeof (*latencies), compare_timing);
+
+  json_init (&json_ctx, 0, stdout);
+  json_document_begin (&json_ctx);
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+  json_attr_object_begin (&json_ctx, "functions");
+  json_attr_object_begin (&json_ctx, "malloc");
+  json_attr_object_begin (&json_ctx, "replay");
+
+  json_attr_string (&json_ctx, "trace", argc == 2 ? argv[1] : "synthetic");
+  json_attr_uint (&json_ctx, "threads", nthreads);
+  json_attr_uint (&json_ctx, "operations", nops);
+  json_attr_double (&json_ctx, "duration", elapsed);
+  json_attr_double (&json_ctx, "time_per_operation",
+		    (double) elapsed / nops);
+  json_attr_double (&json_ctx, "latency_p50",
+		    latencies[nlatencies / 2]);
+  json_attr_double (&json_ctx, "latency_p99",
+		    latencies[nlatencies - 1 - nlatencies / 100]);
+  json_attr_double (&json_ctx, "latency_max", latencies[nlatencies - 1]);
+  json_attr_uint (&json_ctx, "max_rss_kib", usage.ru_maxrss);
+  json_attr_uint (&json_ctx, "max_rss_kib_before", max_rss_before);
+  json_attr_uint (&json_ctx, "peak_live_bytes", peak_live_bytes);
+  json_attr_uint (&json_ctx, "live_bytes", live_bytes);
+  json_attr_uint (&json_ctx, "system_bytes", system_bytes);
+  if (live_bytes != 0)
+    json_attr_double (&json_ctx, "fragmentation",
+		      (double) system_bytes / live_bytes);
+  if (peak_live_bytes != 0)
+    json_attr_double (&json_ctx, "peak_rss_overhead",
+		      (usage.ru_maxrss - max_rss_before) * 1024.0
+		      / peak_live_bytes);
+
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+  json_document_end (&json_ctx);
+
+  return 0;
+}
@@ -0,0 +1,228 @@
+/* Measure thread-specific data access and destruction.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define TEST_MAIN
+#define TEST_NAME "pthread-specific"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bench-timing.h"
+#include "bench-util.h"
+#include "json-lib.h"
+
+/* The number of keys to create.  Keys are allocated lowest first, so
+   the last ones are beyond the first block of 32 keys which is part of
+   the thread descriptor.  */
+#define NKEYS 64
+
+#define ACCESS_ITERS 10000000
+#define EXIT_ITERS 10000
+
+static pthread_key_t keys[NKEYS];
+static pthread_key_t key_low;
+static pthread_key_t key_high;
+
+static void
+destructor (void *value)
+{
+}
+
+typedef timing_t (*test_t)(long);
+
+static timing_t
+test_get_low (long iters)
+{
+  timing_t start, stop, cur;
+  pthread_setspecific (key_low, &iters);
+  TIMING_NOW (start);
+  for (long j = iters; j >= 0; --j)
+    DO_NOT_OPTIMIZE_OUT (pthread_getspecific (key_low));
+  TIMING_NOW (stop);
+  TIMING_DIFF (cur, start, stop);
+  pthread_setspecific (key_low, NULL);
+  return cur;
+}
+
+static timing_t
+test_get_high (long iters)
+{
+  timing_t start, stop, cur;
+  pthread_setspecific (key_high, &iters);
+  TIMING_NOW (start);
+  for (long j = iters; j >= 0; --j)
+    DO_NOT_OPTIMIZE_OUT (pthread_getspecific (key_high));
+  TIMING_NOW (stop);
+  TIMING_DIFF (cur, start, stop);
+  pthread_setspecific (key_high, NULL);
+  return cur;
+}
+
+static timing_t
+test_set_low (long iters)
+{
+  timing_t start, stop, cur;
+  TIMING_NOW (start);
+  for (long j = iters; j >= 0; --j)
+    pthread_setspecific (key_low, &j);
+  TIMING_NOW (stop);
+  TIMING_DIFF (cur, start, stop);
+  pthread_setspecific (key_low, NULL);
+  return cur;
+}
+
+static timing_t
+test_set_high (long iters)
+{
+  timing_t start, stop, cur;
+  TIMING_NOW (start);
+  for (long j = iters; j >= 0; --j)
+    pthread_setspecific (key_high, &j);
+  TIMING_NOW (stop);
+  TIMING_DIFF (cur, start, stop);
+  pthread_setspecific (key_high, NULL);
+  return cur;
+}
+
+/* Thread functions which set the given keys and exit, which runs the
+   destructors.  */
+
+static void *
+thread_none (void *closure)
+{
+  return NULL;
+}
+
+static void *
+thread_low (void *closure)
+{
+  pthread_setspecific (key_low, closure);
+  return NULL;
+}
+
+static void *
+thread_high (void *closure)
+{
+  pthread_setspecific (key_high, closure);
+  return NULL;
+}
+
+static void *
+thread_all (void *closure)
+{
+  for (int i = 0; i < NKEYS; ++i)
+    pthread_setspecific (keys[i], closure);
+  return NULL;
+}
+
+static timing_t
+run_threads (long iters, void *(*start_routine) (void *))
+{
+  timing_t start, stop, cur;
+  TIMING_NOW (start);
+  for (long j = iters; j >= 0; --j)
+    {
+      pthread_t thr;
+      if (pthread_create (&thr, NULL, start_routine, &thr) != 0)
+	{
+	  printf ("error: pthread_create failed\n");
+	  exit (1);
+	}
+      pthread_join (thr, NULL);
+    }
+  TIMING_NOW (stop);
+  TIMING_DIFF (cur, start, stop);
+  return cur;
+}
+
+static timing_t
+test_exit_none (long iters)
+{
+  return run_threads (iters, thread_none);
+}
+
+static timing_t
+test_exit_low (long iters)
+{
+  return run_threads (iters, thread_low);
+}
+
+static timing_t
+test_exit_high (long iters)
+{
+  return run_threads (iters, thread_high);
+}
+
+static timing_t
+test_exit_all (long iters)
+{
+  return run_threads (iters, thread_all);
+}
+
+static void
+do_bench_1 (const char *name, test_t func, long iters, json_ctx_t *js)
+{
+  /* Warm up, which also fills the thread stack cache.  */
+  func (iters / 10);
+
+  timing_t cur = func (iters);
+
+  json_attr_object_begin (js, name);
+  json_attr_double (js, "duration", (double) cur);
+  json_attr_double (js, "iterations", (double) iters);
+  json_attr_double (js, "mean", (double) cur / (double) iters);
+  json_attr_object_end (js);
+}
+
+static int
+do_bench (void)
+{
+  for (int i = 0; i < NKEYS; ++i)
+    if (pthread_key_create (&keys[i], destructor) != 0)
+      {
+	printf ("error: pthread_key_create failed\n");
+	return 1;
+      }
+  key_low = keys[0];
+  key_high = keys[NKEYS - 1];
+
+  json_ctx_t json_ctx;
+  json_init (&json_ctx, 2, stdout);
+  json_attr_object_begin (&json_ctx, "pthread_specific");
+
+#define BENCH(n, iters) do_bench_1 (#n, test_##n, iters, &json_ctx)
+
+  BENCH (get_low, ACCESS_ITERS);
+  BENCH (get_high, ACCESS_ITERS);
+  BENCH (set_low, ACCESS_ITERS);
+  BENCH (set_high, ACCESS_ITERS);
+  BENCH (exit_none, EXIT_ITERS);
+  BENCH (exit_low, EXIT_ITERS);
+  BENCH (exit_high, EXIT_ITERS);
+  BENCH (exit_all, EXIT_ITERS);
+
+  json_attr_object_end (&json_ctx);
+
+  for (int i = 0; i < NKEYS; ++i)
+    pthread_key_delete (keys[i]);
+  return 0;
+}
+
+#define TEST_FUNCTION do_bench ()
+
+#include "../test-skeleton.c"
@@ -48,12 +48,21 @@ dlsym_implementation (void *handle, const char *name, void *dl_caller)
   args.handle = handle;
   args.name = name;
 
-  /* Protect against concurrent loads and unloads.  */
-  __rtld_lock_lock_recursive (GL(dl_load_lock));
+  /* Lookups in the local scope of a handle are protected against
+     concurrent loads and unloads like lazy binding, so they do not
+     have to wait for a concurrent dlopen.  RTLD_DEFAULT and RTLD_NEXT
+     can search the global scope, which dlopen extends with RTLD_GLOBAL
+     objects before their ELF constructors have run.  Acquire
+     GL(dl_load_lock) for them, so that those objects only become
+     visible once dlopen has completed.  */
+  bool lock = handle == RTLD_DEFAULT || handle == RTLD_NEXT;
+  if (lock)
+    __rtld_lock_lock_recursive (GL(dl_load_lock));
 
   void *result = (_dlerror_run (dlsym_doit, &args) ? NULL : args.sym);
 
-  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+  if (lock)
+    __rtld_lock_unlock_recursive (GL(dl_load_lock));
 
   return result;
 }
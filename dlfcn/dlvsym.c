@@ -51,12 +51,15 @@ dlvsym_implementation (void *handle, const char *name, const char *version,
   args.name = name;
   args.version = version;
 
-  /* Protect against concurrent loads and unloads.  */
-  __rtld_lock_lock_recursive (GL(dl_load_lock));
+  /* See dlsym_implementation in dlsym.c.  */
+  bool lock = handle == RTLD_DEFAULT || handle == RTLD_NEXT;
+  if (lock)
+    __rtld_lock_lock_recursive (GL(dl_load_lock));
 
   void *result = (_dlerror_run (dlvsym_doit, &args) ? NULL : args.sym);
 
-  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+  if (lock)
+    __rtld_lock_unlock_recursive (GL(dl_load_lock));
 
   return result;
 }
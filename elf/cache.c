@@ -447,6 +447,60 @@ enum
 			      * sizeof (struct cache_extension_section)))
   };
 
+/* Build the cache_extension_tag_name_hash section for the entries.
+   Store its size in *SIZE.  Entries with the same name are adjacent,
+   and only the first one is added to the table.  */
+static uint32_t *
+build_name_hash (uint32_t *size)
+{
+  uint32_t names = 0;
+  const char *previous = NULL;
+  for (struct cache_entry *entry = entries; entry != NULL;
+       entry = entry->next)
+    {
+      if (previous == NULL
+	  || _dl_cache_libcmp (previous, entry->lib->string) != 0)
+	++names;
+      previous = entry->lib->string;
+    }
+
+  /* Use a load factor of at most one half.  This also keeps one slot
+     empty, which terminates unsuccessful searches.  */
+  uint32_t slots = 1;
+  while (slots < 2 * names)
+    slots *= 2;
+
+  *size = (1 + 2 * slots) * sizeof (uint32_t);
+  uint32_t *table = xmalloc (*size);
+  table[0] = slots;
+  uint32_t *slot_data = table + 1;
+  for (uint32_t i = 0; i < slots; ++i)
+    {
+      slot_data[2 * i] = 0;
+      slot_data[2 * i + 1] = UINT32_MAX;
+    }
+
+  previous = NULL;
+  uint32_t index = 0;
+  for (struct cache_entry *entry = entries; entry != NULL;
+       entry = entry->next, ++index)
+    {
+      if (previous == NULL
+	  || _dl_cache_libcmp (previous, entry->lib->string) != 0)
+	{
+	  uint32_t hash = _dl_cache_name_hash (entry->lib->string);
+	  uint32_t i = hash & (slots - 1);
+	  while (slot_data[2 * i + 1] != UINT32_MAX)
+	    i = (i + 1) & (slots - 1);
+	  slot_data[2 * i] = hash;
+	  slot_data[2 * i + 1] = index;
+	}
+      previous = entry->lib->string;
+    }
+
+  return table;
+}
+
 /* Write the cache extensions to FD.  The string table is shifted by
    STRING_TABLE_OFFSET.  The extension directory is assumed to be
    located at CACHE_EXTENSION_OFFSET.  assign_glibc_hwcaps_indices
@@ -460,21 +514,23 @@ write_extensions (int fd, uint32_t str_offset,
   /* The length and contents of the glibc-hwcaps section.  */
   uint32_t hwcaps_count = glibc_hwcaps_count ();
   uint32_t hwcaps_offset = cache_extension_offset + cache_extension_size;
+  if (hwcaps_count == 0)
+    /* There is no section for the hwcaps subdirectories.  */
+    hwcaps_offset -= sizeof (struct cache_extension_section);
   uint32_t hwcaps_size = hwcaps_count * sizeof (uint32_t);
   uint32_t *hwcaps_array = xmalloc (hwcaps_size);
   for (struct glibc_hwcaps_subdirectory *p = hwcaps; p != NULL; p = p->next)
     if (p->used)
       hwcaps_array[p->section_index] = str_offset + p->name->offset;
 
+  /* The name hash table follows the hwcaps subdirectories, so that
+     both are aligned at 4 bytes.  */
+  uint32_t name_hash_size;
+  uint32_t *name_hash = build_name_hash (&name_hash_size);
+  uint32_t name_hash_offset = hwcaps_offset + hwcaps_size;
+
   /* This is the offset of the generator string.  */
-  uint32_t generator_offset = hwcaps_offset;
-  if (hwcaps_count == 0)
-    /* There is no section for the hwcaps subdirectories.  */
-    generator_offset -= sizeof (struct cache_extension_section);
-  else
-    /* The string table indices for the hwcaps subdirectories shift
-       the generator string backwards.  */
-    generator_offset += hwcaps_size;
+  uint32_t generator_offset = name_hash_offset + name_hash_size;
 
   struct cache_extension *ext = xmalloc (cache_extension_size);
   ext->magic = cache_extension_magic;
@@ -498,17 +554,26 @@ write_extensions (int fd, uint32_t str_offset,
       ext->sections[xid].size = hwcaps_size;
     }
 
+  ++xid;
+  ext->sections[xid].tag = cache_extension_tag_name_hash;
+  ext->sections[xid].flags = 0;
+  ext->sections[xid].offset = name_hash_offset;
+  ext->sections[xid].size = name_hash_size;
+
   ++xid;
   ext->count = xid;
   assert (xid <= cache_extension_count);
 
   size_t ext_size = (offsetof (struct cache_extension, sections)
 		     + xid * sizeof (struct cache_extension_section));
+  assert (cache_extension_offset + ext_size == hwcaps_offset);
   if (write (fd, ext, ext_size) != ext_size
       || write (fd, hwcaps_array, hwcaps_size) != hwcaps_size
+      || write (fd, name_hash, name_hash_size) != name_hash_size
       || write (fd, generator, strlen (generator)) != strlen (generator))
     error (EXIT_FAILURE, errno, _("Writing of cache extension data failed"));
 
+  free (name_hash);
   free (hwcaps_array);
   free (ext);
 }
@@ -121,8 +121,11 @@ _dl_addr (const void *address, Dl_info *info,
   const ElfW(Addr) addr = DL_LOOKUP_ADDRESS (address);
   int result = 0;
 
-  /* Protect against concurrent loads and unloads.  */
-  __rtld_lock_lock_recursive (GL(dl_load_lock));
+  /* Protect against concurrent loads and unloads.  Objects are only
+     added to the namespace lists once their symbol tables are set up,
+     and are unmapped under GL(dl_load_write_lock), so it is not
+     necessary to wait for a concurrent dlopen to finish.  */
+  __rtld_lock_lock_recursive (GL(dl_load_write_lock));
 
   struct link_map *l = _dl_find_dso_for_object (addr);
 
@@ -132,7 +135,7 @@ _dl_addr (const void *address, Dl_info *info,
       result = 1;
     }
 
-  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+  __rtld_lock_unlock_recursive (GL(dl_load_write_lock));
 
   return result;
 }
@@ -0,0 +1,660 @@
+/* Persistent symbol binding cache for the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The cache file consists of a header, the key and a hash table of
+   lookup results.
+
+   The key identifies the set of initial objects: their build IDs in the
+   order of the link map list, the order of the global search list, and
+   whether relocation is lazy.  Objects and symbols are referred to by
+   their index, so that the cache does not depend on load addresses.
+   Everything else which influences the result of a relocation lookup is
+   part of the objects themselves, or disables the cache (auditing,
+   LD_DYNAMIC_WEAK, and LD_DEBUG options which report lookups).
+
+   If the file is missing or does not match, the results of the lookups
+   are recorded, and a new file is written after relocation.  It is
+   created under a temporary name and renamed, so that concurrently
+   starting processes never see a partially written file.  */
+
+#include <dl-bind-cache.h>
+#include <_itoa.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <libc-pointer-arith.h>
+#include <not-cancel.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dl-tunables.h>
+
+enum dl_bind_cache_mode _dl_bind_cache_mode;
+unsigned long int _dl_bind_cache_hits;
+
+#define BIND_CACHE_MAGIC "ld.so-bc"
+#define BIND_CACHE_VERSION 1
+
+/* Index used for the definition of an unresolved weak reference.  */
+#define BIND_CACHE_NONE UINT32_MAX
+
+/* Initial number of hash table slots, and the maximum number, which
+   bounds the size of the file we accept.  */
+#define BIND_CACHE_INITIAL_SIZE 4096
+#define BIND_CACHE_MAX_SIZE (1U << 26)
+
+struct bind_cache_header
+{
+  char magic[8];
+  uint32_t version;
+  /* Size of the key in bytes.  */
+  uint32_t key_size;
+  /* Number of entries in the hash table, a power of two.  */
+  uint32_t table_size;
+  /* Checksum of the key and the table.  */
+  uint32_t checksum;
+};
+
+struct bind_cache_entry
+{
+  /* Index of the referencing object plus one, or zero for an empty
+     slot.  */
+  uint32_t ref_map;
+  /* Index of the reference in the symbol table of the referencing
+     object.  */
+  uint32_t ref_symidx;
+  /* The ELF_RTYPE_CLASS_* of the lookup.  */
+  uint32_t type_class;
+  /* Index of the defining object, or BIND_CACHE_NONE.  */
+  uint32_t def_map;
+  /* Index of the definition in the symbol table of the defining
+     object.  */
+  uint32_t def_symidx;
+};
+
+static struct
+{
+  /* NUL-terminated file name.  */
+  char *path;
+
+  /* The initial objects, in link map order.  */
+  struct link_map **maps;
+  uint32_t nmaps;
+
+  /* Number of symbols in the symbol tables of the initial objects, or
+     zero if not known yet.  */
+  uint32_t *nsyms;
+
+  /* The most recently used referencing object and its index.  */
+  struct link_map *last_map;
+  uint32_t last_idx;
+
+  uint32_t *key;
+  uint32_t key_size;
+
+  /* The hash table, either part of the mapped file or allocated for
+     recording.  */
+  struct bind_cache_entry *table;
+  uint32_t table_size;
+  uint32_t used;
+
+  /* The mapping of the cache file in dl_bind_cache_use mode.  */
+  void *file;
+  size_t file_size;
+} bind_cache;
+
+static inline uint32_t
+bind_cache_hash (uint32_t ref_map, uint32_t ref_symidx, uint32_t type_class)
+{
+  uint32_t h = ref_symidx * 0x9e3779b1U ^ (ref_map << 8 | type_class);
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  return h;
+}
+
+static uint32_t
+bind_cache_checksum (const uint32_t *words, size_t nwords, uint32_t h)
+{
+  /* FNV-1a over 32-bit words.  This only protects against truncated or
+     otherwise damaged files.  */
+  for (size_t i = 0; i < nwords; ++i)
+    h = (h ^ words[i]) * 16777619U;
+  return h;
+}
+
+/* Find the NT_GNU_BUILD_ID note of L.  */
+static bool
+bind_cache_build_id (struct link_map *l, const void **id, uint32_t *len)
+{
+  for (const ElfW(Phdr) *ph = l->l_phdr; ph < &l->l_phdr[l->l_phnum]; ++ph)
+    {
+      if (ph->p_type != PT_NOTE)
+	continue;
+
+      const ElfW(Addr) align = ph->p_align == 8 ? 8 : 4;
+      const ElfW(Addr) start = l->l_addr + ph->p_vaddr;
+      const ElfW(Addr) end = start + ph->p_memsz;
+      ElfW(Addr) addr = start;
+      while (addr + sizeof (ElfW(Nhdr)) <= end)
+	{
+	  const ElfW(Nhdr) *note = (const void *) addr;
+	  ElfW(Addr) desc = ALIGN_UP (addr + sizeof (ElfW(Nhdr))
+				      + note->n_namesz, align);
+	  ElfW(Addr) next = ALIGN_UP (desc + note->n_descsz, align);
+	  if (desc > end || next > end || next <= addr)
+	    break;
+	  if (note->n_type == NT_GNU_BUILD_ID
+	      && note->n_namesz == 4
+	      && memcmp (note + 1, "GNU", 4) == 0
+	      && note->n_descsz > 0)
+	    {
+	      *id = (const void *) desc;
+	      *len = note->n_descsz;
+	      return true;
+	    }
+	  addr = next;
+	}
+    }
+  return false;
+}
+
+/* Compute the key for the initial objects and MAIN_MAP's search list,
+   storing it in KEY if it is not NULL.  Return the size of the key in
+   32-bit words, or zero if an object has no build ID.  */
+static size_t
+bind_cache_make_key (struct link_map *main_map, uint32_t *key)
+{
+  size_t n = 0;
+#define PUT(word) do { if (key != NULL) key[n] = (word); ++n; } while (0)
+
+  PUT (GLRO(dl_lazy) != 0);
+  PUT (bind_cache.nmaps);
+  for (uint32_t i = 0; i < bind_cache.nmaps; ++i)
+    {
+      const void *id;
+      uint32_t len;
+      if (!bind_cache_build_id (bind_cache.maps[i], &id, &len)
+	  || len > 1024)
+	return 0;
+      PUT (len);
+      if (key != NULL)
+	{
+	  /* Zero the padding.  */
+	  key[n + (len - 1) / 4] = 0;
+	  memcpy (&key[n], id, len);
+	}
+      n += (len + 3) / 4;
+    }
+
+  struct r_scope_elem *searchlist = &main_map->l_searchlist;
+  PUT (searchlist->r_nlist);
+  for (unsigned int i = 0; i < searchlist->r_nlist; ++i)
+    {
+      uint32_t idx = 0;
+      while (idx < bind_cache.nmaps
+	     && bind_cache.maps[idx] != searchlist->r_list[i])
+	++idx;
+      PUT (idx);
+    }
+#undef PUT
+  return n;
+}
+
+/* Map the cache file and check that it matches the current key.  */
+static bool
+bind_cache_open (void)
+{
+  int fd = __open64_nocancel (bind_cache.path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct __stat64_t64 st;
+  void *file = MAP_FAILED;
+  if (__fstat64_time64 (fd, &st) == 0
+      && S_ISREG (st.st_mode)
+      && st.st_size >= sizeof (struct bind_cache_header)
+      && st.st_size <= (sizeof (struct bind_cache_header)
+			+ bind_cache.key_size
+			+ (uint64_t) BIND_CACHE_MAX_SIZE
+			  * sizeof (struct bind_cache_entry)))
+    file = __mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  __close_nocancel (fd);
+  if (file == MAP_FAILED)
+    return false;
+
+  const struct bind_cache_header *header = file;
+  const uint32_t *key = (const uint32_t *) (header + 1);
+  size_t key_words = bind_cache.key_size / sizeof (uint32_t);
+  struct bind_cache_entry *table
+    = (struct bind_cache_entry *) (key + key_words);
+  if (memcmp (header->magic, BIND_CACHE_MAGIC, sizeof (header->magic)) != 0
+      || header->version != BIND_CACHE_VERSION
+      || header->key_size != bind_cache.key_size
+      || header->table_size == 0
+      || header->table_size > BIND_CACHE_MAX_SIZE
+      || (header->table_size & (header->table_size - 1)) != 0
+      || st.st_size != (sizeof (struct bind_cache_header)
+			+ bind_cache.key_size
+			+ (size_t) header->table_size
+			  * sizeof (struct bind_cache_entry))
+      || memcmp (key, bind_cache.key, bind_cache.key_size) != 0
+      || (bind_cache_checksum ((const uint32_t *) table,
+			       header->table_size
+			       * sizeof (struct bind_cache_entry)
+			       / sizeof (uint32_t),
+			       bind_cache_checksum (key, key_words,
+						    2166136261U))
+	  != header->checksum))
+    {
+      __munmap (file, st.st_size);
+      return false;
+    }
+
+  bind_cache.file = file;
+  bind_cache.file_size = st.st_size;
+  bind_cache.table = table;
+  bind_cache.table_size = header->table_size;
+  return true;
+}
+
+static struct bind_cache_entry *
+bind_cache_alloc_table (uint32_t size)
+{
+  void *table = __mmap (NULL, size * sizeof (struct bind_cache_entry),
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+			-1, 0);
+  return table == MAP_FAILED ? NULL : table;
+}
+
+void
+_dl_bind_cache_init (struct link_map *main_map)
+{
+  const struct tunable_str_t *path
+    = TUNABLE_GET (glibc, rtld, bind_cache, const struct tunable_str_t *,
+		   NULL);
+  if (path->str == NULL || path->len == 0
+      || __libc_enable_secure
+      || GLRO(dl_naudit) > 0
+      || GLRO(dl_dynamic_weak)
+      || (GLRO(dl_debug_mask)
+	  & (DL_DEBUG_BINDINGS | DL_DEBUG_SYMBOLS | DL_DEBUG_UNUSED)) != 0)
+    return;
+
+  uint32_t nmaps = 0;
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next)
+    ++nmaps;
+
+  bind_cache.path = malloc (path->len + 1);
+  bind_cache.maps = malloc (nmaps * sizeof (*bind_cache.maps));
+  if (bind_cache.path == NULL || bind_cache.maps == NULL)
+    return;
+  *(char *) __mempcpy (bind_cache.path, path->str, path->len) = '\0';
+  bind_cache.nmaps = 0;
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next)
+    bind_cache.maps[bind_cache.nmaps++] = l;
+
+  size_t key_words = bind_cache_make_key (main_map, NULL);
+  if (key_words == 0)
+    {
+      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	_dl_debug_printf ("binding cache=%s; not used: missing build ID\n",
+			  bind_cache.path);
+      return;
+    }
+  bind_cache.key = malloc (key_words * sizeof (uint32_t));
+  if (bind_cache.key == NULL)
+    return;
+  bind_cache_make_key (main_map, bind_cache.key);
+  bind_cache.key_size = key_words * sizeof (uint32_t);
+
+  if (bind_cache_open ())
+    {
+      bind_cache.nsyms = calloc (nmaps, sizeof (*bind_cache.nsyms));
+      if (bind_cache.nsyms == NULL)
+	{
+	  __munmap (bind_cache.file, bind_cache.file_size);
+	  return;
+	}
+      _dl_bind_cache_mode = dl_bind_cache_use;
+    }
+  else
+    {
+      bind_cache.table = bind_cache_alloc_table (BIND_CACHE_INITIAL_SIZE);
+      if (bind_cache.table == NULL)
+	return;
+      bind_cache.table_size = BIND_CACHE_INITIAL_SIZE;
+      bind_cache.used = 0;
+      _dl_bind_cache_mode = dl_bind_cache_record;
+    }
+
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+    _dl_debug_printf ("binding cache=%s; %s\n", bind_cache.path,
+		      _dl_bind_cache_mode == dl_bind_cache_use
+		      ? "using" : "recording");
+}
+
+/* Return the index of MAP in bind_cache.maps, or BIND_CACHE_NONE if it
+   is not an initial object.  */
+static uint32_t
+bind_cache_map_index (struct link_map *map)
+{
+  if (map == bind_cache.last_map)
+    return bind_cache.last_idx;
+  for (uint32_t i = 0; i < bind_cache.nmaps; ++i)
+    if (bind_cache.maps[i] == map)
+      {
+	bind_cache.last_map = map;
+	bind_cache.last_idx = i;
+	return i;
+      }
+  return BIND_CACHE_NONE;
+}
+
+/* Return the index of SYM in the symbol table of MAP, or
+   BIND_CACHE_NONE if it is not part of it.  */
+static uint32_t
+bind_cache_sym_index (struct link_map *map, const ElfW(Sym) *sym)
+{
+  const ElfW(Sym) *symtab = (const void *) D_PTR (map, l_info[DT_SYMTAB]);
+  if (sym < symtab || sym - symtab >= BIND_CACHE_NONE)
+    return BIND_CACHE_NONE;
+  return sym - symtab;
+}
+
+/* Return the number of symbols in the symbol table of MAP, the object
+   with index IDX, or zero if it cannot be determined.  The dynamic
+   section does not record it, but the hash table covers all symbols.  */
+static uint32_t
+bind_cache_nsyms (struct link_map *map, uint32_t idx)
+{
+  if (bind_cache.nsyms[idx] != 0)
+    return bind_cache.nsyms[idx];
+
+  uint32_t n = 0;
+  if (map->l_info[ELF_MACHINE_GNU_HASH_ADDRIDX] != NULL)
+    {
+      /* The symbols below the bias are not hashed.  The others are
+	 hashed in order, so the chain of the last nonempty bucket ends
+	 with the last symbol.  */
+      const Elf32_Word *hash32
+	= (const void *) D_PTR (map, l_info[ELF_MACHINE_GNU_HASH_ADDRIDX]);
+      Elf32_Word last = 0;
+      for (Elf32_Word i = 0; i < map->l_nbuckets; ++i)
+	if (map->l_gnu_buckets[i] > last)
+	  last = map->l_gnu_buckets[i];
+      if (last == 0)
+	n = hash32[1];
+      else
+	{
+	  while ((map->l_gnu_chain_zero[last] & 1) == 0)
+	    ++last;
+	  n = last + 1;
+	}
+    }
+  else if (map->l_info[DT_HASH] != NULL)
+    n = ((const Elf_Symndx *) D_PTR (map, l_info[DT_HASH]))[1];
+
+  bind_cache.nsyms[idx] = n;
+  return n;
+}
+
+bool
+_dl_bind_cache_lookup (const char *undef_name, struct link_map *undef_map,
+		       const ElfW(Sym) **ref, int type_class,
+		       struct link_map **def_map)
+{
+  uint32_t ref_map = bind_cache_map_index (undef_map);
+  uint32_t ref_symidx = bind_cache_sym_index (undef_map, *ref);
+  if (ref_map == BIND_CACHE_NONE || ref_symidx == BIND_CACHE_NONE)
+    return false;
+  ++ref_map;
+
+  uint32_t mask = bind_cache.table_size - 1;
+  uint32_t h = bind_cache_hash (ref_map, ref_symidx, type_class);
+  const struct bind_cache_entry *e;
+  for (uint32_t i = 0; ; ++i)
+    {
+      /* The probe count is bounded in case a file has a full table.  */
+      if (i == bind_cache.table_size)
+	return false;
+      e = &bind_cache.table[(h + i) & mask];
+      if (e->ref_map == 0)
+	return false;
+      if (e->ref_map == ref_map && e->ref_symidx == ref_symidx
+	  && e->type_class == type_class)
+	break;
+    }
+
+  if (e->def_map == BIND_CACHE_NONE)
+    {
+      /* Only weak references may remain unresolved.  */
+      if (ELFW(ST_BIND) ((*ref)->st_info) != STB_WEAK)
+	return false;
+      *ref = NULL;
+      *def_map = NULL;
+    }
+  else
+    {
+      if (e->def_map >= bind_cache.nmaps)
+	return false;
+      struct link_map *map = bind_cache.maps[e->def_map];
+      /* The entry was recorded for the same objects, but the file may
+	 have been damaged or replaced, so check that it refers to a
+	 symbol of the right name.  */
+      if (e->def_symidx >= bind_cache_nsyms (map, e->def_map))
+	return false;
+      const ElfW(Sym) *symtab
+	= (const void *) D_PTR (map, l_info[DT_SYMTAB]);
+      const char *strtab = (const void *) D_PTR (map, l_info[DT_STRTAB]);
+      const ElfW(Sym) *sym = &symtab[e->def_symidx];
+      if (map->l_info[DT_STRSZ] == NULL
+	  || sym->st_name >= map->l_info[DT_STRSZ]->d_un.d_val
+	  || strcmp (strtab + sym->st_name, undef_name) != 0)
+	return false;
+
+      if (__glibc_unlikely (map->l_used == 0))
+	map->l_used = 1;
+      *ref = sym;
+      *def_map = map;
+    }
+
+  ++_dl_bind_cache_hits;
+  return true;
+}
+
+static void
+bind_cache_insert (struct bind_cache_entry *table, uint32_t size,
+		   const struct bind_cache_entry *entry)
+{
+  uint32_t mask = size - 1;
+  for (uint32_t i = bind_cache_hash (entry->ref_map, entry->ref_symidx,
+				     entry->type_class);
+       ; ++i)
+    {
+      struct bind_cache_entry *e = &table[i & mask];
+      if (e->ref_map == 0)
+	{
+	  *e = *entry;
+	  ++bind_cache.used;
+	  return;
+	}
+      if (e->ref_map == entry->ref_map
+	  && e->ref_symidx == entry->ref_symidx
+	  && e->type_class == entry->type_class)
+	return;
+    }
+}
+
+/* Stop recording, and do not write a file.  */
+static void
+bind_cache_abandon (void)
+{
+  if (bind_cache.table != NULL)
+    __munmap (bind_cache.table,
+	      bind_cache.table_size * sizeof (struct bind_cache_entry));
+  bind_cache.table = NULL;
+  _dl_bind_cache_mode = dl_bind_cache_disabled;
+}
+
+void
+_dl_bind_cache_record (struct link_map *undef_map, const ElfW(Sym) *ref,
+		       int type_class, struct link_map *def_map,
+		       const ElfW(Sym) *def)
+{
+  struct bind_cache_entry entry =
+    {
+      .ref_map = bind_cache_map_index (undef_map),
+      .ref_symidx = bind_cache_sym_index (undef_map, ref),
+      .type_class = type_class,
+      .def_map = BIND_CACHE_NONE,
+      .def_symidx = 0,
+    };
+  if (def_map != NULL)
+    {
+      entry.def_map = bind_cache_map_index (def_map);
+      entry.def_symidx = bind_cache_sym_index (def_map, def);
+      if (entry.def_map == BIND_CACHE_NONE
+	  || entry.def_symidx == BIND_CACHE_NONE)
+	return;
+    }
+  if (entry.ref_map == BIND_CACHE_NONE || entry.ref_symidx == BIND_CACHE_NONE)
+    return;
+  ++entry.ref_map;
+
+  /* Keep the table at most half full.  */
+  if (2 * (bind_cache.used + 1) > bind_cache.table_size)
+    {
+      uint32_t old_size = bind_cache.table_size;
+      struct bind_cache_entry *old_table = bind_cache.table;
+      struct bind_cache_entry *table = NULL;
+      if (old_size < BIND_CACHE_MAX_SIZE)
+	table = bind_cache_alloc_table (2 * old_size);
+      if (table == NULL)
+	{
+	  bind_cache_abandon ();
+	  return;
+	}
+      bind_cache.used = 0;
+      for (uint32_t i = 0; i < old_size; ++i)
+	if (old_table[i].ref_map != 0)
+	  bind_cache_insert (table, 2 * old_size, &old_table[i]);
+      __munmap (old_table, old_size * sizeof (struct bind_cache_entry));
+      bind_cache.table = table;
+      bind_cache.table_size = 2 * old_size;
+    }
+
+  bind_cache_insert (bind_cache.table, bind_cache.table_size, &entry);
+}
+
+static bool
+bind_cache_write_all (int fd, const void *buffer, size_t length)
+{
+  const char *p = buffer;
+  while (length > 0)
+    {
+      ssize_t ret = __write_nocancel (fd, p, length);
+      if (ret < 0 && errno == EINTR)
+	continue;
+      if (ret <= 0)
+	return false;
+      p += ret;
+      length -= ret;
+    }
+  return true;
+}
+
+static void
+bind_cache_write (void)
+{
+  /* The temporary file name is the file name followed by a dot and the
+     process ID.  */
+  char tmp[PATH_MAX];
+  size_t path_len = strlen (bind_cache.path);
+  if (path_len > sizeof (tmp) - 12)
+    return;
+  tmp[sizeof (tmp) - 1] = '\0';
+  char *startp = _itoa (__getpid (), &tmp[sizeof (tmp) - 1], 10, 0);
+  *--startp = '.';
+  startp = memcpy (startp - path_len, bind_cache.path, path_len);
+
+  int fd = __open64_nocancel (startp,
+			      O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW
+			      | O_CLOEXEC, DEFFILEMODE);
+  if (fd < 0)
+    return;
+
+  size_t table_bytes
+    = bind_cache.table_size * sizeof (struct bind_cache_entry);
+  struct bind_cache_header header =
+    {
+      .magic = BIND_CACHE_MAGIC,
+      .version = BIND_CACHE_VERSION,
+      .key_size = bind_cache.key_size,
+      .table_size = bind_cache.table_size,
+      .checksum = bind_cache_checksum ((const uint32_t *) bind_cache.table,
+				       table_bytes / sizeof (uint32_t),
+				       bind_cache_checksum
+				       (bind_cache.key,
+					bind_cache.key_size
+					/ sizeof (uint32_t), 2166136261U)),
+    };
+  bool ok = (bind_cache_write_all (fd, &header, sizeof (header))
+	     && bind_cache_write_all (fd, bind_cache.key, bind_cache.key_size)
+	     && bind_cache_write_all (fd, bind_cache.table, table_bytes));
+  if (__close_nocancel (fd) != 0)
+    ok = false;
+  if (ok && __renameat (AT_FDCWD, startp, AT_FDCWD, bind_cache.path) == 0)
+    {
+      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	_dl_debug_printf ("binding cache=%s; written with %u entries\n",
+			  bind_cache.path, bind_cache.used);
+    }
+  else
+    __unlink (startp);
+}
+
+void
+_dl_bind_cache_finish (void)
+{
+  switch (_dl_bind_cache_mode)
+    {
+    case dl_bind_cache_disabled:
+      return;
+    case dl_bind_cache_use:
+      __munmap (bind_cache.file, bind_cache.file_size);
+      break;
+    case dl_bind_cache_record:
+      if (bind_cache.used > 0)
+	bind_cache_write ();
+      __munmap (bind_cache.table,
+		bind_cache.table_size * sizeof (struct bind_cache_entry));
+      break;
+    }
+  free (bind_cache.nsyms);
+  free (bind_cache.key);
+  free (bind_cache.maps);
+  free (bind_cache.path);
+  bind_cache.table = NULL;
+  _dl_bind_cache_mode = dl_bind_cache_disabled;
+}
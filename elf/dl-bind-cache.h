@@ -0,0 +1,82 @@
+/* Persistent symbol binding cache for the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_BIND_CACHE_H
+#define _DL_BIND_CACHE_H
+
+#include <ldsodefs.h>
+#include <stdbool.h>
+
+/* The binding cache stores the results of the symbol lookups performed
+   while relocating the initial objects, keyed by the build IDs and the
+   order of these objects (see glibc.rtld.bind_cache).  It is only
+   active between _dl_bind_cache_init and _dl_bind_cache_finish.  */
+
+enum dl_bind_cache_mode
+  {
+    /* The cache is not used.  */
+    dl_bind_cache_disabled,
+    /* Lookups are answered from a valid cache file.  */
+    dl_bind_cache_use,
+    /* There is no valid cache file, and lookup results are recorded to
+       write a new one.  */
+    dl_bind_cache_record,
+  };
+
+extern enum dl_bind_cache_mode _dl_bind_cache_mode attribute_hidden;
+
+/* Number of lookups answered from the cache, for LD_DEBUG=statistics.  */
+extern unsigned long int _dl_bind_cache_hits attribute_hidden;
+
+/* Activate the cache for the objects loaded in the base namespace at
+   startup, in which MAIN_MAP is the main program.  */
+void _dl_bind_cache_init (struct link_map *main_map) attribute_hidden;
+
+/* Write out the recorded lookups, if any, and deactivate the cache.  */
+void _dl_bind_cache_finish (void) attribute_hidden;
+
+/* Return true if a lookup with these arguments is a relocation lookup
+   of UNDEF_MAP in its own scope, which the cache can answer.  */
+static inline bool
+_dl_bind_cache_applies (struct link_map *undef_map,
+			struct r_scope_elem *symbol_scope[], int flags,
+			struct link_map *skip_map)
+{
+  return (flags == (DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_FOR_RELOCATE)
+	  && skip_map == NULL
+	  && undef_map != NULL
+	  && symbol_scope == undef_map->l_scope);
+}
+
+/* Look up the binding for the reference *REF from UNDEF_MAP named
+   UNDEF_NAME.  On success, return true and store the definition in *REF
+   and *DEF_MAP, both of which are NULL for an unresolved weak reference.
+   Return false if the binding is not in the cache.  */
+bool _dl_bind_cache_lookup (const char *undef_name,
+			    struct link_map *undef_map,
+			    const ElfW(Sym) **ref, int type_class,
+			    struct link_map **def_map) attribute_hidden;
+
+/* Record that the reference REF from UNDEF_MAP binds to DEF in DEF_MAP.
+   DEF and DEF_MAP are NULL if REF is an unresolved weak reference.  */
+void _dl_bind_cache_record (struct link_map *undef_map,
+			    const ElfW(Sym) *ref, int type_class,
+			    struct link_map *def_map,
+			    const ElfW(Sym) *def) attribute_hidden;
+
+#endif /* _DL_BIND_CACHE_H */
@@ -31,6 +31,10 @@ static struct cache_file *cache;
 static struct cache_file_new *cache_new;
 static size_t cachesize;
 
+/* The cache_extension_tag_name_hash section of CACHE_NEW, or NULL if
+   there is none.  */
+static const uint32_t *cache_name_hash;
+
 #ifdef SHARED
 /* This is used to cache the priorities of glibc-hwcaps
    subdirectories.  The elements of _dl_cache_priorities correspond to
@@ -186,22 +190,17 @@ _dl_cache_file_entry (const struct file_entry *libs, size_t entry_size,
   return (const void *) libs + index * entry_size;
 }
 
-/* We use binary search since the table is sorted in the cache file.
-   The first matching entry in the table is returned.  It is important
+/* Return the index of the first entry for NAME in LIBS, using binary
+   search since the table is sorted in the cache file.  It is important
    to use the same algorithm as used while generating the cache file.
-   STRING_TABLE_SIZE indicates the maximum offset in STRING_TABLE at
-   which data is mapped; it is not exact.  */
-static const char *
-search_cache (const char *string_table, uint32_t string_table_size,
-	      struct file_entry *libs, uint32_t nlibs, uint32_t entry_size,
-	      const char *name)
+   Return -1 if there is no such entry.  */
+static int
+search_cache_sorted (const char *string_table, uint32_t string_table_size,
+		     const struct file_entry *libs, uint32_t nlibs,
+		     uint32_t entry_size, const char *name)
 {
   int left = 0;
   int right = nlibs - 1;
-  const char *best = NULL;
-#ifdef SHARED
-  uint32_t best_priority = 0;
-#endif
 
   while (left <= right)
     {
@@ -211,16 +210,12 @@ search_cache (const char *string_table, uint32_t string_table_size,
       /* Make sure string table indices are not bogus before using
 	 them.  */
       if (!_dl_cache_verify_ptr (key, string_table_size))
-	return NULL;
+	return -1;
 
       /* Actually compare the entry with the key.  */
       int cmpres = _dl_cache_libcmp (name, string_table + key);
       if (__glibc_unlikely (cmpres == 0))
 	{
-	  /* Found it.  LEFT now marks the last entry for which we
-	     know the name is correct.  */
-	  left = middle;
-
 	  /* There might be entries with this name before the one we
 	     found.  So we have to find the beginning.  */
 	  while (middle > 0)
@@ -234,103 +229,163 @@ search_cache (const char *string_table, uint32_t string_table_size,
 		break;
 	      --middle;
 	    }
+	  return middle;
+	}
 
-	  do
-	    {
-	      int flags;
-	      const struct file_entry *lib
-		= _dl_cache_file_entry (libs, entry_size, middle);
-
-	      /* Only perform the name test if necessary.  */
-	      if (middle > left
-		  /* We haven't seen this string so far.  Test whether the
-		     index is ok and whether the name matches.  Otherwise
-		     we are done.  */
-		  && (! _dl_cache_verify_ptr (lib->key, string_table_size)
-		      || (_dl_cache_libcmp (name, string_table + lib->key)
-			  != 0)))
-		break;
+      if (cmpres < 0)
+	left = middle + 1;
+      else
+	right = middle - 1;
+    }
 
-	      flags = lib->flags;
-	      if (_dl_cache_check_flags (flags)
-		  && _dl_cache_verify_ptr (lib->value, string_table_size))
-		{
-		  /* Named/extension hwcaps get slightly different
-		     treatment: We keep searching for a better
-		     match.  */
-		  bool named_hwcap = false;
-
-		  if (entry_size >= sizeof (struct file_entry_new))
-		    {
-		      /* The entry is large enough to include
-			 HWCAP data.  Check it.  */
-		      struct file_entry_new *libnew
-			= (struct file_entry_new *) lib;
+  return -1;
+}
+
+/* Return the index of the first entry for NAME in LIBS, using the
+   cache_extension_tag_name_hash section HASH_TABLE, or -1 if there is
+   no such entry.  */
+static int
+search_cache_hashed (const char *string_table, uint32_t string_table_size,
+		     const struct file_entry *libs, uint32_t nlibs,
+		     uint32_t entry_size, const uint32_t *hash_table,
+		     const char *name)
+{
+  uint32_t mask = hash_table[0] - 1;
+  const uint32_t *slots = hash_table + 1;
+  uint32_t hash = _dl_cache_name_hash (name);
+
+  /* The table contains an empty slot, but a corrupted file need not.  */
+  for (uint32_t i = hash & mask, probes = 0; probes <= mask;
+       i = (i + 1) & mask, ++probes)
+    {
+      uint32_t index = slots[2 * i + 1];
+      if (index == UINT32_MAX)
+	break;
+      if (slots[2 * i] != hash || index >= nlibs)
+	continue;
+      uint32_t key = _dl_cache_file_entry (libs, entry_size, index)->key;
+      if (_dl_cache_verify_ptr (key, string_table_size)
+	  && _dl_cache_libcmp (name, string_table + key) == 0)
+	return index;
+    }
+  return -1;
+}
+
+/* Return the best match for NAME among the entries LIBS.  HASH_TABLE
+   is the cache_extension_tag_name_hash section for LIBS, or NULL.
+   STRING_TABLE_SIZE indicates the maximum offset in STRING_TABLE at
+   which data is mapped; it is not exact.  */
+static const char *
+search_cache (const char *string_table, uint32_t string_table_size,
+	      struct file_entry *libs, uint32_t nlibs, uint32_t entry_size,
+	      const uint32_t *hash_table, const char *name)
+{
+  const char *best = NULL;
+#ifdef SHARED
+  uint32_t best_priority = 0;
+#endif
+
+  int left;
+  if (hash_table != NULL)
+    left = search_cache_hashed (string_table, string_table_size, libs,
+				nlibs, entry_size, hash_table, name);
+  else
+    left = search_cache_sorted (string_table, string_table_size, libs,
+				nlibs, entry_size, name);
+  if (left < 0)
+    return NULL;
+
+  /* LEFT marks the first entry for which we know the name is correct.
+     Go through all entries with this name.  */
+  int middle = left;
+  do
+    {
+      int flags;
+      const struct file_entry *lib
+	= _dl_cache_file_entry (libs, entry_size, middle);
+
+      /* Only perform the name test if necessary.  */
+      if (middle > left
+	  /* We haven't seen this string so far.  Test whether the
+	     index is ok and whether the name matches.  Otherwise
+	     we are done.  */
+	  && (! _dl_cache_verify_ptr (lib->key, string_table_size)
+	      || (_dl_cache_libcmp (name, string_table + lib->key)
+		  != 0)))
+	break;
+
+      flags = lib->flags;
+      if (_dl_cache_check_flags (flags)
+	  && _dl_cache_verify_ptr (lib->value, string_table_size))
+	{
+	  /* Named/extension hwcaps get slightly different
+	     treatment: We keep searching for a better
+	     match.  */
+	  bool named_hwcap = false;
+
+	  if (entry_size >= sizeof (struct file_entry_new))
+	    {
+	      /* The entry is large enough to include
+		 HWCAP data.  Check it.  */
+	      struct file_entry_new *libnew
+		= (struct file_entry_new *) lib;
 
 #ifdef SHARED
-		      named_hwcap = dl_cache_hwcap_extension (libnew);
-		      if (named_hwcap
-			  && !dl_cache_hwcap_isa_level_compatible (libnew))
-			continue;
+	      named_hwcap = dl_cache_hwcap_extension (libnew);
+	      if (named_hwcap
+		  && !dl_cache_hwcap_isa_level_compatible (libnew))
+		continue;
 #endif
 
-		      /* The entries with named/extension hwcaps have
-			 been exhausted (they are listed before all
-			 other entries).  Return the best match
-			 encountered so far if there is one.  */
-		      if (!named_hwcap && best != NULL)
-			break;
+	      /* The entries with named/extension hwcaps have
+		 been exhausted (they are listed before all
+		 other entries).  Return the best match
+		 encountered so far if there is one.  */
+	      if (!named_hwcap && best != NULL)
+		break;
 
-		      /* Skip entries with the legacy hwcap/platform mechanism
-			 which was removed with glibc 2.37.  */
-		      if (!named_hwcap && libnew->hwcap != 0)
-			continue;
+	      /* Skip entries with the legacy hwcap/platform mechanism
+		 which was removed with glibc 2.37.  */
+	      if (!named_hwcap && libnew->hwcap != 0)
+		continue;
 
 #ifdef SHARED
-		      /* For named hwcaps, determine the priority and
-			 see if beats what has been found so far.  */
-		      if (named_hwcap)
-			{
-			  uint32_t entry_priority
-			    = glibc_hwcaps_priority (libnew->hwcap);
-			  if (entry_priority == 0)
-			    /* Not usable at all.  Skip.  */
-			    continue;
-			  else if (best == NULL
-				   || entry_priority < best_priority)
-			    /* This entry is of higher priority
-			       than the previous one, or it is the
-			       first entry.  */
-			    best_priority = entry_priority;
-			  else
-			    /* An entry has already been found,
-			       but it is a better match.  */
-			    continue;
-			}
-#endif /* SHARED */
-		    }
-
-		  best = string_table + lib->value;
-
-		  if (!named_hwcap && flags == _DL_CACHE_DEFAULT_ID)
-		    /* With named hwcaps, we need to keep searching to
-		       see if we find a better match.  A better match
-		       is also possible if the flags of the current
-		       entry do not match the expected cache flags.
-		       But if the flags match, no better entry will be
-		       found.  */
-		    break;
+	      /* For named hwcaps, determine the priority and
+		 see if beats what has been found so far.  */
+	      if (named_hwcap)
+		{
+		  uint32_t entry_priority
+		    = glibc_hwcaps_priority (libnew->hwcap);
+		  if (entry_priority == 0)
+		    /* Not usable at all.  Skip.  */
+		    continue;
+		  else if (best == NULL
+			   || entry_priority < best_priority)
+		    /* This entry is of higher priority
+		       than the previous one, or it is the
+		       first entry.  */
+		    best_priority = entry_priority;
+		  else
+		    /* An entry has already been found,
+		       but it is a better match.  */
+		    continue;
 		}
+#endif /* SHARED */
 	    }
-	  while (++middle <= right);
-	  break;
-	}
 
-      if (cmpres < 0)
-	left = middle + 1;
-      else
-	right = middle - 1;
+	  best = string_table + lib->value;
+
+	  if (!named_hwcap && flags == _DL_CACHE_DEFAULT_ID)
+	    /* With named hwcaps, we need to keep searching to
+	       see if we find a better match.  A better match
+	       is also possible if the flags of the current
+	       entry do not match the expected cache flags.
+	       But if the flags match, no better entry will be
+	       found.  */
+	    break;
+	}
     }
+  while (++middle < (int) nlibs);
 
   return best;
 }
@@ -455,6 +510,14 @@ _dl_load_cache_lookup (const char *name)
 	}
 
       assert (cache != NULL);
+
+      cache_name_hash = NULL;
+      if (cache != (void *) -1 && cache_new != (void *) -1)
+	{
+	  struct cache_extension_all_loaded ext;
+	  if (cache_extension_load (cache_new, cache, cachesize, &ext))
+	    cache_name_hash = ext.sections[cache_extension_tag_name_hash].base;
+	}
     }
 
   if (cache == (void *) -1)
@@ -467,7 +530,7 @@ _dl_load_cache_lookup (const char *name)
       const char *string_table = (const char *) cache_new;
       best = search_cache (string_table, cachesize,
 			   &cache_new->libs[0].entry, cache_new->nlibs,
-			   sizeof (cache_new->libs[0]), name);
+			   sizeof (cache_new->libs[0]), cache_name_hash, name);
     }
   else
     {
@@ -476,7 +539,7 @@ _dl_load_cache_lookup (const char *name)
 	= (const char *) cache + cachesize - string_table;
       best = search_cache (string_table, string_table_size,
 			   &cache->libs[0], cache->nlibs,
-			   sizeof (cache->libs[0]), name);
+			   sizeof (cache->libs[0]), NULL, name);
     }
 
   /* Print our result if wanted.  */
@@ -510,6 +573,7 @@ _dl_unload_cache (void)
     {
       __munmap (cache, cachesize);
       cache = NULL;
+      cache_name_hash = NULL;
     }
 #ifdef SHARED
   /* This marks the glibc_hwcaps_priorities array as out-of-date.  */
@@ -0,0 +1,113 @@
+/* Transparent huge pages for executable segments.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dl-hugepage-text.h>
+#include <dl-tunables.h>
+#include <libc-pointer-arith.h>
+#include <malloc-hugepages.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+
+/* The huge page size used for text, or 0 if huge pages are not used.
+   This is computed on first use, which happens with the loader lock
+   held or during startup.  */
+static size_t hugepage_text_size;
+static bool hugepage_text_initialized;
+
+static size_t
+hugepage_text_pagesize (void)
+{
+  if (!hugepage_text_initialized)
+    {
+      hugepage_text_initialized = true;
+#ifdef MADV_HUGEPAGE
+      if (TUNABLE_GET (glibc, rtld, hugepage_text, int32_t, NULL) != 0)
+	{
+	  enum malloc_thp_mode_t mode = __malloc_thp_mode ();
+	  size_t size = __malloc_default_thp_pagesize ();
+	  if ((mode == malloc_thp_mode_always
+	       || mode == malloc_thp_mode_madvise)
+	      && size > GLRO(dl_pagesize) && powerof2 (size))
+	    hugepage_text_size = size;
+	}
+#endif
+    }
+  return hugepage_text_size;
+}
+
+/* Compute the range of the executable load segment PH of an object
+   loaded at BASE which can be backed by huge pages of SIZE bytes.
+   Page cache huge pages for a file mapping require the address and the
+   file offset to be congruent modulo SIZE.  Only the part backed by the
+   file is considered.  */
+static bool
+hugepage_text_range (const ElfW(Phdr) *ph, ElfW(Addr) base, size_t size,
+		     ElfW(Addr) *start, ElfW(Addr) *end)
+{
+  if (ph->p_type != PT_LOAD || (ph->p_flags & PF_X) == 0
+      || (base + ph->p_vaddr - ph->p_offset) % size != 0)
+    return false;
+  *start = ALIGN_UP (base + ph->p_vaddr, size);
+  *end = ALIGN_DOWN (base + ph->p_vaddr + ph->p_filesz, size);
+  return *end > *start;
+}
+
+ElfW(Addr)
+_dl_hugepage_text_align (const ElfW(Phdr) *phdr, size_t phnum)
+{
+  size_t size = hugepage_text_pagesize ();
+  if (size == 0)
+    return 0;
+
+  /* The load address is a multiple of the alignment, so the segments
+     qualify if they do at address 0.  */
+  for (const ElfW(Phdr) *ph = phdr; ph < &phdr[phnum]; ++ph)
+    {
+      ElfW(Addr) start, end;
+      if (hugepage_text_range (ph, 0, size, &start, &end))
+	return size;
+    }
+  return 0;
+}
+
+void
+_dl_hugepage_text_advise (struct link_map *l)
+{
+#ifdef MADV_HUGEPAGE
+  size_t size = hugepage_text_pagesize ();
+  if (size == 0)
+    return;
+
+  for (const ElfW(Phdr) *ph = l->l_phdr; ph < &l->l_phdr[l->l_phnum]; ++ph)
+    {
+      ElfW(Addr) start, end;
+      if (!hugepage_text_range (ph, l->l_addr, size, &start, &end))
+	continue;
+      if (__madvise ((void *) start, end - start, MADV_HUGEPAGE) == 0
+	  && __glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	_dl_debug_printf ("\
+  huge page text: 0x%0*lx-0x%0*lx  file=%s\n",
+			  (int) sizeof (void *) * 2,
+			  (unsigned long int) start,
+			  (int) sizeof (void *) * 2,
+			  (unsigned long int) end,
+			  DSO_FILENAME (l->l_name));
+    }
+#endif
+}
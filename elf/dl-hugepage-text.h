@@ -0,0 +1,39 @@
+/* Transparent huge pages for executable segments.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_HUGEPAGE_TEXT_H
+#define _DL_HUGEPAGE_TEXT_H
+
+#include <ldsodefs.h>
+
+/* With glibc.rtld.hugepage_text, executable segments which span at
+   least one transparent huge page are mapped at an address where the
+   kernel can back them with huge pages, and advised accordingly.  */
+
+/* Return the alignment required for the mapping of an object with the
+   PHNUM program headers PHDR so that its executable segments can use
+   huge pages, or 0 if there is no such segment or huge pages for text
+   are not enabled.  */
+ElfW(Addr) _dl_hugepage_text_align (const ElfW(Phdr) *phdr, size_t phnum)
+     attribute_hidden;
+
+/* Request huge pages for the executable segments of the mapped object
+   L.  */
+void _dl_hugepage_text_advise (struct link_map *l) attribute_hidden;
+
+#endif /* _DL_HUGEPAGE_TEXT_H */
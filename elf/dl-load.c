@@ -74,6 +74,7 @@ struct filebuf
 #include <dl-unmap-segments.h>
 #include <dl-machine-reject-phdr.h>
 #include <dl-prop.h>
+#include <dl-hugepage-text.h>
 #include <not-cancel.h>
 
 #include <endian.h>
@@ -1229,6 +1230,17 @@ _dl_map_object_from_fd (const char *name, const char *origname, int fd,
     for (size_t i = 0; i < nloadcmds; i++)
       loadcmds[i].mapalign = p_align_max;
 
+    /* Place large executable segments where they can be backed by huge
+       pages (see glibc.rtld.hugepage_text).  */
+    if (type == ET_DYN)
+      {
+	ElfW(Addr) hugepage_align = _dl_hugepage_text_align (phdr,
+							     l->l_phnum);
+	if (hugepage_align > p_align_max)
+	  for (size_t i = 0; i < nloadcmds; i++)
+	    loadcmds[i].mapalign = hugepage_align;
+      }
+
     /* dlopen of an executable is not valid because it is not possible
        to perform proper relocations, handle static TLS, or run the
        ELF constructors.  For PIE, the check needs the dynamic
@@ -1363,6 +1375,8 @@ cannot enable executable stack as shared object requires");
 
   l->l_entry += l->l_addr;
 
+  _dl_hugepage_text_advise (l);
+
   if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
     _dl_debug_printf ("\
   dynamic: 0x%0*lx  base: 0x%0*lx   size: 0x%0*zx\n\
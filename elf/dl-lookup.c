@@ -30,6 +30,10 @@
 #include <tls.h>
 #include <atomic.h>
 #include <elf_machine_sym_no_match.h>
+#ifdef SHARED
+# include <dl-bind-cache.h>
+# include <dl-reloc-parallel.h>
+#endif
 
 #include <assert.h>
 
@@ -49,6 +53,29 @@ struct sym_val
 # define bump_num_relocations() ((void) 0)
 #endif
 
+/* The unique symbol table lock is not functional during the initial
+   relocation, which may happen in parallel.  */
+#ifdef SHARED
+# define unique_sym_table_lock(tab)					      \
+  do									      \
+    {									      \
+      __rtld_lock_lock_recursive ((tab)->lock);				      \
+      _dl_relocate_parallel_enter ();					      \
+    }									      \
+  while (0)
+# define unique_sym_table_unlock(tab)					      \
+  do									      \
+    {									      \
+      _dl_relocate_parallel_leave ();					      \
+      __rtld_lock_unlock_recursive ((tab)->lock);			      \
+    }									      \
+  while (0)
+#else
+# define unique_sym_table_lock(tab) __rtld_lock_lock_recursive ((tab)->lock)
+# define unique_sym_table_unlock(tab) \
+  __rtld_lock_unlock_recursive ((tab)->lock)
+#endif
+
 /* Utility function for do_lookup_x. The caller is called with undef_name,
    ref, version, flags and type_class, and those are passed as the first
    five arguments. The caller then computes sym, symidx, strtab, and map
@@ -218,7 +245,7 @@ do_lookup_unique (const char *undef_name, unsigned int new_hash,
   struct unique_sym_table *tab
     = &GL(dl_ns)[map->l_ns]._ns_unique_sym_table;
 
-  __rtld_lock_lock_recursive (tab->lock);
+  unique_sym_table_lock (tab);
 
   struct unique_sym *entries = tab->entries;
   size_t size = tab->size;
@@ -244,7 +271,7 @@ do_lookup_unique (const char *undef_name, unsigned int new_hash,
 		  result->s = entries[idx].sym;
 		  result->m = (struct link_map *) entries[idx].map;
 		}
-	      __rtld_lock_unlock_recursive (tab->lock);
+	      unique_sym_table_unlock (tab);
 	      return;
 	    }
 
@@ -269,7 +296,7 @@ do_lookup_unique (const char *undef_name, unsigned int new_hash,
 	  if (newentries == NULL)
 	    {
 	    nomem:
-	      __rtld_lock_unlock_recursive (tab->lock);
+	      unique_sym_table_unlock (tab);
 	      _dl_fatal_printf ("out of memory\n");
 	    }
 
@@ -325,7 +352,7 @@ marking %s [%lu] as NODELETE due to unique symbol\n",
     }
   ++tab->n_elements;
 
-  __rtld_lock_unlock_recursive (tab->lock);
+  unique_sym_table_unlock (tab);
 
   result->s = sym;
   result->m = (struct link_map *) map;
@@ -776,6 +803,21 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
      lookups.  */
   assert (version == NULL || !(flags & DL_LOOKUP_RETURN_NEWEST));
 
+#ifdef SHARED
+  /* During the initial relocation, the binding may have been recorded in
+     the cache by an earlier run of the same set of objects.  */
+  bool record = false;
+  if (__glibc_unlikely (_dl_bind_cache_mode != dl_bind_cache_disabled)
+      && _dl_bind_cache_applies (undef_map, symbol_scope, flags, skip_map))
+    {
+      if (_dl_bind_cache_mode == dl_bind_cache_record)
+	record = true;
+      else if (_dl_bind_cache_lookup (undef_name, undef_map, ref,
+				      type_class, &current_value.m))
+	return LOOKUP_VALUE (current_value.m);
+    }
+#endif
+
   size_t i = 0;
   if (__glibc_unlikely (skip_map != NULL))
     /* Search the relevant loaded objects for a definition.  */
@@ -808,6 +850,10 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
 	  _dl_signal_cexception (0, &exception, N_("symbol lookup error"));
 	  _dl_exception_free (&exception);
 	}
+#ifdef SHARED
+      else if (__glibc_unlikely (record) && *ref != NULL)
+	_dl_bind_cache_record (undef_map, *ref, type_class, NULL, NULL);
+#endif
       *ref = NULL;
       return NULL;
     }
@@ -844,6 +890,18 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
 	}
     }
 
+#ifdef SHARED
+  /* Unique symbols must go through the unique symbol table, and the
+     special handling of protected symbols is not repeated for cached
+     bindings, so these are not recorded.  */
+  if (__glibc_unlikely (record)
+      && protected == 0
+      && ELFW(ST_BIND) (current_value.s->st_info) != STB_GNU_UNIQUE
+      && ELFW(ST_VISIBILITY) (current_value.s->st_other) != STV_PROTECTED)
+    _dl_bind_cache_record (undef_map, *ref, type_class, current_value.m,
+			   current_value.s);
+#endif
+
   /* We have to check whether this would bind UNDEF_MAP to an object
      in the global scope which was dynamically loaded.  In this case
      we have to prevent the latter from being unloaded unless the
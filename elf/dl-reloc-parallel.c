@@ -0,0 +1,29 @@
+/* Parallel relocation of the initial objects.  Generic version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dl-reloc-parallel.h>
+
+bool _dl_relocate_parallel_active;
+int _dl_relocate_parallel_lock;
+
+/* Helper threads cannot be created before libc is initialized, and all
+   objects are relocated serially by the caller.  */
+void
+_dl_relocate_parallel (struct link_map *main_map, int reloc_mode)
+{
+}
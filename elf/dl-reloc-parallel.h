@@ -0,0 +1,56 @@
+/* Parallel relocation of the initial objects.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_RELOC_PARALLEL_H
+#define _DL_RELOC_PARALLEL_H
+
+#include <ldsodefs.h>
+#include <lowlevellock.h>
+#include <stdbool.h>
+
+/* Relocate the objects loaded at startup, except for the main program,
+   using helper threads if glibc.rtld.relocation_threads is set.  Each
+   object is only relocated after its dependencies.  RELOC_MODE is
+   passed to _dl_relocate_object.  Objects which are not relocated by
+   this function (all of them if it does nothing) are left to the
+   caller.  */
+void _dl_relocate_parallel (struct link_map *main_map, int reloc_mode)
+  attribute_hidden;
+
+/* True while helper threads are relocating objects.  The rtld locks are
+   not functional at this point, and the state they protect which is
+   modified during relocation must use _dl_relocate_parallel_lock
+   instead.  */
+extern bool _dl_relocate_parallel_active attribute_hidden;
+extern int _dl_relocate_parallel_lock attribute_hidden;
+
+static inline void
+_dl_relocate_parallel_enter (void)
+{
+  if (__glibc_unlikely (_dl_relocate_parallel_active))
+    lll_lock (_dl_relocate_parallel_lock, LLL_PRIVATE);
+}
+
+static inline void
+_dl_relocate_parallel_leave (void)
+{
+  if (__glibc_unlikely (_dl_relocate_parallel_active))
+    lll_unlock (_dl_relocate_parallel_lock, LLL_PRIVATE);
+}
+
+#endif /* _DL_RELOC_PARALLEL_H */
@@ -172,7 +172,7 @@ int _dl_stack_prot_flags = DEFAULT_STACK_PROT_PERMS;
 #if !defined (__PTHREAD_HTL)
 list_t _dl_stack_used;
 list_t _dl_stack_user;
-list_t _dl_stack_cache;
+list_t _dl_stack_cache[DL_STACK_CACHE_CLASSES];
 size_t _dl_stack_cache_actsize;
 uintptr_t _dl_in_flight_stack;
 int _dl_stack_cache_lock;
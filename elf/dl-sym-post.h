@@ -17,11 +17,20 @@
    <https://www.gnu.org/licenses/>.  */
 
 
-/* Return the link map containing the caller address.  */
+/* Return the link map containing the caller address.  The caller does
+   not hold GL(dl_load_lock), so the lists of loaded objects may change
+   concurrently.  _dl_find_object does not need a lock, but it is not
+   initialized before the initial relocation is complete.  */
 static struct link_map *
 _dl_sym_find_caller_link_map (ElfW(Addr) caller)
 {
+  struct dl_find_object dlfo;
+  if (_dl_find_object ((void *) caller, &dlfo) == 0)
+    return dlfo.dlfo_link_map;
+
+  __rtld_lock_lock_recursive (GL(dl_load_write_lock));
   struct link_map *l = _dl_find_dso_for_object (caller);
+  __rtld_lock_unlock_recursive (GL(dl_load_write_lock));
   if (l != NULL)
     return l;
   else
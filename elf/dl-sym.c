@@ -64,8 +64,10 @@ struct call_dl_lookup_args
   /* Arguments to do_dlsym.  */
   struct link_map *map;
   const char *name;
+  struct r_scope_elem **scope;
   struct r_found_version *vers;
   int flags;
+  struct link_map *skip_map;
 
   /* Return values of do_dlsym.  */
   lookup_t loadbase;
@@ -77,8 +79,43 @@ call_dl_lookup (void *ptr)
 {
   struct call_dl_lookup_args *args = (struct call_dl_lookup_args *) ptr;
   args->map = GLRO(dl_lookup_symbol_x) (args->name, args->map, args->refp,
-					args->map->l_scope, args->vers, 0,
-					args->flags, NULL);
+					args->scope, args->vers, 0,
+					args->flags, args->skip_map);
+}
+
+/* Look up NAME in SCOPE on behalf of MAP.  dlsym does not acquire
+   GL(dl_load_lock) for lookups through a handle, so objects can be
+   removed from the scope by a concurrent dlclose.  As for lazy
+   binding, the global scope flag of the current thread delays the
+   deallocation of old scope arrays and unloaded objects until the
+   lookup is complete.  */
+static lookup_t
+dl_sym_lookup (const char *name, struct link_map *map,
+	       const ElfW(Sym) **ref, struct r_scope_elem *scope[],
+	       struct r_found_version *vers, int flags,
+	       struct link_map *skip_map)
+{
+  if (RTLD_SINGLE_THREAD_P)
+    return GLRO(dl_lookup_symbol_x) (name, map, ref, scope, vers, 0, flags,
+				     skip_map);
+
+  struct call_dl_lookup_args args;
+  args.name = name;
+  args.map = map;
+  args.scope = scope;
+  args.vers = vers;
+  args.flags = flags | DL_LOOKUP_GSCOPE_LOCK;
+  args.skip_map = skip_map;
+  args.refp = ref;
+
+  THREAD_GSCOPE_SET_FLAG ();
+  struct dl_exception exception;
+  int err = _dl_catch_exception (&exception, call_dl_lookup, &args);
+  THREAD_GSCOPE_RESET_FLAG ();
+  if (__glibc_unlikely (exception.errstring != NULL))
+    _dl_signal_exception (err, &exception, NULL);
+
+  return args.map;
 }
 
 static void *
@@ -101,30 +138,8 @@ do_sym (void *handle, const char *name, void *who,
 	 the initial binary.  And then the more complex part
 	 where the object is dynamically loaded and the scope
 	 array can change.  */
-      if (RTLD_SINGLE_THREAD_P)
-	result = GLRO(dl_lookup_symbol_x) (name, match, &ref,
-					   match->l_scope, vers, 0,
-					   flags | DL_LOOKUP_ADD_DEPENDENCY,
-					   NULL);
-      else
-	{
-	  struct call_dl_lookup_args args;
-	  args.name = name;
-	  args.map = match;
-	  args.vers = vers;
-	  args.flags
-	    = flags | DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_GSCOPE_LOCK;
-	  args.refp = &ref;
-
-	  THREAD_GSCOPE_SET_FLAG ();
-	  struct dl_exception exception;
-	  int err = _dl_catch_exception (&exception, call_dl_lookup, &args);
-	  THREAD_GSCOPE_RESET_FLAG ();
-	  if (__glibc_unlikely (exception.errstring != NULL))
-	    _dl_signal_exception (err, &exception, NULL);
-
-	  result = args.map;
-	}
+      result = dl_sym_lookup (name, match, &ref, match->l_scope, vers,
+			      flags | DL_LOOKUP_ADD_DEPENDENCY, NULL);
     }
   else if (handle == RTLD_NEXT)
     {
@@ -143,15 +158,15 @@ RTLD_NEXT used in code not dynamically loaded"));
       while (l->l_loader != NULL)
 	l = l->l_loader;
 
-      result = GLRO(dl_lookup_symbol_x) (name, match, &ref, l->l_local_scope,
-					 vers, 0, flags, match);
+      result = dl_sym_lookup (name, match, &ref, l->l_local_scope, vers,
+			      flags, match);
     }
   else
     {
       /* Search the scope of the given object.  */
       struct link_map *map = handle;
-      result = GLRO(dl_lookup_symbol_x) (name, map, &ref, map->l_local_scope,
-					 vers, 0, flags, NULL);
+      result = dl_sym_lookup (name, map, &ref, map->l_local_scope, vers,
+			      flags, NULL);
     }
 
   if (ref != NULL)
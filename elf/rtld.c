@@ -52,6 +52,9 @@
 #include <dl-find_object.h>
 #include <dl-audit-check.h>
 #include <dl-call_tls_init_tp.h>
+#include <dl-bind-cache.h>
+#include <dl-hugepage-text.h>
+#include <dl-reloc-parallel.h>
 
 #include <assert.h>
 
@@ -1712,6 +1715,10 @@ dl_main (const ElfW(Phdr) *phdr,
 
       /* Set up our cache of pointers into the hash table.  */
       _dl_setup_hash (main_map);
+
+      /* The kernel has mapped the main program, so huge pages can only
+	 be requested for text which happens to be suitably placed.  */
+      _dl_hugepage_text_advise (main_map);
     }
 
   if (__glibc_unlikely (state.mode == rtld_mode_verify))
@@ -2249,6 +2256,10 @@ dl_main (const ElfW(Phdr) *phdr,
   /* If we are profiling we also must do lazy reloaction.  */
   GLRO(dl_lazy) |= consider_profiling;
 
+  /* Answer the relocation lookups from the binding cache, or record them,
+     if glibc.rtld.bind_cache is set.  */
+  _dl_bind_cache_init (main_map);
+
   /* If libc.so has been loaded, relocate it early, after the dynamic
      loader itself.  The initial self-relocation of ld.so should be
      sufficient for IFUNC resolvers in libc.so.  */
@@ -2264,6 +2275,12 @@ dl_main (const ElfW(Phdr) *phdr,
 
   RTLD_TIMING_VAR (start);
   rtld_timer_start (&start);
+
+  /* Relocate the other objects in parallel if glibc.rtld.relocation_threads
+     is set.  The loop below skips the objects which have been relocated,
+     and relocates the main program last.  */
+  _dl_relocate_parallel (main_map, GLRO(dl_lazy) ? RTLD_LAZY : 0);
+
   {
     unsigned i = main_map->l_searchlist.r_nlist;
     while (i-- > 0)
@@ -2293,6 +2310,8 @@ dl_main (const ElfW(Phdr) *phdr,
   }
   rtld_timer_stop (&relocate_time, start);
 
+  _dl_bind_cache_finish ();
+
   /* This call must come after the slotinfo array has been filled in
      using _dl_add_to_slotinfo.  */
   _dl_tls_initial_modid_limit_setup ();
@@ -2832,6 +2851,9 @@ print_statistics (const hp_timing_t *rtld_total_timep)
 		    GL(dl_num_relocations),
 		    GL(dl_num_cache_relocations),
 		    num_relative_relocations);
+  if (_dl_bind_cache_hits != 0)
+    _dl_debug_printf ("        relocations from binding cache: %lu\n",
+		      _dl_bind_cache_hits);
 
 #if HP_TIMING_INLINE
   print_statistics_item ("           time needed to load objects",
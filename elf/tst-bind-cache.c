@@ -0,0 +1,133 @@
+/* Test the symbol binding cache (glibc.rtld.bind_cache).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern int bind_cache_value (void);
+
+static int restart;
+#define CMDLINE_OPTIONS \
+  { "restart", no_argument, &restart, 1 },
+
+static char **spargv;
+
+/* Run the test in a subprocess with the environment variables ENV1 and
+   ENV2, and return its standard error output, which contains the
+   LD_DEBUG messages.  */
+static char *
+run (const char *env1, const char *env2)
+{
+  char *envp[] = { (char *) env1, (char *) env2, NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (spargv[0], spargv, envp);
+  support_capture_subprocess_check (&result, "tst-bind-cache", 0,
+				    sc_allow_stdout | sc_allow_stderr);
+  char *err = xstrdup (result.err.buffer != NULL ? result.err.buffer : "");
+  support_capture_subprocess_free (&result);
+  return err;
+}
+
+static void
+check_contains (const char *output, const char *string, bool expected)
+{
+  if ((strstr (output, string) != NULL) != expected)
+    {
+      printf ("info: output:\n%s", output);
+      FAIL ("\"%s\" %s in output", string,
+	    expected ? "not found" : "found");
+    }
+}
+
+static int
+do_test (int argc, char *argv[])
+{
+  /* The cached bindings must be the same as the looked up ones.  */
+  TEST_COMPARE (bind_cache_value (), 42);
+  if (restart)
+    return 0;
+
+  /* One or four parameters left if called initially:
+       + path to ld.so         optional
+       + "--library-path"      optional
+       + the library path      optional
+       + the application name  */
+  TEST_VERIFY_EXIT (argc == 2 || argc == 5);
+  spargv = xcalloc (argc + 2, sizeof (char *));
+  for (int i = 0; i < argc - 1; i++)
+    spargv[i] = argv[i + 1];
+  spargv[argc - 1] = (char *) "--direct";
+  spargv[argc] = (char *) "--restart";
+
+  char *dir = support_create_temp_directory ("tst-bind-cache-");
+  char *path = xasprintf ("%s/cache", dir);
+  add_temp_file (path);
+  char *tunables = xasprintf ("GLIBC_TUNABLES=glibc.rtld.bind_cache=%s",
+			      path);
+  const char *debug = "LD_DEBUG=files,statistics";
+
+  /* The first run records the bindings.  */
+  char *out = run (tunables, debug);
+  if (strstr (out, "missing build ID") != NULL)
+    FAIL_UNSUPPORTED ("objects without build ID");
+  check_contains (out, "; recording", true);
+  check_contains (out, "; written with", true);
+  free (out);
+  struct stat64 st;
+  TEST_COMPARE (stat64 (path, &st), 0);
+
+  /* The second run uses them.  */
+  out = run (tunables, debug);
+  check_contains (out, "; using", true);
+  check_contains (out, "relocations from binding cache:", true);
+  check_contains (out, "; written with", false);
+  free (out);
+
+  /* A damaged file is replaced.  */
+  support_write_file_string (path, "ld.so-bc");
+  out = run (tunables, debug);
+  check_contains (out, "; recording", true);
+  check_contains (out, "; written with", true);
+  free (out);
+  out = run (tunables, debug);
+  check_contains (out, "; using", true);
+  free (out);
+
+  /* Without the tunable, the file is not used.  */
+  out = run (debug, NULL);
+  check_contains (out, "binding cache=", false);
+  check_contains (out, "relocations from binding cache:", false);
+  free (out);
+
+  free (tunables);
+  free (path);
+  free (dir);
+  free (spargv);
+  return 0;
+}
+
+#define TEST_FUNCTION_ARGV do_test
+#include <support/test-driver.c>
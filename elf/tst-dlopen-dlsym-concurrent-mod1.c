@@ -0,0 +1,32 @@
+/* Module with a blocking constructor for tst-dlopen-dlsym-concurrent.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Defined in the main program.  */
+extern void concurrent_constructor_wait (void);
+
+static void __attribute__ ((constructor))
+init (void)
+{
+  concurrent_constructor_wait ();
+}
+
+int
+mod1_function (void)
+{
+  return 1;
+}
@@ -0,0 +1,102 @@
+/* Test that dlsym with a handle and dladdr do not wait for dlopen.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+#include <support/xthread.h>
+
+/* The constructor of mod1 runs with the loader lock held.  It waits
+   until the main thread has performed its lookups through handles.  If
+   they needed the loader lock, the test would deadlock and time out.
+   Lookups with RTLD_DEFAULT still wait for the dlopen call, so that they
+   do not find mod1 before its constructor has run.  */
+
+static pthread_barrier_t barrier;
+
+/* Set once the constructor of mod1 is about to return.  */
+static volatile bool constructor_done;
+
+void
+concurrent_constructor_wait (void)
+{
+  /* The constructor is running.  */
+  xpthread_barrier_wait (&barrier);
+  /* The lookups are done.  */
+  xpthread_barrier_wait (&barrier);
+  constructor_done = true;
+}
+
+static void *
+load_thread (void *closure)
+{
+  return xdlopen ("tst-dlopen-dlsym-concurrent-mod1.so",
+		  RTLD_NOW | RTLD_GLOBAL);
+}
+
+static void *
+default_lookup_thread (void *closure)
+{
+  int (*mod1_function) (void) = xdlsym (RTLD_DEFAULT, "mod1_function");
+  TEST_VERIFY (constructor_done);
+  TEST_COMPARE (mod1_function (), 1);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  void *mod2 = xdlopen ("tst-dlopen-dlsym-concurrent-mod2.so", RTLD_NOW);
+
+  xpthread_barrier_init (&barrier, NULL, 2);
+  pthread_t thr = xpthread_create (NULL, load_thread, NULL);
+  xpthread_barrier_wait (&barrier);
+
+  /* mod1 is already in the global scope, but its constructor has not
+     completed.  This thread blocks until dlopen returns.  */
+  pthread_t default_thr = xpthread_create (NULL, default_lookup_thread,
+					   NULL);
+
+  int (*mod2_function) (void) = xdlsym (mod2, "mod2_function");
+  TEST_COMPARE (mod2_function (), 2);
+
+  Dl_info info;
+  TEST_VERIFY_EXIT (dladdr (mod2_function, &info) != 0);
+  TEST_VERIFY (strstr (info.dli_fname, "tst-dlopen-dlsym-concurrent-mod2.so")
+	       != NULL);
+  TEST_COMPARE_STRING (info.dli_sname, "mod2_function");
+
+  xpthread_barrier_wait (&barrier);
+  void *mod1 = xpthread_join (thr);
+  xpthread_join (default_thr);
+
+  TEST_VERIFY (xdlsym (RTLD_DEFAULT, "concurrent_constructor_wait")
+	       == concurrent_constructor_wait);
+  TEST_VERIFY (dlvsym (RTLD_NEXT, "concurrent_constructor_wait",
+		       "NOT_A_VERSION") == NULL);
+
+  xdlclose (mod1);
+  xdlclose (mod2);
+  xpthread_barrier_destroy (&barrier);
+  return 0;
+}
+
+#include <support/test-driver.c>
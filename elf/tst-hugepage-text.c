@@ -0,0 +1,130 @@
+/* Test huge page placement of text segments (glibc.rtld.hugepage_text).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <link.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+#include <support/xstdio.h>
+
+static unsigned long int
+thp_pagesize (void)
+{
+  FILE *f = fopen ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+		   "r");
+  if (f == NULL)
+    return 0;
+  unsigned long int size;
+  if (fscanf (f, "%lu", &size) != 1)
+    size = 0;
+  xfclose (f);
+  return size;
+}
+
+static bool
+thp_enabled (void)
+{
+  FILE *f = fopen ("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (f == NULL)
+    return false;
+  char *line = NULL;
+  size_t n = 0;
+  bool enabled = (getline (&line, &n, f) > 0
+		  && (strstr (line, "[always]") != NULL
+		      || strstr (line, "[madvise]") != NULL));
+  free (line);
+  xfclose (f);
+  return enabled;
+}
+
+/* Return true if the mapping containing ADDR has been advised with
+   MADV_HUGEPAGE.  */
+static bool
+mapping_advised (unsigned long int addr)
+{
+  FILE *f = xfopen ("/proc/self/smaps", "r");
+  char *line = NULL;
+  size_t n = 0;
+  bool found = false;
+  bool advised = false;
+  while (getline (&line, &n, f) > 0)
+    {
+      unsigned long int start, end;
+      if (sscanf (line, "%lx-%lx ", &start, &end) == 2)
+	found = start <= addr && addr < end;
+      else if (found && strncmp (line, "VmFlags:", 8) == 0)
+	{
+	  advised = strstr (line, " hg") != NULL;
+	  break;
+	}
+    }
+  free (line);
+  xfclose (f);
+  return advised;
+}
+
+static unsigned long int size;
+static int checked;
+
+static int
+callback (struct dl_phdr_info *info, size_t info_size, void *closure)
+{
+  const char *name = strrchr (info->dlpi_name, '/');
+  if (name == NULL || strcmp (name + 1, "tst-hugepage-text-mod.so") != 0)
+    return 0;
+
+  for (int i = 0; i < info->dlpi_phnum; ++i)
+    {
+      const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+      if (ph->p_type != PT_LOAD || (ph->p_flags & PF_X) == 0)
+	continue;
+      unsigned long int start = info->dlpi_addr + ph->p_vaddr;
+      unsigned long int aligned = (start + size - 1) & -size;
+      if (aligned + size > start + ph->p_filesz)
+	FAIL_UNSUPPORTED ("huge page size %#lx exceeds the text segment",
+			  size);
+      TEST_COMPARE ((start - ph->p_offset) % size, 0);
+      TEST_VERIFY (mapping_advised (aligned));
+      ++checked;
+    }
+  return 1;
+}
+
+static int
+do_test (void)
+{
+  size = thp_pagesize ();
+  if (size == 0 || !thp_enabled ())
+    FAIL_UNSUPPORTED ("transparent huge pages are not enabled");
+
+  void *handle = xdlopen ("tst-hugepage-text-mod.so", RTLD_NOW);
+  int (*mod_function) (void) = xdlsym (handle, "mod_function");
+  TEST_COMPARE (mod_function (), 42);
+
+  TEST_COMPARE (dl_iterate_phdr (callback, NULL), 1);
+  TEST_VERIFY (checked > 0);
+
+  xdlclose (handle);
+  return 0;
+}
+
+#include <support/test-driver.c>
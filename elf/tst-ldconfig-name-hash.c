@@ -0,0 +1,167 @@
+/* Test library lookups through the name hash table of ld.so.cache.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dl-cache.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdlfcn.h>
+#include <support/xstdio.h>
+#include <support/xunistd.h>
+
+#define DSO_DIR "/tmp/tst-ldconfig-name-hash"
+#define DSO "libldconfig-name-hash.so.1"
+
+static char *cache_path;
+
+static void
+run_ldconfig (void *closure)
+{
+  char *prog = xasprintf ("%s/ldconfig", support_install_rootsbindir);
+  char *args[] = { prog, NULL };
+
+  execv (args[0], args);
+  FAIL_EXIT1 ("execv: %m");
+}
+
+/* Return the offset in the cache file of the extension section
+   descriptor for the name hash table, or 0 if there is none.  If
+   SLOTS_OFFSET is not NULL, store the offset of the number of slots of
+   the table there.  */
+static off_t
+find_name_hash (off_t *slots_offset)
+{
+  int fd = xopen (cache_path, O_RDONLY, 0);
+  struct stat64 st;
+  xfstat64 (fd, &st);
+  void *file = xmmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd);
+  xclose (fd);
+
+  const struct cache_file_new *cache = file;
+  TEST_VERIFY_EXIT (st.st_size >= sizeof (*cache));
+  TEST_VERIFY_EXIT (memcmp (cache->magic, CACHEMAGIC_VERSION_NEW,
+			    sizeof (CACHEMAGIC_VERSION_NEW) - 1) == 0);
+  struct cache_extension_all_loaded loaded;
+  TEST_VERIFY_EXIT (cache_extension_load (cache, file, st.st_size,
+					  &loaded));
+
+  off_t result = 0;
+  const struct cache_extension *ext = file + cache->extension_offset;
+  if (cache->extension_offset != 0)
+    for (uint32_t i = 0; i < ext->count; ++i)
+      if (ext->sections[i].tag == cache_extension_tag_name_hash)
+	{
+	  result = ((const char *) &ext->sections[i] - (const char *) file);
+	  if (slots_offset != NULL)
+	    *slots_offset = ext->sections[i].offset;
+	}
+
+  /* The section is only used if it is valid.  */
+  bool valid = loaded.sections[cache_extension_tag_name_hash].base != NULL;
+  xmunmap (file, st.st_size);
+  return valid ? result : 0;
+}
+
+/* Overwrite the 32-bit word at OFFSET of the cache file with VALUE.  */
+static void
+patch_cache (off_t offset, uint32_t value)
+{
+  int fd = xopen (cache_path, O_RDWR, 0);
+  TEST_COMPARE (pwrite64 (fd, &value, sizeof (value), offset),
+		sizeof (value));
+  xclose (fd);
+}
+
+/* Look up names which are and are not in the cache.  The dynamic linker
+   maps the cache file again for each dlopen call.  */
+static void
+check_lookups (void)
+{
+  void *handle = xdlopen (DSO, RTLD_NOW);
+  xdlclose (handle);
+
+  /* Version numbers are compared numerically.  */
+  handle = xdlopen ("libldconfig-name-hash.so.001", RTLD_NOW);
+  xdlclose (handle);
+
+  TEST_VERIFY (dlopen ("libldconfig-name-hash.so.2", RTLD_NOW) == NULL);
+  TEST_VERIFY (dlopen ("libldconfig-name-hash.so", RTLD_NOW) == NULL);
+  TEST_VERIFY (dlopen ("libldconfig-name-hash-missing.so.1", RTLD_NOW)
+	       == NULL);
+}
+
+static int
+do_test (void)
+{
+  cache_path = xasprintf ("%s/ld.so.cache", support_sysconfdir_prefix);
+  char *conf_path = xasprintf ("%s/ld.so.conf", support_sysconfdir_prefix);
+
+  xmkdirp ("/var/cache/ldconfig", 0777);
+  xmkdirp (DSO_DIR, 0777);
+
+  /* ldconfig only considers files starting with "lib".  */
+  char *mod_src_path = xasprintf ("%s/tst-ldconfig-ld-mod.so",
+				  support_libdir_prefix);
+  if (rename (mod_src_path, DSO_DIR "/" DSO))
+    FAIL_EXIT1 ("Renaming/moving the DSO failed: %m");
+  free (mod_src_path);
+
+  FILE *fp = xfopen (conf_path, "w");
+  fputs (DSO_DIR "\n", fp);
+  xfclose (fp);
+
+  struct support_capture_subprocess result
+    = support_capture_subprocess (run_ldconfig, NULL);
+  support_capture_subprocess_check (&result, "ldconfig", 0, sc_allow_none);
+  support_capture_subprocess_free (&result);
+
+  /* Lookups through the hash table.  */
+  off_t slots_offset;
+  off_t section = find_name_hash (&slots_offset);
+  TEST_VERIFY_EXIT (section != 0);
+  check_lookups ();
+
+  /* A table with an invalid size is ignored, and the entries are
+     searched as in caches without the table.  */
+  patch_cache (slots_offset, 3);
+  TEST_COMPARE (find_name_hash (NULL), 0);
+  check_lookups ();
+
+  /* Likewise for caches written by an ldconfig which does not know the
+     table.  The dynamic linker ignores unknown extension sections.  */
+  patch_cache (section
+	       + offsetof (struct cache_extension_section, tag),
+	       cache_extension_count);
+  TEST_COMPARE (find_name_hash (NULL), 0);
+  check_lookups ();
+
+  free (conf_path);
+  free (cache_path);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,39 @@
+/* Module 3 for tst-reloc-parallel, which only depends on module 4.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+extern int reloc_parallel_base;
+extern int reloc_parallel_base_value (void);
+
+/* Copy-relocated into the main program.  */
+int mod3_data = 3;
+
+int
+mod3_value (void)
+{
+  return reloc_parallel_base_value () + mod3_data;
+}
+
+/* Relocated data referring to this object and to module 4.  */
+int (*mod3_function) (void) = mod3_value;
+int *mod3_base = &reloc_parallel_base;
+
+int *
+mod3_data_address (void)
+{
+  return &mod3_data;
+}
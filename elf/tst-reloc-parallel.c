@@ -0,0 +1,62 @@
+/* Test parallel relocation of the initial objects.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test runs with glibc.rtld.relocation_threads set.  Modules 1 to 3
+   only depend on module 4 and are relocated concurrently.  */
+
+#include <support/check.h>
+
+extern int reloc_parallel_base;
+
+#define DECLARE_MOD(n)					\
+  extern int mod##n##_data;				\
+  extern int mod##n##_value (void);			\
+  extern int (*mod##n##_function) (void);		\
+  extern int *mod##n##_base;				\
+  extern int *mod##n##_data_address (void);
+
+DECLARE_MOD (1)
+DECLARE_MOD (2)
+DECLARE_MOD (3)
+
+#define CHECK_MOD(n)						\
+  do								\
+    {								\
+      TEST_COMPARE (mod##n##_data, n);				\
+      TEST_VERIFY (mod##n##_data_address () == &mod##n##_data);	\
+      TEST_VERIFY (mod##n##_function == mod##n##_value);	\
+      TEST_COMPARE (mod##n##_function (), 100 + n);		\
+      TEST_VERIFY (mod##n##_base == &reloc_parallel_base);	\
+    }								\
+  while (0)
+
+static int
+do_test (void)
+{
+  CHECK_MOD (1);
+  CHECK_MOD (2);
+  CHECK_MOD (3);
+
+  /* The references to the data in the main program have been
+     relocated after the copy relocations.  */
+  mod2_data = 20;
+  TEST_COMPARE (mod2_value (), 120);
+  return 0;
+}
+
+#include <support/test-driver.c>
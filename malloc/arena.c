@@ -17,7 +17,9 @@
    not, see <https://www.gnu.org/licenses/>.  */
 
 #include <stdbool.h>
+#include <time.h>
 #include <setvmaname.h>
+#include <malloc-thread.h>
 
 #define TUNABLE_NAMESPACE malloc
 #include <elf/dl-tunables.h>
@@ -113,11 +115,45 @@ static mstate free_list;
    acquired.  */
 __libc_lock_define_initialized (static, list_lock);
 
+#if IS_IN (libc)
+/* The id of the next arena created.  Protected by list_lock.  */
+static int arena_next_id = 1;
+#endif
+
+/* Per-CPU arena table, used if glibc.malloc.percpu_arena is set.  It is
+   allocated on first use and never freed.  Slot I holds the arena used
+   by threads running on CPUs whose number is I modulo npercpu_arenas;
+   slot 0 is always the main arena.  Slots are filled in under
+   list_lock and then never change, so they can be read without
+   locking.  npercpu_arenas is written before the release store to
+   percpu_arenas.  */
+#if IS_IN (libc)
+static mstate *percpu_arenas;
+static size_t npercpu_arenas;
+#endif
+
+/* State of the thread which trims arenas if glibc.malloc.trim_decay is
+   set.  free requests the thread while holding an arena lock, and it is
+   started once no lock is held.  The thread resets the state to
+   trim_thread_none when it exits.  */
+#if IS_IN (libc)
+enum
+  {
+    trim_thread_none,
+    trim_thread_requested,
+    trim_thread_running,
+    trim_thread_failed,
+  };
+static int trim_thread_state;
+#endif
+
 /**************************************************************************/
 
 
 /* arena_get() acquires an arena and locks the corresponding mutex.
-   First, try the one last locked successfully by this thread.  (This
+   If per-CPU arenas are enabled, use the arena of the CPU the thread
+   currently runs on.  Otherwise, or if the CPU cannot be determined,
+   first try the one last locked successfully by this thread.  (This
    is the common case and handled with a macro for speed.)  Then, loop
    once over the circularly linked list of arenas.  If no arena is
    readily available, create a new one.  In this latter case, `size'
@@ -125,13 +161,31 @@ __libc_lock_define_initialized (static, list_lock);
    in the new arena. */
 
 #define arena_get(ptr, size) do { \
-      ptr = thread_arena;						      \
-      arena_lock (ptr, size);						      \
+      ptr = NULL;							      \
+      if (__glibc_unlikely (mp_.percpu_arena))				      \
+        ptr = percpu_arena_get (size);					      \
+      if (ptr == NULL)							      \
+        {								      \
+          ptr = thread_arena;						      \
+          arena_lock (ptr, size);					      \
+        }								      \
   } while (0)
 
+/* Lock the mutex of arena AV, counting the acquisitions which have to
+   wait for it.  */
+static __always_inline void
+arena_mutex_lock (mstate av)
+{
+  if (__glibc_unlikely (__libc_lock_trylock (av->mutex) != 0))
+    {
+      atomic_fetch_add_relaxed (&av->lock_waits, 1);
+      __libc_lock_lock (av->mutex);
+    }
+}
+
 #define arena_lock(ptr, size) do {					      \
       if (ptr)								      \
-        __libc_lock_lock (ptr->mutex);					      \
+        arena_mutex_lock (ptr);						      \
       else								      \
         ptr = arena_get2 ((size), NULL);				      \
   } while (0)
@@ -177,11 +231,19 @@ __malloc_fork_lock_parent (void)
       if (ar_ptr == &main_arena)
         break;
     }
+
+  slab_fork_lock ();
+  profile_fork_lock ();
+  tcache_fork_lock ();
 }
 
 void
 __malloc_fork_unlock_parent (void)
 {
+  tcache_fork_unlock_parent ();
+  profile_fork_unlock_parent ();
+  slab_fork_unlock_parent ();
+
   for (mstate ar_ptr = &main_arena;; )
     {
       __libc_lock_unlock (ar_ptr->mutex);
@@ -195,6 +257,10 @@ __malloc_fork_unlock_parent (void)
 void
 __malloc_fork_unlock_child (void)
 {
+  tcache_fork_unlock_child ();
+  profile_fork_unlock_child ();
+  slab_fork_unlock_child ();
+
   /* Push all arenas to the free list, except thread_arena, which is
      attached to the current thread.  */
   __libc_lock_init (free_list_lock);
@@ -204,7 +270,11 @@ __malloc_fork_unlock_child (void)
   for (mstate ar_ptr = &main_arena;; )
     {
       __libc_lock_init (ar_ptr->mutex);
-      if (ar_ptr != thread_arena)
+      if (arena_is_percpu (ar_ptr))
+	/* Per-CPU arenas stay in their slot; only the reference held by
+	   the slot and possibly the one of this thread remain.  */
+	ar_ptr->attached_threads = 1 + (ar_ptr == thread_arena);
+      else if (ar_ptr != thread_arena)
         {
 	  /* This arena is no longer attached to any thread.  */
 	  ar_ptr->attached_threads = 0;
@@ -216,6 +286,13 @@ __malloc_fork_unlock_child (void)
         break;
     }
 
+#if IS_IN (libc)
+  /* The trim thread does not exist in the child.  It is started again
+     when needed.  */
+  if (trim_thread_state != trim_thread_failed)
+    trim_thread_state = trim_thread_none;
+#endif
+
   __libc_lock_init (list_lock);
 }
 
@@ -239,8 +316,17 @@ TUNABLE_CALLBACK_FNDECL (set_arena_test, size_t)
 TUNABLE_CALLBACK_FNDECL (set_tcache_max, size_t)
 TUNABLE_CALLBACK_FNDECL (set_tcache_count, size_t)
 TUNABLE_CALLBACK_FNDECL (set_tcache_unsorted_limit, size_t)
+TUNABLE_CALLBACK_FNDECL (set_tcache_refill_count, size_t)
+TUNABLE_CALLBACK_FNDECL (set_tcache_flush_count, size_t)
+TUNABLE_CALLBACK_FNDECL (set_tcache_counters, int32_t)
 #endif
 TUNABLE_CALLBACK_FNDECL (set_hugetlb, size_t)
+TUNABLE_CALLBACK_FNDECL (set_percpu_arena, int32_t)
+TUNABLE_CALLBACK_FNDECL (set_remote_free, int32_t)
+TUNABLE_CALLBACK_FNDECL (set_trim_decay, size_t)
+TUNABLE_CALLBACK_FNDECL (set_slab_max, size_t)
+TUNABLE_CALLBACK_FNDECL (set_profile_rate, size_t)
+TUNABLE_CALLBACK_FNDECL (set_realloc_mremap_threshold, size_t)
 
 #if USE_TCACHE
 static void tcache_key_initialize (void);
@@ -292,8 +378,23 @@ __ptmalloc_init (void)
   TUNABLE_GET (tcache_count, size_t, TUNABLE_CALLBACK (set_tcache_count));
   TUNABLE_GET (tcache_unsorted_limit, size_t,
 	       TUNABLE_CALLBACK (set_tcache_unsorted_limit));
+  TUNABLE_GET (tcache_refill_count, size_t,
+	       TUNABLE_CALLBACK (set_tcache_refill_count));
+  TUNABLE_GET (tcache_flush_count, size_t,
+	       TUNABLE_CALLBACK (set_tcache_flush_count));
+  TUNABLE_GET (tcache_counters, int32_t,
+	       TUNABLE_CALLBACK (set_tcache_counters));
 # endif
   TUNABLE_GET (hugetlb, size_t, TUNABLE_CALLBACK (set_hugetlb));
+  TUNABLE_GET (percpu_arena, int32_t, TUNABLE_CALLBACK (set_percpu_arena));
+  TUNABLE_GET (remote_free, int32_t, TUNABLE_CALLBACK (set_remote_free));
+  TUNABLE_GET (trim_decay, size_t, TUNABLE_CALLBACK (set_trim_decay));
+  TUNABLE_GET (slab_max, size_t, TUNABLE_CALLBACK (set_slab_max));
+  slab_init ();
+  TUNABLE_GET (profile_rate, size_t, TUNABLE_CALLBACK (set_profile_rate));
+  profile_init ();
+  TUNABLE_GET (realloc_mremap_threshold, size_t,
+	       TUNABLE_CALLBACK (set_realloc_mremap_threshold));
 
   if (mp_.hp_pagesize > 0 && mp_.hp_pagesize <= heap_max_size ())
     {
@@ -429,7 +530,12 @@ alloc_new_heap  (size_t size, size_t top_pad, size_t pagesize,
   /* Only considere the actual usable range.  */
   __set_vma_name (p2, size, " glibc: malloc arena");
 
-  madvise_thp (p2, size);
+  /* Advise the whole reservation rather than just the initial size, so
+     that the ranges made accessible later by grow_heap are also backed
+     by huge pages.  The heap is aligned to max_size, so its huge pages
+     start at the heap boundary.  */
+  if (mmap_flags == 0)
+    madvise_thp (p2, max_size);
 
   h = (heap_info *) p2;
   h->size = size;
@@ -480,10 +586,9 @@ grow_heap (heap_info *h, long diff)
       h->mprotect_size = new_size;
     }
 
-  /* mprotect preserves MADV_HUGEPAGE semantics - this means that if the old
-     region was marked with MADV_HUGEPAGE, the new region will retain that.  */
-  if (h->size < mp_.thp_pagesize)
-    madvise_thp (h, new_size);
+  /* mprotect preserves MADV_HUGEPAGE semantics, and alloc_new_heap has
+     already marked the whole heap reservation, so the new region does not
+     need to be advised again.  */
 
   h->size = new_size;
   LIBC_PROBE (memory_heap_more, 2, h, h->size);
@@ -551,6 +656,7 @@ heap_trim (heap_info *heap, size_t pad)
 						    + heap->pagesize)
         break;
       ar_ptr->system_mem -= heap->size;
+      arena_count (&ar_ptr->trimmed_bytes, heap->size);
       LIBC_PROBE (memory_heap_free, 2, heap, heap->size);
       if ((char *) heap + max_size == aligned_heap_area)
 	aligned_heap_area = NULL;
@@ -591,6 +697,7 @@ heap_trim (heap_info *heap, size_t pad)
     return 0;
 
   ar_ptr->system_mem -= extra;
+  arena_count (&ar_ptr->trimmed_bytes, extra);
 
   /* Success. Adjust top accordingly. */
   set_head (top_chunk, (top_size - extra) | PREV_INUSE);
@@ -598,6 +705,153 @@ heap_trim (heap_info *heap, size_t pad)
   return 1;
 }
 
+#if IS_IN (libc)
+/* Number of periods without marked arenas after which the trim thread
+   exits.  It is started again by the next free which marks an arena.  */
+#define TRIM_THREAD_IDLE_PERIODS 8
+
+/* Advance the trim_pending marks of all arenas, and trim the arenas which
+   have been marked for a whole period.  Return true if any arena is still
+   marked.  */
+static bool
+trim_thread_scan (void)
+{
+  bool marked = false;
+  mstate ar_ptr = &main_arena;
+  do
+    {
+      /* Only free sets trim_pending to 1 (from 0, with the arena mutex
+	 held), so the unlocked update to 2 does not lose a mark.  */
+      int pending = atomic_load_relaxed (&ar_ptr->trim_pending);
+      if (pending == 1)
+	{
+	  atomic_store_relaxed (&ar_ptr->trim_pending, 2);
+	  marked = true;
+	}
+      else if (pending == 2)
+	{
+	  __libc_lock_lock (ar_ptr->mutex);
+	  atomic_store_relaxed (&ar_ptr->trim_pending, 0);
+	  _int_trim (ar_ptr);
+	  __libc_lock_unlock (ar_ptr->mutex);
+	}
+      ar_ptr = ar_ptr->next;
+    }
+  while (ar_ptr != &main_arena);
+  return marked;
+}
+
+/* Return true if any arena is marked for trimming.  */
+static bool
+trim_thread_any_marked (void)
+{
+  mstate ar_ptr = &main_arena;
+  do
+    {
+      if (atomic_load_relaxed (&ar_ptr->trim_pending) != 0)
+	return true;
+      ar_ptr = ar_ptr->next;
+    }
+  while (ar_ptr != &main_arena);
+  return false;
+}
+
+/* Body of the trim thread.  Every glibc.malloc.trim_decay milliseconds,
+   trim the arenas which have been marked for a whole period.  Memory
+   freed at the top of an arena is thus returned to the system after one
+   to two periods, unless the arena is trimmed earlier by malloc_trim.
+   The thread exits once no arena has been marked for
+   TRIM_THREAD_IDLE_PERIODS periods.  */
+static void *
+trim_thread (void *closure)
+{
+  struct timespec period =
+    {
+      .tv_sec = mp_.trim_decay / 1000,
+      .tv_nsec = (mp_.trim_decay % 1000) * 1000000
+    };
+
+  int idle = 0;
+  while (true)
+    {
+      __clock_nanosleep (CLOCK_MONOTONIC, 0, &period, NULL);
+
+      if (trim_thread_scan ())
+	idle = 0;
+      else if (++idle >= TRIM_THREAD_IDLE_PERIODS)
+	{
+	  /* A free which marks an arena after this store starts a new
+	     thread.  Marks set before it are seen by the check below, which
+	     pairs with the fence in trim_thread_defer.  */
+	  atomic_store_relaxed (&trim_thread_state, trim_thread_none);
+	  atomic_thread_fence_seq_cst ();
+	  if (!trim_thread_any_marked ())
+	    break;
+	  /* Continue unless a free has already requested a new thread.  */
+	  int state = trim_thread_none;
+	  if (!atomic_compare_exchange_relaxed (&trim_thread_state, &state,
+						trim_thread_running))
+	    break;
+	  idle = 0;
+	}
+    }
+
+  return NULL;
+}
+
+/* Mark AV for trimming by the trim thread.  The arena mutex must be held.
+   Return false if the trim thread is not available and the caller has to
+   trim AV itself.  */
+static bool
+trim_thread_defer (mstate av)
+{
+  if (atomic_load_relaxed (&trim_thread_state) == trim_thread_failed)
+    return false;
+
+  /* Keep an existing mark, so that repeated frees do not postpone
+     trimming indefinitely.  */
+  if (atomic_load_relaxed (&av->trim_pending) == 0)
+    atomic_store_relaxed (&av->trim_pending, 1);
+
+  /* Either the exiting trim thread sees the mark, or this sees that the
+     thread has exited.  */
+  atomic_thread_fence_seq_cst ();
+  int state = atomic_load_relaxed (&trim_thread_state);
+  if (state == trim_thread_none)
+    atomic_compare_exchange_relaxed (&trim_thread_state, &state,
+				     trim_thread_requested);
+  return true;
+}
+
+/* Start the trim thread if it has been requested.  No arena lock may be
+   held because thread creation allocates memory.  */
+static inline void
+trim_thread_maybe_start (void)
+{
+  int state = atomic_load_relaxed (&trim_thread_state);
+  if (__glibc_likely (state != trim_thread_requested))
+    return;
+  if (!atomic_compare_exchange_weak_acquire (&trim_thread_state, &state,
+					     trim_thread_running))
+    return;
+  if (!malloc_create_helper_thread (trim_thread))
+    /* Arenas marked so far are trimmed by the next free which would
+       trim them.  */
+    atomic_store_relaxed (&trim_thread_state, trim_thread_failed);
+}
+#else
+static inline bool
+trim_thread_defer (mstate av)
+{
+  return false;
+}
+
+static inline void
+trim_thread_maybe_start (void)
+{
+}
+#endif
+
 /* Create a new arena with initial size "size".  */
 
 #if IS_IN (libc)
@@ -617,8 +871,11 @@ detach_arena (mstate replaced_arena)
     }
 }
 
+/* Allocate the first heap of a new arena and initialize the arena
+   state in it.  The arena is neither locked nor linked into the list
+   of arenas.  */
 static mstate
-_int_new_arena (size_t size)
+alloc_new_arena (size_t size)
 {
   mstate a;
   heap_info *h;
@@ -651,12 +908,24 @@ _int_new_arena (size_t size)
   set_head (top (a), (((char *) h + h->size) - ptr) | PREV_INUSE);
 
   LIBC_PROBE (memory_arena_new, 2, a, size);
+  return a;
+}
+
+static mstate
+_int_new_arena (size_t size)
+{
+  mstate a = alloc_new_arena (size);
+  if (a == NULL)
+    return NULL;
+
   mstate replaced_arena = thread_arena;
   thread_arena = a;
   __libc_lock_init (a->mutex);
 
   __libc_lock_lock (list_lock);
 
+  a->id = arena_next_id++;
+
   /* Add the new arena to the global list.  */
   a->next = main_arena.next;
   /* FIXME: The barrier is an attempt to synchronize with read access
@@ -714,6 +983,10 @@ get_free_list (void)
           LIBC_PROBE (memory_arena_reuse_free_list, 1, result);
           __libc_lock_lock (result->mutex);
 	  thread_arena = result;
+
+	  /* Release the chunks freed remotely since the last thread using
+	     the arena exited.  */
+	  _int_free_remote_drain (result);
         }
     }
 
@@ -772,7 +1045,7 @@ reused_arena (mstate avoid_arena)
 
   /* No arena available without contention.  Wait for the next in line.  */
   LIBC_PROBE (memory_arena_reuse_wait, 3, &result->mutex, result, avoid_arena);
-  __libc_lock_lock (result->mutex);
+  arena_mutex_lock (result);
 
 out:
   /* Attach the arena to the current thread.  */
@@ -801,6 +1074,9 @@ out:
   thread_arena = result;
   next_to_use = result->next;
 
+  /* The arena may have come from the free list, see get_free_list.  */
+  _int_free_remote_drain (result);
+
   return result;
 }
 
@@ -854,6 +1130,119 @@ arena_get2 (size_t size, mstate avoid_arena)
   return a;
 }
 
+/* Allocate the per-CPU arena table.  Returns NULL and disables per-CPU
+   arenas if that is not possible.  */
+static mstate *
+percpu_arenas_init (void)
+{
+  __libc_lock_lock (list_lock);
+  mstate *table = percpu_arenas;
+  if (table == NULL)
+    {
+      int ncpus = __get_nprocs_conf ();
+      size_t n = ncpus >= 1 ? ncpus : 1;
+      /* glibc.malloc.arena_max still bounds the number of arenas; CPUs
+	 then share arenas round-robin.  */
+      if (mp_.arena_max != 0 && mp_.arena_max < n)
+	n = mp_.arena_max;
+
+      size_t size = ALIGN_UP (n * sizeof (mstate), GLRO (dl_pagesize));
+      table = (mstate *) MMAP (NULL, size, PROT_READ | PROT_WRITE, 0);
+      if (table != MAP_FAILED)
+	{
+	  __set_vma_name (table, size, " glibc: malloc percpu arenas");
+	  table[0] = &main_arena;
+	  npercpu_arenas = n;
+	  atomic_store_release (&percpu_arenas, table);
+	}
+      else
+	{
+	  table = NULL;
+	  mp_.percpu_arena = 0;
+	}
+    }
+  __libc_lock_unlock (list_lock);
+  return table;
+}
+
+/* Create the arena for per-CPU slot SLOT if no other thread has done so
+   in the meantime, and return it locked.  */
+static mstate
+percpu_arena_new (size_t slot, size_t size)
+{
+  __libc_lock_lock (list_lock);
+  mstate a = percpu_arenas[slot];
+  if (a == NULL)
+    {
+      a = alloc_new_arena (size);
+      if (a != NULL)
+	{
+	  /* The reference held by the slot keeps attached_threads
+	     positive, so the arena never reaches the free list.  */
+	  set_percpu (a);
+	  __libc_lock_init (a->mutex);
+	  atomic_fetch_add_relaxed (&narenas, 1);
+	  a->id = arena_next_id++;
+
+	  /* Add the new arena to the global list.  See the FIXME in
+	     _int_new_arena about the barrier.  */
+	  a->next = main_arena.next;
+	  atomic_write_barrier ();
+	  main_arena.next = a;
+
+	  atomic_store_release (&percpu_arenas[slot], a);
+	}
+    }
+  __libc_lock_unlock (list_lock);
+
+  if (a != NULL)
+    __libc_lock_lock (a->mutex);
+  return a;
+}
+
+/* Lock and return the arena for the CPU the calling thread runs on.
+   Returns NULL if the CPU is unknown (for example because rseq
+   registration failed), in which case the caller falls back to the
+   arena attached to the thread.  The CPU number is only a hint: the
+   thread may be migrated at any time, which at worst causes contention
+   on the arena of the previous CPU.  */
+static mstate
+percpu_arena_get (size_t size)
+{
+  int cpu = malloc_getcpu ();
+  if (__glibc_unlikely (cpu < 0))
+    return NULL;
+
+  mstate *table = atomic_load_acquire (&percpu_arenas);
+  if (__glibc_unlikely (table == NULL))
+    {
+      table = percpu_arenas_init ();
+      if (table == NULL)
+	return NULL;
+    }
+
+  size_t slot = cpu % npercpu_arenas;
+  mstate a = atomic_load_acquire (&table[slot]);
+  if (__glibc_unlikely (a == NULL))
+    return percpu_arena_new (slot, size);
+
+  if (__libc_lock_trylock (a->mutex) == 0)
+    return a;
+
+  /* The arena is busy.  If the thread was migrated since the CPU number
+     was read, the arena of the new CPU is likely uncontended.  */
+  cpu = malloc_getcpu ();
+  if (cpu >= 0 && cpu % npercpu_arenas != slot)
+    {
+      mstate b = atomic_load_acquire (&table[cpu % npercpu_arenas]);
+      if (b != NULL && __libc_lock_trylock (b->mutex) == 0)
+	return b;
+    }
+
+  arena_mutex_lock (a);
+  return a;
+}
+
 /* If we don't have the main arena, then maybe the failure is due to running
    out of mmapped areas, so we can try allocating on the main arena.
    Otherwise, it is likely that sbrk() has failed and there is still a chance
@@ -884,6 +1273,7 @@ __malloc_arena_thread_freeres (void)
      the thread arena, so do this before we put the arena on the free
      list.  */
   tcache_thread_shutdown ();
+  slab_thread_shutdown ();
 
   mstate a = thread_arena;
   thread_arena = NULL;
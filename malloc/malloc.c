@@ -1032,10 +1032,16 @@ typedef struct malloc_chunk* mchunkptr;
 static void*  _int_malloc(mstate, size_t);
 static void _int_free_chunk (mstate, mchunkptr, INTERNAL_SIZE_T, int);
 static void _int_free_merge_chunk (mstate, mchunkptr, INTERNAL_SIZE_T);
+static INTERNAL_SIZE_T _int_free_consolidate_chunk (mstate, mchunkptr,
+						    INTERNAL_SIZE_T);
 static INTERNAL_SIZE_T _int_free_create_chunk (mstate,
 					       mchunkptr, INTERNAL_SIZE_T,
 					       mchunkptr, INTERNAL_SIZE_T);
 static void _int_free_maybe_trim (mstate, INTERNAL_SIZE_T);
+static void _int_trim (mstate);
+static void _int_free_remote_push (mstate, mchunkptr);
+static INTERNAL_SIZE_T _int_free_remote_merge (mstate);
+static void _int_free_remote_drain (mstate);
 static void*  _int_realloc(mstate, mchunkptr, INTERNAL_SIZE_T,
 			   INTERNAL_SIZE_T);
 static void*  _int_memalign(mstate, size_t, size_t);
@@ -1715,6 +1721,17 @@ unlink_chunk (mstate av, mchunkptr p)
 #define set_noncontiguous(M)   ((M)->flags |= NONCONTIGUOUS_BIT)
 #define set_contiguous(M)      ((M)->flags &= ~NONCONTIGUOUS_BIT)
 
+/*
+   PERCPU_BIT marks arenas owned by a slot of the per-CPU arena table
+   (see glibc.malloc.percpu_arena).  They are selected by the CPU the
+   caller runs on, so they are never put on the arena free list.
+ */
+
+#define PERCPU_BIT            (4U)
+
+#define arena_is_percpu(M)     (((M)->flags & PERCPU_BIT) != 0)
+#define set_percpu(M)          ((M)->flags |= PERCPU_BIT)
+
 
 /*
    ----------- Internal state representation and initialization -----------
@@ -1732,6 +1749,16 @@ struct malloc_state
   /* Base of the topmost chunk -- not otherwise kept in a bin */
   mchunkptr top;
 
+  /* Chunks freed while the arena mutex was held by another thread,
+     pushed without taking the mutex (see glibc.malloc.remote_free).
+     Linked through the mangled fd pointer.  Updated atomically.  */
+  mchunkptr remote_free;
+
+  /* Set when trimming of this arena has been left to the trim thread (see
+     glibc.malloc.trim_decay), and advanced by that thread as it ages.
+     Updated atomically.  */
+  int trim_pending;
+
   /* The remainder from the most recent split of a small request */
   mchunkptr last_remainder;
 
@@ -1756,6 +1783,17 @@ struct malloc_state
   /* Memory allocated from the system in this arena.  */
   INTERNAL_SIZE_T system_mem;
   INTERNAL_SIZE_T max_system_mem;
+
+  /* Index of the arena for malloc_counters, assigned in the order of
+     creation.  The main arena has index 0.  */
+  int id;
+
+  /* Event counters for malloc_counters.  lock_waits is updated
+     atomically, the others with the arena mutex held.  All of them are
+     read without the mutex.  */
+  size_t lock_waits;
+  size_t sysmalloc_calls;
+  size_t trimmed_bytes;
 };
 
 struct malloc_par
@@ -1766,6 +1804,23 @@ struct malloc_par
   INTERNAL_SIZE_T mmap_threshold;
   INTERNAL_SIZE_T arena_test;
   INTERNAL_SIZE_T arena_max;
+  /* Select arenas by current CPU instead of attaching them to threads.  */
+  int percpu_arena;
+  /* Defer frees to contended arenas to the lock owner.  */
+  int remote_free;
+  /* Milliseconds free memory stays in an arena before the trim thread
+     returns it to the system; 0 to trim synchronously in free.  */
+  size_t trim_decay;
+  /* Requests smaller than this are served from slabs (see slab.c).  */
+  size_t slab_max_bytes;
+
+  /* Mean number of bytes requested between two sampled allocations, or 0
+     if the heap profiler is disabled (see profile.c).  */
+  size_t profile_rate;
+
+  /* realloc moves blocks growing to at least this size to mmapped chunks
+     with headroom, which later grow with mremap.  0 if disabled.  */
+  size_t realloc_mremap_threshold;
 
   /* Transparent Large Page support.  */
   enum malloc_thp_mode_t thp_mode;
@@ -1787,6 +1842,8 @@ struct malloc_par
   /* Statistics */
   INTERNAL_SIZE_T mmapped_mem;
   INTERNAL_SIZE_T max_mmapped_mem;
+  /* Number of chunks allocated with mmap so far.  Updated atomically.  */
+  size_t mmapped_chunks;
 
   /* First address handed out by MORECORE/sbrk.  */
   char *sbrk_base;
@@ -1800,6 +1857,15 @@ struct malloc_par
   /* Maximum number of chunks to remove from the unsorted list, which
      aren't used to prefill the cache.  */
   size_t tcache_unsorted_limit;
+  /* Number of additional chunks to carve from the top chunk into an
+     empty bucket on a miss.  */
+  size_t tcache_refill_count;
+  /* Number of chunks to return to the arenas at once from a full
+     bucket.  */
+  size_t tcache_flush_count;
+  /* Count the hits and misses of the thread caches for
+     malloc_counters.  */
+  int tcache_counters;
 #endif
 };
 
@@ -1832,7 +1898,9 @@ static struct malloc_par mp_ =
   .tcache_count = TCACHE_FILL_COUNT,
   .tcache_small_bins = TCACHE_SMALL_BINS,
   .tcache_max_bytes = MAX_TCACHE_SMALL_SIZE + 1,
-  .tcache_unsorted_limit = 0 /* No limit.  */
+  .tcache_unsorted_limit = 0, /* No limit.  */
+  .tcache_refill_count = 0,
+  .tcache_flush_count = 0
 #endif
 };
 
@@ -1878,6 +1946,20 @@ static int      systrim (size_t, mstate);
    thread cache (if it exists).  */
 static void tcache_thread_shutdown (void);
 
+/* These functions are called from the fork handlers, to protect the list
+   of thread caches.  */
+static void tcache_fork_lock (void);
+static void tcache_fork_unlock_parent (void);
+static void tcache_fork_unlock_child (void);
+
+/* Add N to COUNTER, one of the arena event counters updated with the
+   arena mutex held.  */
+static __always_inline void
+arena_count (size_t *counter, size_t n)
+{
+  atomic_store_relaxed (counter, *counter + n);
+}
+
 /* ------------------ Testing support ----------------------------------*/
 
 static int perturb_byte;
@@ -1940,6 +2022,12 @@ madvise_thp (void *p, INTERNAL_SIZE_T size)
 #endif
 }
 
+/* ------------------ Slab allocator for small objects ------------------ */
+#include "slab.c"
+
+/* ------------------------ Sampling heap profiler ---------------------- */
+#include "profile.c"
+
 /* ------------------- Support for multiple arenas -------------------- */
 #include "arena.c"
 
@@ -2275,6 +2363,7 @@ sysmalloc_mmap (INTERNAL_SIZE_T nb, size_t pagesize, int extra_flags)
   /* update statistics */
   int new = atomic_fetch_add_relaxed (&mp_.n_mmaps, 1) + 1;
   atomic_max (&mp_.max_n_mmaps, new);
+  atomic_fetch_add_relaxed (&mp_.mmapped_chunks, 1);
 
   unsigned long sum;
   sum = atomic_fetch_add_relaxed (&mp_.mmapped_mem, size) + size;
@@ -2339,6 +2428,8 @@ sysmalloc (INTERNAL_SIZE_T nb, mstate av)
   size_t pagesize = GLRO (dl_pagesize);
   bool tried_mmap = false;
 
+  if (av != NULL)
+    arena_count (&av->sysmalloc_calls, 1);
 
   /*
      If have mmap, and the request size meets the mmap threshold, and
@@ -2803,6 +2894,7 @@ systrim (size_t pad, mstate av)
             {
               /* Success. Adjust top. */
               av->system_mem -= released;
+              arena_count (&av->trimmed_bytes, released);
               set_head (av->top, (top_size - released) | PREV_INUSE);
               check_malloc_state (av);
               return 1;
@@ -2911,6 +3003,14 @@ typedef struct tcache_perthread_struct
 {
   uint16_t num_slots[TCACHE_MAX_BINS];
   tcache_entry *entries[TCACHE_MAX_BINS];
+  /* Requests served from each bin, and requests of its size which were
+     not.  Only the owning thread writes these counters, other threads
+     read them for malloc_counters.  */
+  size_t hits[TCACHE_MAX_BINS];
+  size_t misses[TCACHE_MAX_BINS];
+  /* Neighbors on tcache_list.  */
+  struct tcache_perthread_struct *next;
+  struct tcache_perthread_struct *prev;
 } tcache_perthread_struct;
 
 static const union
@@ -2962,6 +3062,50 @@ tcache_set_disabled (void)
 /* Process-wide key to try and catch a double-free in the same thread.  */
 static uintptr_t tcache_key;
 
+/* tcache_list_lock protects the list of the thread caches in use, and
+   the counters of the caches of exited threads.  */
+__libc_lock_define_initialized (static, tcache_list_lock);
+static tcache_perthread_struct *tcache_list;
+static size_t tcache_exited_hits[TCACHE_MAX_BINS];
+static size_t tcache_exited_misses[TCACHE_MAX_BINS];
+
+/* Count a request for bin TC_IDX which was served from the cache.  The
+   counters are only maintained if glibc.malloc.tcache_counters is set,
+   so that the fast paths do not store to them by default.  */
+static __always_inline void
+tcache_count_hit (size_t tc_idx)
+{
+  if (__glibc_unlikely (mp_.tcache_counters))
+    atomic_store_relaxed (&tcache->hits[tc_idx], tcache->hits[tc_idx] + 1);
+}
+
+/* Count a request for bin TC_IDX which was not served from the cache.  */
+static __always_inline void
+tcache_count_miss (size_t tc_idx)
+{
+  if (__glibc_unlikely (mp_.tcache_counters) && tcache_enabled ())
+    atomic_store_relaxed (&tcache->misses[tc_idx],
+			  tcache->misses[tc_idx] + 1);
+}
+
+/* Add the counters of the cache TC to those of the exited threads, and
+   remove it from tcache_list.  Called with tcache_list_lock held.  */
+static void
+tcache_list_remove (tcache_perthread_struct *tc)
+{
+  for (size_t i = 0; i < TCACHE_MAX_BINS; ++i)
+    {
+      tcache_exited_hits[i] += tc->hits[i];
+      tcache_exited_misses[i] += tc->misses[i];
+    }
+  if (tc->prev != NULL)
+    tc->prev->next = tc->next;
+  else
+    tcache_list = tc->next;
+  if (tc->next != NULL)
+    tc->next->prev = tc->prev;
+}
+
 /* The value of tcache_key does not really have to be a cryptographically
    secure random number.  It only needs to be arbitrary enough so that it does
    not collide with values present in applications.  If a collision does happen
@@ -3184,6 +3328,58 @@ tcache_double_free_verify (tcache_entry *e)
   __libc_free (e);
 }
 
+/* Return the least recently freed chunks of the full small bucket
+   TC_IDX to their arenas, keeping the most recently freed (and likely
+   cache-hot) ones.  Runs of chunks belonging to the same arena are
+   freed under a single acquisition of its lock.  */
+static __attribute_noinline__ void
+tcache_flush (size_t tc_idx)
+{
+  size_t count = MIN (mp_.tcache_flush_count, mp_.tcache_count);
+  size_t keep = mp_.tcache_count - count;
+
+  /* Find the link to the first chunk to flush and detach the tail of
+     the bucket there.  The head is not mangled, the links are.  */
+  tcache_entry **ep = &tcache->entries[tc_idx];
+  tcache_entry *e = *ep;
+  for (size_t i = 0; i < keep && e != NULL; ++i)
+    {
+      if (__glibc_unlikely (misaligned_mem (e)))
+	malloc_printerr ("free(): unaligned chunk detected in tcache 3");
+      ep = &e->next;
+      e = REVEAL_PTR (e->next);
+    }
+  if (ep == &tcache->entries[tc_idx])
+    *ep = NULL;
+  else
+    *ep = PROTECT_PTR (ep, (tcache_entry *) NULL);
+
+  mstate locked = NULL;
+  while (e != NULL)
+    {
+      if (__glibc_unlikely (misaligned_mem (e)))
+	malloc_printerr ("free(): unaligned chunk detected in tcache 3");
+      tcache_entry *next = REVEAL_PTR (e->next);
+      e->key = 0;
+      ++tcache->num_slots[tc_idx];
+
+      mchunkptr p = mem2chunk (e);
+      mstate av = arena_for_chunk (p);
+      if (!chunk_is_mmapped (p) && !SINGLE_THREAD_P && av != locked)
+	{
+	  if (locked != NULL)
+	    __libc_lock_unlock (locked->mutex);
+	  arena_mutex_lock (av);
+	  locked = av;
+	}
+      _int_free_chunk (av, p, chunksize (p), 1);
+      e = next;
+    }
+
+  if (locked != NULL)
+    __libc_lock_unlock (locked->mutex);
+}
+
 static void
 tcache_thread_shutdown (void)
 {
@@ -3197,6 +3393,10 @@ tcache_thread_shutdown (void)
   if (! need_free)
     return;
 
+  __libc_lock_lock (tcache_list_lock);
+  tcache_list_remove (tcache_tmp);
+  __libc_lock_unlock (tcache_list_lock);
+
   /* Free all of the entries and the tcache itself back to the arena
      heap for coalescing.  */
   for (i = 0; i < TCACHE_MAX_BINS; ++i)
@@ -3245,6 +3445,40 @@ tcache_init (mstate av)
       memset (tcache, 0, bytes);
       for (int i = 0; i < TCACHE_MAX_BINS; i++)
 	tcache->num_slots[i] = mp_.tcache_count;
+
+      __libc_lock_lock (tcache_list_lock);
+      tcache->next = tcache_list;
+      if (tcache_list != NULL)
+	tcache_list->prev = tcache;
+      tcache_list = tcache;
+      __libc_lock_unlock (tcache_list_lock);
+    }
+}
+
+static void
+tcache_fork_lock (void)
+{
+  __libc_lock_lock (tcache_list_lock);
+}
+
+static void
+tcache_fork_unlock_parent (void)
+{
+  __libc_lock_unlock (tcache_list_lock);
+}
+
+/* Only the cache of the thread which called fork is still in use.  */
+static void
+tcache_fork_unlock_child (void)
+{
+  __libc_lock_init (tcache_list_lock);
+  tcache_perthread_struct *tc = tcache_list;
+  while (tc != NULL)
+    {
+      tcache_perthread_struct *next = tc->next;
+      if (tc != tcache)
+	tcache_list_remove (tc);
+      tc = next;
     }
 }
 
@@ -3256,6 +3490,21 @@ tcache_thread_shutdown (void)
   /* Nothing to do if there is no thread cache.  */
 }
 
+static void
+tcache_fork_lock (void)
+{
+}
+
+static void
+tcache_fork_unlock_parent (void)
+{
+}
+
+static void
+tcache_fork_unlock_child (void)
+{
+}
+
 #endif /* !USE_TCACHE  */
 
 #if IS_IN (libc)
@@ -3299,6 +3548,16 @@ __libc_malloc2 (size_t bytes)
 void *
 __libc_malloc (size_t bytes)
 {
+  if (__glibc_unlikely (mp_.profile_rate != 0) && profile_sample_p (bytes))
+    return profile_malloc (bytes, false);
+
+  if (bytes < mp_.slab_max_bytes)
+    {
+      void *victim = slab_malloc (bytes);
+      if (__glibc_likely (victim != NULL))
+	return victim;
+    }
+
 #if USE_TCACHE
   size_t nb = checked_request2size (bytes);
 
@@ -3309,15 +3568,22 @@ __libc_malloc (size_t bytes)
       if (__glibc_likely (tc_idx < TCACHE_SMALL_BINS))
         {
 	  if (tcache->entries[tc_idx] != NULL)
-	    return tag_new_usable (tcache_get (tc_idx));
+	    {
+	      tcache_count_hit (tc_idx);
+	      return tag_new_usable (tcache_get (tc_idx));
+	    }
 	}
       else
         {
 	  tc_idx = large_csize2tidx (nb);
 	  void *victim = tcache_get_large (tc_idx, nb);
 	  if (victim != NULL)
-	    return tag_new_usable (victim);
+	    {
+	      tcache_count_hit (tc_idx);
+	      return tag_new_usable (victim);
+	    }
 	}
+      tcache_count_miss (tc_idx);
     }
 #endif
 
@@ -3340,6 +3606,9 @@ __libc_free (void *mem)
   if (mem == NULL)                              /* free(0) has no effect */
     return;
 
+  if (slab_contains (mem))
+    return slab_free (mem);
+
   /* Quickly check that the freed pointer matches the tag for the memory.
      This gives a useful double-free detection.  */
   if (__glibc_unlikely (mtag_enabled))
@@ -3355,6 +3624,9 @@ __libc_free (void *mem)
   if (__glibc_unlikely (misaligned_chunk (p)))
     return malloc_printerr_tail ("free(): invalid pointer");
 
+  if (__glibc_unlikely (mp_.profile_rate != 0) && chunk_is_mmapped (p))
+    profile_forget (mem);
+
 #if USE_TCACHE
   if (__glibc_likely (size < mp_.tcache_max_bytes))
     {
@@ -3370,6 +3642,14 @@ __libc_free (void *mem)
 	{
           if (__glibc_likely (tcache->num_slots[tc_idx] != 0))
 	    return tcache_put (p, tc_idx);
+
+	  /* The bucket is full.  Make room by returning a batch of
+	     chunks instead of freeing this one alone.  */
+	  if (mp_.tcache_flush_count != 0 && tcache_enabled ())
+	    {
+	      tcache_flush (tc_idx);
+	      return tcache_put (p, tc_idx);
+	    }
 	}
       else
 	{
@@ -3412,6 +3692,38 @@ __libc_realloc (void *oldmem, size_t bytes)
     }
 #endif
 
+  if (slab_contains (oldmem))
+    {
+      /* Slab objects do not grow in place.  */
+      size_t usable = slab_usable (oldmem, "realloc(): invalid pointer");
+      if (bytes <= usable)
+	return oldmem;
+      newp = __libc_malloc (bytes);
+      if (newp != NULL)
+	{
+	  memcpy (newp, oldmem, usable);
+	  slab_free (oldmem);
+	}
+      return newp;
+    }
+
+  if (__glibc_unlikely (mp_.profile_rate != 0)
+      && chunk_is_mmapped (mem2chunk (oldmem)) && profile_contains (oldmem))
+    {
+      /* Sampled blocks are not resized in place, so that their sample
+	 is removed by free.  */
+      size_t usable = musable (oldmem);
+      if (bytes <= usable)
+	return oldmem;
+      newp = __libc_malloc (bytes);
+      if (newp != NULL)
+	{
+	  memcpy (newp, oldmem, usable);
+	  __libc_free (oldmem);
+	}
+      return newp;
+    }
+
   /* Perform a quick check to ensure that the pointer's tag matches the
      memory's tag.  */
   if (__glibc_unlikely (mtag_enabled))
@@ -3456,7 +3768,19 @@ __libc_realloc (void *oldmem, size_t bytes)
       void *newmem;
 
 #if HAVE_MREMAP
-      newp = mremap_chunk (oldp, nb);
+      size_t request = nb;
+      if (__glibc_unlikely (mp_.realloc_mremap_threshold != 0)
+	  && nb >= mp_.realloc_mremap_threshold)
+	{
+	  /* Leave headroom for further growth, and keep it unless the
+	     block shrinks to less than half its size.  */
+	  if (nb > oldsize)
+	    request = nb + nb / 2;
+	  else if (nb >= oldsize / 2)
+	    return oldmem;
+	}
+
+      newp = mremap_chunk (oldp, request);
       if (newp)
 	{
 	  void *newmem = chunk2mem_tag (newp);
@@ -3493,7 +3817,7 @@ __libc_realloc (void *oldmem, size_t bytes)
       return newp;
     }
 
-  __libc_lock_lock (ar_ptr->mutex);
+  arena_mutex_lock (ar_ptr);
 
   newp = _int_realloc (ar_ptr, oldp, oldsize, nb);
 
@@ -3763,6 +4087,16 @@ __libc_calloc (size_t n, size_t elem_size)
        return NULL;
     }
 
+  if (__glibc_unlikely (mp_.profile_rate != 0) && profile_sample_p (bytes))
+    return profile_malloc (bytes, true);
+
+  if (bytes < mp_.slab_max_bytes)
+    {
+      void *mem = slab_malloc (bytes);
+      if (__glibc_likely (mem != NULL))
+	return memset (mem, 0, bytes);
+    }
+
 #if USE_TCACHE
   size_t nb = checked_request2size (bytes);
 
@@ -3774,6 +4108,7 @@ __libc_calloc (size_t n, size_t elem_size)
         {
 	  if (tcache->entries[tc_idx] != NULL)
 	    {
+	      tcache_count_hit (tc_idx);
 	      void *mem = tcache_get (tc_idx);
 	      if (__glibc_unlikely (mtag_enabled))
 		return tag_new_zero_region (mem, memsize (mem2chunk (mem)));
@@ -3787,12 +4122,14 @@ __libc_calloc (size_t n, size_t elem_size)
 	  void *mem = tcache_get_large (tc_idx, nb);
 	  if (mem != NULL)
 	    {
+	      tcache_count_hit (tc_idx);
 	      if (__glibc_unlikely (mtag_enabled))
 	        return tag_new_zero_region (mem, memsize (mem2chunk (mem)));
 
 	      return memset (mem, 0, memsize (mem2chunk (mem)));
 	    }
 	}
+      tcache_count_miss (tc_idx);
     }
 #endif
   return __libc_calloc2 (bytes);
@@ -3854,6 +4191,10 @@ _int_malloc (mstate av, size_t bytes)
       return p;
     }
 
+  /* Merge chunks other threads freed while we held the lock, so that
+     they can satisfy this request.  */
+  _int_free_remote_drain (av);
+
   /*
      If a small request, check regular bin.  Since these "smallbins"
      hold one size each, no searching within bins is necessary.
@@ -4331,6 +4672,25 @@ _int_malloc (mstate av, size_t bytes)
 
       if ((unsigned long) (size) >= (unsigned long) (nb + MINSIZE))
         {
+#if USE_TCACHE
+	  /* While we hold the lock, carve a batch of chunks of the same
+	     size for the tcache, so that the next misses do not need to
+	     lock the arena again.  The top chunk always has PREV_INUSE
+	     set, and so do the chunks carved from it.  */
+	  if (tcache_nb > 0)
+	    for (size_t n = mp_.tcache_refill_count;
+		 n > 0 && tcache->num_slots[tc_idx] != 0
+		 && (unsigned long) (size) >= (unsigned long) (2 * nb + MINSIZE);
+		 --n)
+	      {
+		mchunkptr tc_victim = victim;
+		victim = chunk_at_offset (tc_victim, nb);
+		size -= nb;
+		set_head (tc_victim, nb | PREV_INUSE |
+			  (av != &main_arena ? NON_MAIN_ARENA : 0));
+		tcache_put (tc_victim, tc_idx);
+	      }
+#endif
           remainder_size = size - nb;
           remainder = chunk_at_offset (victim, nb);
           av->top = remainder;
@@ -4376,18 +4736,40 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size, int have_lock)
     /* Preserve errno in case block merging results in munmap.  */
     int err = errno;
 
+    /* Whether the caller may hold other malloc locks.  */
+    bool called_locked = have_lock;
+
     /* If we're single-threaded, don't lock the arena.  */
     if (SINGLE_THREAD_P)
       have_lock = true;
 
     if (!have_lock)
-      __libc_lock_lock (av->mutex);
+      {
+	if (__glibc_unlikely (mp_.remote_free))
+	  {
+	    /* Do not wait for a busy arena: hand the chunk over to
+	       whichever thread owns the mutex next.  */
+	    if (__libc_lock_trylock (av->mutex) != 0)
+	      {
+		_int_free_remote_push (av, p);
+		return;
+	      }
+	  }
+	else
+	  arena_mutex_lock (av);
+      }
 
+    _int_free_remote_drain (av);
     _int_free_merge_chunk (av, p, size);
 
     if (!have_lock)
       __libc_lock_unlock (av->mutex);
 
+    /* Creating the trim thread allocates memory, so it is only done once
+       no arena lock is held.  */
+    if (!called_locked)
+      trim_thread_maybe_start ();
+
     __set_errno (err);
   }
   /*
@@ -4400,10 +4782,15 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size, int have_lock)
     int err = errno;
 
     /* See if the dynamic brk/mmap threshold needs adjusting.
-       Dumped fake mmapped chunks do not affect the threshold.  */
+       Dumped fake mmapped chunks do not affect the threshold, and
+       neither do chunks which realloc may have moved to their own
+       mappings regardless of the threshold (see
+       glibc.malloc.realloc_mremap_threshold).  */
     if (!mp_.no_dyn_threshold
         && chunksize_nomask (p) > mp_.mmap_threshold
-        && chunksize_nomask (p) <= DEFAULT_MMAP_THRESHOLD_MAX)
+        && chunksize_nomask (p) <= DEFAULT_MMAP_THRESHOLD_MAX
+        && (mp_.realloc_mremap_threshold == 0
+	    || chunksize_nomask (p) < mp_.realloc_mremap_threshold))
       {
         mp_.mmap_threshold = chunksize (p);
         mp_.trim_threshold = 2 * mp_.mmap_threshold;
@@ -4422,6 +4809,15 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size, int have_lock)
    bin list yet, and it can be in use.  */
 static void
 _int_free_merge_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
+{
+  size = _int_free_consolidate_chunk (av, p, size);
+  _int_free_maybe_trim (av, size);
+}
+
+/* Like _int_free_merge_chunk, but do not trim the arena.  Return the
+   size of the resulting chunk.  */
+static INTERNAL_SIZE_T
+_int_free_consolidate_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
 {
   mchunkptr nextchunk = chunk_at_offset(p, size);
 
@@ -4459,8 +4855,7 @@ _int_free_merge_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
     }
 
   /* Write the chunk header, maybe after merging with the following chunk.  */
-  size = _int_free_create_chunk (av, p, size, nextchunk, nextsize);
-  _int_free_maybe_trim (av, size);
+  return _int_free_create_chunk (av, p, size, nextchunk, nextsize);
 }
 
 /* Create a chunk at P of SIZE bytes, with SIZE potentially increased
@@ -4548,25 +4943,101 @@ _int_free_maybe_trim (mstate av, INTERNAL_SIZE_T size)
      if ATTEMPT_TRIMMING_THRESHOLD is reached.  */
   if (size >= ATTEMPT_TRIMMING_THRESHOLD)
     {
-      if (av == &main_arena)
-	{
+      /* Leave the system calls to the trim thread if requested.  */
+      if (__glibc_unlikely (mp_.trim_decay != 0) && trim_thread_defer (av))
+	return;
+
+      _int_trim (av);
+    }
+}
+
+/* Return unused memory at the top of AV to the system.  The arena mutex
+   must be held.  */
+static void
+_int_trim (mstate av)
+{
+  /* Chunks freed by other threads may border the top chunk.  */
+  _int_free_remote_merge (av);
+
+  if (av == &main_arena)
+    {
 #ifndef MORECORE_CANNOT_TRIM
-	  if (chunksize (av->top) >= mp_.trim_threshold)
-	    systrim (mp_.top_pad, av);
+      if (chunksize (av->top) >= mp_.trim_threshold)
+	systrim (mp_.top_pad, av);
 #endif
-	}
-      else
-	{
-	  /* Always try heap_trim, even if the top chunk is not large,
-	     because the corresponding heap might go away.  */
-	  heap_info *heap = heap_for_ptr (top (av));
+    }
+  else
+    {
+      /* Always try heap_trim, even if the top chunk is not large,
+	 because the corresponding heap might go away.  */
+      heap_info *heap = heap_for_ptr (top (av));
 
-	  assert (heap->ar_ptr == av);
-	  heap_trim (heap, mp_.top_pad);
-	}
+      assert (heap->ar_ptr == av);
+      heap_trim (heap, mp_.top_pad);
     }
 }
 
+/* Push in-use chunk P onto the remote free list of AV without taking
+   the arena mutex.  The chunk stays marked as in use until it is
+   drained, so it is not coalesced with its neighbors meanwhile.  */
+static void
+_int_free_remote_push (mstate av, mchunkptr p)
+{
+  mchunkptr head = atomic_load_relaxed (&av->remote_free);
+  do
+    {
+      /* Freeing the chunk at the head of the list again would turn the
+	 list into a cycle.  */
+      if (__glibc_unlikely (head == p))
+	malloc_printerr ("double free or corruption (remote)");
+      p->fd = PROTECT_PTR (&p->fd, head);
+    }
+  while (!atomic_compare_exchange_weak_release (&av->remote_free, &head, p));
+  LIBC_PROBE (memory_free_remote, 2, av, chunk2mem (p));
+}
+
+/* Free all chunks on the remote free list of AV, and return the size of
+   the largest resulting free chunk.  The arena mutex must be held.  Only
+   the mutex owner takes chunks off the list, and it takes all of them at
+   once, so the list does not suffer from ABA.
+   The chunks get the checks of __libc_free and _int_free_merge_chunk,
+   which usually catch a chunk which is on the list twice, because it is
+   no longer in use when it is reached again.  */
+static INTERNAL_SIZE_T
+_int_free_remote_merge (mstate av)
+{
+  if (__glibc_likely (atomic_load_relaxed (&av->remote_free) == NULL))
+    return 0;
+
+  mchunkptr p = atomic_exchange_acquire (&av->remote_free, NULL);
+  INTERNAL_SIZE_T largest = 0;
+  while (p != NULL)
+    {
+      if (__glibc_unlikely (misaligned_chunk (p)))
+	malloc_printerr ("free(): unaligned chunk detected in remote list");
+      INTERNAL_SIZE_T size = chunksize (p);
+      if (__glibc_unlikely (INT_ADD_OVERFLOW ((uintptr_t) p, size - MINSIZE)))
+	malloc_printerr ("free(): invalid size in remote list");
+      mchunkptr next = REVEAL_PTR (p->fd);
+      size = _int_free_consolidate_chunk (av, p, size);
+      if (size > largest)
+	largest = size;
+      p = next;
+    }
+  return largest;
+}
+
+/* Like _int_free_remote_merge, but also trim AV as free would.  Trimming
+   only depends on the top chunk, so it is attempted once for the whole
+   list.  */
+static void
+_int_free_remote_drain (mstate av)
+{
+  INTERNAL_SIZE_T largest = _int_free_remote_merge (av);
+  if (largest > 0)
+    _int_free_maybe_trim (av, largest);
+}
+
 /*
   ------------------------------ realloc ------------------------------
 */
@@ -4635,6 +5106,28 @@ _int_realloc (mstate av, mchunkptr oldp, INTERNAL_SIZE_T oldsize,
       /* allocate, copy, free */
       else
         {
+#if HAVE_MREMAP
+	  if (__glibc_unlikely (mp_.realloc_mremap_threshold != 0)
+	      && nb >= mp_.realloc_mremap_threshold
+	      && mp_.n_mmaps < mp_.n_mmaps_max)
+	    {
+	      /* The block has to be copied anyway.  Copy it once to a
+		 mapping with headroom, instead of whenever it outgrows its
+		 neighbors in the heap.  */
+	      newmem = sysmalloc_mmap (nb + nb / 2, GLRO (dl_pagesize), 0);
+	      if (newmem != MAP_FAILED)
+		{
+		  void *oldmem = chunk2mem (oldp);
+		  size_t sz = memsize (oldp);
+		  (void) tag_region (oldmem, sz);
+		  newmem = tag_new_usable (newmem);
+		  memcpy (newmem, oldmem, sz);
+		  _int_free_chunk (av, oldp, chunksize (oldp), 1);
+		  return newmem;
+		}
+	    }
+#endif
+
           newmem = _int_malloc (av, nb - MALLOC_ALIGN_MASK);
           if (newmem == NULL)
             return NULL; /* propagate failure */
@@ -4768,12 +5261,28 @@ _int_memalign (mstate av, size_t alignment, size_t bytes)
    ------------------------------ malloc_trim ------------------------------
  */
 
+/* Return the granularity in which mtrim gives the free chunk P of arena AV
+   back to the system.  Non-main arenas record the page size backing each
+   heap in new_heap; the main arena follows systrim.  */
+static size_t
+trim_pagesize (mstate av, mchunkptr p)
+{
+  if (av != &main_arena)
+    return heap_for_ptr (p)->pagesize;
+  if (mp_.thp_pagesize != 0
+      && (mp_.thp_mode == malloc_thp_mode_madvise
+	  || mp_.thp_mode == malloc_thp_mode_always))
+    return mp_.thp_pagesize;
+  return GLRO (dl_pagesize);
+}
+
 static int
 mtrim (mstate av, size_t pad)
 {
   const size_t ps = GLRO (dl_pagesize);
   int psindex = bin_index (ps);
-  const size_t psm1 = ps - 1;
+
+  _int_free_remote_drain (av);
 
   int result = 0;
   for (int i = 1; i < NBINS; ++i)
@@ -4784,10 +5293,14 @@ mtrim (mstate av, size_t pad)
         for (mchunkptr p = last (bin); p != bin; p = p->bk)
           {
             INTERNAL_SIZE_T size = chunksize (p);
+            const size_t psm1 = trim_pagesize (av, p) - 1;
 
             if (size > psm1 + sizeof (struct malloc_chunk))
               {
-                /* See whether the chunk contains at least one unused page.  */
+                /* See whether the chunk contains at least one unused page.
+                   For memory backed by huge pages, only whole huge pages are
+                   released: a partial MADV_DONTNEED would split a huge page
+                   whose remainder is still in use.  */
                 char *paligned_mem = (char *) (((uintptr_t) p
                                                 + sizeof (struct malloc_chunk)
                                                 + psm1) & ~psm1);
@@ -4807,6 +5320,7 @@ mtrim (mstate av, size_t pad)
                     memset (paligned_mem, 0x89, size & ~psm1);
 #endif
                     __madvise (paligned_mem, size & ~psm1, MADV_DONTNEED);
+                    arena_count (&av->trimmed_bytes, size & ~psm1);
 
                     result = 1;
                   }
@@ -4850,6 +5364,9 @@ __malloc_trim (size_t s)
 static size_t
 musable (void *mem)
 {
+  if (slab_contains (mem))
+    return slab_usable (mem, "malloc_usable_size(): invalid pointer");
+
   mchunkptr p = mem2chunk (mem);
 
   if (chunk_is_mmapped (p))
@@ -4883,6 +5400,7 @@ int_mallinfo (mstate av, struct mallinfo2 *m)
   INTERNAL_SIZE_T avail;
   int nblocks;
 
+  _int_free_remote_drain (av);
   check_malloc_state (av);
 
   /* Account for top */
@@ -5121,6 +5639,41 @@ do_set_tcache_unsorted_limit (size_t value)
   mp_.tcache_unsorted_limit = value;
   return 1;
 }
+
+static __always_inline int
+do_set_tcache_refill_count (size_t value)
+{
+  if (value <= MAX_TCACHE_COUNT)
+    {
+      LIBC_PROBE (memory_tunable_tcache_refill_count, 2, value,
+		  mp_.tcache_refill_count);
+      mp_.tcache_refill_count = value;
+      return 1;
+    }
+  return 0;
+}
+
+static __always_inline int
+do_set_tcache_flush_count (size_t value)
+{
+  if (value <= MAX_TCACHE_COUNT)
+    {
+      LIBC_PROBE (memory_tunable_tcache_flush_count, 2, value,
+		  mp_.tcache_flush_count);
+      mp_.tcache_flush_count = value;
+      return 1;
+    }
+  return 0;
+}
+
+static __always_inline int
+do_set_tcache_counters (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_tcache_counters, 2, value,
+	      mp_.tcache_counters);
+  mp_.tcache_counters = value;
+  return 1;
+}
 #endif
 
 static __always_inline int
@@ -5129,6 +5682,58 @@ do_set_mxfast (size_t value)
   return 1;
 }
 
+static __always_inline int
+do_set_percpu_arena (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_percpu_arena, 2, value, mp_.percpu_arena);
+  mp_.percpu_arena = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_remote_free (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_remote_free, 2, value, mp_.remote_free);
+  mp_.remote_free = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_trim_decay (size_t value)
+{
+  LIBC_PROBE (memory_tunable_trim_decay, 2, value, mp_.trim_decay);
+  mp_.trim_decay = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_slab_max (size_t value)
+{
+  if (value > SLAB_MAX_SIZE)
+    return 0;
+
+  LIBC_PROBE (memory_tunable_slab_max, 2, value, mp_.slab_max_bytes);
+  mp_.slab_max_bytes = value == 0 ? 0 : value + 1;
+  return 1;
+}
+
+static __always_inline int
+do_set_profile_rate (size_t value)
+{
+  LIBC_PROBE (memory_tunable_profile_rate, 2, value, mp_.profile_rate);
+  mp_.profile_rate = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_realloc_mremap_threshold (size_t value)
+{
+  LIBC_PROBE (memory_tunable_realloc_mremap_threshold, 2, value,
+	      mp_.realloc_mremap_threshold);
+  mp_.realloc_mremap_threshold = value;
+  return 1;
+}
+
 static __always_inline int
 do_set_hugetlb (size_t value)
 {
@@ -5441,6 +6046,7 @@ __malloc_info (int options, FILE *fp)
 #define nsizes (sizeof (sizes) / sizeof (sizes[0]))
 
       __libc_lock_lock (ar_ptr->mutex);
+      _int_free_remote_drain (ar_ptr);
 
       /* Account for top chunk.  The top-most available chunk is
 	 treated specially and is never in any bin. See "initial_top"
@@ -5548,6 +6154,8 @@ __malloc_info (int options, FILE *fp)
     }
   while (ar_ptr != &main_arena);
 
+  slab_info (fp);
+
   fprintf (fp,
 	   "<total type=\"rest\" count=\"%zu\" size=\"%zu\"/>\n"
 	   "<total type=\"mmap\" count=\"%d\" size=\"%zu\"/>\n"
@@ -5566,6 +6174,114 @@ __malloc_info (int options, FILE *fp)
 #if IS_IN (libc)
 weak_alias (__malloc_info, malloc_info)
 
+int
+__malloc_profile_dump (FILE *fp)
+{
+  struct profile_sample *samples;
+  size_t mapsize, live_bytes, total_count, total_bytes;
+  size_t count = profile_snapshot (&samples, &mapsize, &live_bytes,
+				   &total_count, &total_bytes);
+
+  /* Use the format of gperftools heap profiles, with one line per live
+     sample.  pprof scales the counts by the sampling rate given in the
+     header.  */
+  fprintf (fp, "heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+	   count, live_bytes, total_count, total_bytes, mp_.profile_rate);
+  for (size_t i = 0; i < count; ++i)
+    {
+      fprintf (fp, "1: %zu [1: %zu] @", samples[i].size, samples[i].size);
+      for (int j = 0; j < samples[i].depth; ++j)
+	fprintf (fp, " %p", samples[i].frames[j]);
+      fputs ("\n", fp);
+    }
+  if (samples != NULL)
+    __munmap (samples, mapsize);
+
+  /* pprof needs the mappings to symbolize the addresses.  */
+  fputs ("\nMAPPED_LIBRARIES:\n", fp);
+  int fd = __open_nocancel ("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (fd >= 0)
+    {
+      char buf[1024];
+      ssize_t n;
+      while ((n = __read_nocancel (fd, buf, sizeof (buf))) > 0)
+	fwrite (buf, 1, n, fp);
+      __close_nocancel_nostatus (fd);
+    }
+
+  return 0;
+}
+weak_alias (__malloc_profile_dump, malloc_profile_dump)
+
+int
+__malloc_counters (int arena, struct malloc_counters *counters, size_t size)
+{
+  struct malloc_counters c;
+  memset (&c, 0, sizeof (c));
+
+  /* The counters are read without taking any lock the allocator uses
+     itself, so the result is not an atomic snapshot.  */
+  bool found = false;
+  mstate ar_ptr = &main_arena;
+  do
+    {
+      if (arena < 0 || arena == ar_ptr->id)
+	{
+	  c.arena_lock_waits += atomic_load_relaxed (&ar_ptr->lock_waits);
+	  c.sysmalloc_calls += atomic_load_relaxed (&ar_ptr->sysmalloc_calls);
+	  c.trimmed_bytes += atomic_load_relaxed (&ar_ptr->trimmed_bytes);
+	  found = true;
+	}
+      ar_ptr = ar_ptr->next;
+    }
+  while (ar_ptr != &main_arena);
+
+  if (!found)
+    {
+      __set_errno (ENOENT);
+      return -1;
+    }
+
+  if (arena < 0)
+    {
+      c.mmapped_chunks = atomic_load_relaxed (&mp_.mmapped_chunks);
+
+      size_t hits[TCACHE_MAX_BINS];
+      size_t misses[TCACHE_MAX_BINS];
+      __libc_lock_lock (tcache_list_lock);
+      memcpy (hits, tcache_exited_hits, sizeof (hits));
+      memcpy (misses, tcache_exited_misses, sizeof (misses));
+      for (tcache_perthread_struct *tc = tcache_list; tc != NULL;
+	   tc = tc->next)
+	for (size_t i = 0; i < TCACHE_MAX_BINS; ++i)
+	  {
+	    hits[i] += atomic_load_relaxed (&tc->hits[i]);
+	    misses[i] += atomic_load_relaxed (&tc->misses[i]);
+	  }
+      __libc_lock_unlock (tcache_list_lock);
+
+      for (size_t i = 0; i < TCACHE_MAX_BINS; ++i)
+	{
+	  c.tcache_hits += hits[i];
+	  c.tcache_misses += misses[i];
+	}
+      for (size_t i = 0; i < MALLOC_COUNTERS_CLASSES
+			 && i < TCACHE_SMALL_BINS; ++i)
+	{
+	  c.class_hits[i] = hits[i];
+	  c.class_misses[i] = misses[i];
+	}
+    }
+
+  for (size_t i = 0; i < MALLOC_COUNTERS_CLASSES && i < TCACHE_SMALL_BINS;
+       ++i)
+    c.class_size[i] = tidx2usize (i);
+
+  memcpy (counters, &c, MIN (size, sizeof (c)));
+  return 0;
+}
+weak_alias (__malloc_counters, malloc_counters)
+
 strong_alias (__libc_calloc, __calloc) weak_alias (__libc_calloc, calloc)
 strong_alias (__libc_free, __free) strong_alias (__libc_free, free)
 strong_alias (__libc_malloc, __malloc) strong_alias (__libc_malloc, malloc)
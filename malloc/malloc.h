@@ -157,5 +157,34 @@ extern void malloc_stats (void) __THROW;
 /* Output information about state of allocator to stream FP.  */
 extern int malloc_info (int __options, FILE *__fp) __THROW;
 
+/* Write the live allocations sampled by the heap profiler to stream FP,
+   in the format of gperftools heap profiles.  */
+extern int malloc_profile_dump (FILE *__fp) __THROW;
+
+/* Number of size classes in struct malloc_counters.  */
+#define MALLOC_COUNTERS_CLASSES 64
+
+/* Event counters of the allocator, returned by malloc_counters.  */
+struct malloc_counters
+{
+  size_t tcache_hits;        /* requests served from per-thread caches */
+  size_t tcache_misses;      /* requests of cached sizes not served so */
+  size_t arena_lock_waits;   /* arena lock acquisitions which waited */
+  size_t sysmalloc_calls;    /* requests which needed memory from the system */
+  size_t mmapped_chunks;     /* blocks allocated with mmap */
+  size_t trimmed_bytes;      /* memory returned to the system */
+  /* Largest request of each size class of the per-thread caches, and the
+     hits and misses for the class.  Unused classes have size 0.  */
+  size_t class_size[MALLOC_COUNTERS_CLASSES];
+  size_t class_hits[MALLOC_COUNTERS_CLASSES];
+  size_t class_misses[MALLOC_COUNTERS_CLASSES];
+};
+
+/* Store the counters of the arena with index ARENA, or the totals for
+   all arenas and threads if ARENA is negative, in the first SIZE bytes
+   of *COUNTERS.  */
+extern int malloc_counters (int __arena, struct malloc_counters *__counters,
+			    size_t __size) __THROW;
+
 __END_DECLS
 #endif /* malloc.h */
@@ -0,0 +1,503 @@
+/* Sampling heap profiler.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* If glibc.malloc.profile_rate is set, malloc and calloc sample on
+   average one allocation per profile_rate bytes requested.  Each thread
+   counts down the bytes until its next sample; the distance between two
+   samples is drawn from an exponential distribution, so that every byte
+   has the same chance of being sampled regardless of the allocation
+   pattern.  Unsampled allocations only pay for the decrement.
+
+   Sampled allocations are always served by mmap, so that free and
+   realloc need to look for them in the sample table only for mmapped
+   chunks.  The table records the requested size and the stack trace of
+   each live sample.  malloc_profile_dump writes it in the text format of
+   gperftools heap profiles, which pprof reads.
+
+   Sampling starts in ptmalloc_init.  The stack trace is taken with
+   backtrace, which loads libgcc_s on first use.  This cannot be done
+   while the dynamic loader is adding or removing objects in any
+   namespace, during startup or in dlopen and dlclose, because the
+   sampled allocation may come from the loader itself, so the state of
+   all namespaces is checked under dl_load_lock until libgcc_s is loaded.
+   Samples taken before libgcc_s could be loaded have an empty stack
+   trace.  The profiler is not available in static programs, to avoid
+   linking the unwinder into all of them.
+
+   free and realloc take the lock of the sample table only if the bucket
+   of the mmapped chunk is not empty.  */
+
+#define PROFILE_MAX_DEPTH 32
+#define PROFILE_BUCKETS 4096
+#define PROFILE_POOL_SIZE (64 * 1024)
+
+#if IS_IN (libc) && defined SHARED
+
+#include <execinfo.h>
+
+struct profile_sample
+{
+  struct profile_sample *next;
+  void *mem;
+  /* Requested size.  */
+  size_t size;
+  int depth;
+  void *frames[PROFILE_MAX_DEPTH];
+};
+
+/* profile_lock protects the following variables.  */
+__libc_lock_define_initialized (static, profile_lock);
+/* Hash table of live samples, indexed by profile_hash.  Allocated on
+   first use.  */
+static struct profile_sample **profile_table;
+/* Unused records, linked through their next member.  */
+static struct profile_sample *profile_free_records;
+/* Live samples, and all samples taken since startup.  */
+static size_t profile_live_count;
+static size_t profile_live_bytes;
+static size_t profile_total_count;
+static size_t profile_total_bytes;
+
+/* Set to 1 once backtrace has loaded the unwinder.  */
+static int profile_ready;
+
+/* Bytes which may still be requested before the next sample, or 0 if
+   the thread has not computed its first sampling distance yet.  */
+static __thread size_t profile_bytes_left;
+/* State of the random number generator for the sampling distances.  */
+static __thread uint64_t profile_rng;
+/* True while the thread is in the profiler, which must not sample its
+   own allocations.  */
+static __thread bool profile_busy;
+
+static void * __libc_malloc2 (size_t bytes);
+static void * __libc_calloc2 (size_t sz);
+static void *sysmalloc_mmap (INTERNAL_SIZE_T nb, size_t pagesize,
+			     int extra_flags);
+
+/* Return the number of bytes to the next sample: profile_rate times an
+   exponentially distributed random variable with mean 1, which is
+   -ln (u) for u uniformly distributed in (0, 1].  The computations use
+   16.16 fixed point numbers.  */
+static size_t
+profile_next_distance (void)
+{
+  if (profile_rng == 0)
+    profile_rng = random_bits () | 1;
+  profile_rng = (profile_rng * 0x5deece66dULL + 0xb) & ((1ULL << 48) - 1);
+
+  /* Q is in [1, 2^26], so u = Q / 2^26.  */
+  uint64_t q = (profile_rng >> 22) + 1;
+  unsigned int e = stdc_bit_width (q) - 1;
+  uint64_t f = ((q << 16) >> e) - (1 << 16);
+  /* log2 (1 + x) is approximately x * (1.3465 - 0.3465 * x) for x in
+     [0, 1), which is precise enough for sampling.  */
+  uint64_t log2q = ((uint64_t) e << 16)
+		   + ((f * (88244 - ((22708 * f) >> 16))) >> 16);
+  /* -ln (u) = (26 - log2 (Q)) * ln (2).  */
+  uint64_t minus_ln_u = (((26ULL << 16) - log2q) * 45426) >> 16;
+
+  size_t distance;
+  if (__builtin_mul_overflow (minus_ln_u, mp_.profile_rate, &distance))
+    return SIZE_MAX;
+  return (distance >> 16) + 1;
+}
+
+static bool __attribute_noinline__
+profile_sample_slow (size_t bytes)
+{
+  if (profile_bytes_left == 0)
+    {
+      /* First allocation of this thread.  */
+      profile_bytes_left = profile_next_distance ();
+      if (profile_bytes_left > bytes)
+	{
+	  profile_bytes_left -= bytes;
+	  return false;
+	}
+    }
+
+  profile_bytes_left = profile_next_distance ();
+  return !profile_busy;
+}
+
+/* Return true if an allocation of BYTES is to be sampled.  Called only
+   if mp_.profile_rate is not 0.  */
+static __always_inline bool
+profile_sample_p (size_t bytes)
+{
+  if (__glibc_likely (profile_bytes_left > bytes))
+    {
+      profile_bytes_left -= bytes;
+      return false;
+    }
+  return profile_sample_slow (bytes);
+}
+
+static __always_inline size_t
+profile_hash (void *mem)
+{
+  return ((uint32_t) ((uintptr_t) mem >> 12) * 2654435761U)
+	 % PROFILE_BUCKETS;
+}
+
+/* Allocate the hash table or more records.  Called with profile_lock
+   held.  Return false on failure.  */
+static bool
+profile_grow (void)
+{
+  if (profile_table == NULL)
+    {
+      void *p = MMAP (NULL, PROFILE_BUCKETS * sizeof (*profile_table),
+		      PROT_READ | PROT_WRITE, 0);
+      if (p == MAP_FAILED)
+	return false;
+      __set_vma_name (p, PROFILE_BUCKETS * sizeof (*profile_table),
+		      " glibc: malloc profile");
+      /* Release MO for profile_maybe_sampled.  */
+      atomic_store_release (&profile_table, p);
+    }
+
+  if (profile_free_records == NULL)
+    {
+      struct profile_sample *s = MMAP (NULL, PROFILE_POOL_SIZE,
+				       PROT_READ | PROT_WRITE, 0);
+      if (s == MAP_FAILED)
+	return false;
+      __set_vma_name (s, PROFILE_POOL_SIZE, " glibc: malloc profile");
+      for (size_t i = 0; i < PROFILE_POOL_SIZE / sizeof (*s); ++i)
+	{
+	  s[i].next = profile_free_records;
+	  profile_free_records = &s[i];
+	}
+    }
+
+  return true;
+}
+
+/* Called from ptmalloc_init once the tunables have been read.  Allocate
+   the sample table up front, so that the first samples do not have to.  */
+static void
+profile_init (void)
+{
+  if (mp_.profile_rate == 0)
+    return;
+
+  __libc_lock_lock (profile_lock);
+  profile_grow ();
+  __libc_lock_unlock (profile_lock);
+}
+
+/* Return true if no object is being added or removed in any namespace,
+   and the calling thread is not inside the dynamic loader.  */
+static bool
+profile_loader_idle (void)
+{
+  /* The loader allocates memory while it holds dl_load_lock, which is
+     recursive, so the calling thread must not be the owner.  */
+  if (atomic_load_relaxed (&GL(dl_load_lock).mutex.__data.__owner)
+      == THREAD_GETMEM (THREAD_SELF, tid))
+    return false;
+
+  bool idle = true;
+  __rtld_lock_lock_recursive (GL(dl_load_lock));
+  /* With r_version 2, _r_debug starts the list of the r_debug structures
+     of all namespaces.  A copy of _r_debug in the main program has
+     r_version 1 and only covers the base namespace.  */
+  struct r_debug_extended *r = (struct r_debug_extended *) &_r_debug;
+  bool extended = r->base.r_version >= 2;
+  for (; r != NULL; r = extended ? r->r_next : NULL)
+    if (atomic_load_relaxed (&r->base.r_state) != RT_CONSISTENT)
+      {
+	idle = false;
+	break;
+      }
+  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+  return idle;
+}
+
+/* Store the stack trace of the caller in FRAMES like backtrace, or
+   return 0 if the unwinder is not loaded yet and cannot be loaded
+   now.  */
+static int
+profile_backtrace (void **frames, int size)
+{
+  if (atomic_load_acquire (&profile_ready) == 0)
+    {
+      if (!profile_loader_idle ())
+	return 0;
+      atomic_store_release (&profile_ready, 1);
+    }
+  return __backtrace (frames, size);
+}
+
+/* Return false if MEM is certainly not sampled, without taking
+   profile_lock.  A sample of MEM was inserted before MEM was returned to
+   the application, and thus before MEM is freed, so its bucket cannot be
+   seen empty.  */
+static __always_inline bool
+profile_maybe_sampled (void *mem)
+{
+  /* Acquire MO to see the table initialized.  */
+  struct profile_sample **table = atomic_load_acquire (&profile_table);
+  return (table != NULL
+	  && atomic_load_relaxed (&table[profile_hash (mem)]) != NULL);
+}
+
+static void
+profile_insert (void *mem, size_t bytes, void **frames, int depth)
+{
+  __libc_lock_lock (profile_lock);
+  if (profile_grow ())
+    {
+      struct profile_sample *s = profile_free_records;
+      profile_free_records = s->next;
+      s->mem = mem;
+      s->size = bytes;
+      s->depth = depth;
+      memcpy (s->frames, frames, depth * sizeof (*frames));
+
+      size_t h = profile_hash (mem);
+      s->next = profile_table[h];
+      atomic_store_relaxed (&profile_table[h], s);
+
+      ++profile_live_count;
+      profile_live_bytes += bytes;
+      ++profile_total_count;
+      profile_total_bytes += bytes;
+    }
+  __libc_lock_unlock (profile_lock);
+}
+
+/* Remove the sample of MEM, an mmapped chunk, if there is one.  Return
+   true if MEM was sampled.  */
+static bool
+profile_forget (void *mem)
+{
+  bool found = false;
+
+  if (!profile_maybe_sampled (mem))
+    return false;
+
+  __libc_lock_lock (profile_lock);
+  for (struct profile_sample **sp = &profile_table[profile_hash (mem)];
+       *sp != NULL; sp = &(*sp)->next)
+    if ((*sp)->mem == mem)
+      {
+	struct profile_sample *s = *sp;
+	atomic_store_relaxed (sp, s->next);
+	s->next = profile_free_records;
+	profile_free_records = s;
+
+	--profile_live_count;
+	profile_live_bytes -= s->size;
+	found = true;
+	break;
+      }
+  __libc_lock_unlock (profile_lock);
+
+  return found;
+}
+
+/* Return true if MEM, an mmapped chunk, is sampled.  */
+static bool
+profile_contains (void *mem)
+{
+  bool found = false;
+
+  if (!profile_maybe_sampled (mem))
+    return false;
+
+  __libc_lock_lock (profile_lock);
+  for (struct profile_sample *s = profile_table[profile_hash (mem)];
+       s != NULL; s = s->next)
+    if (s->mem == mem)
+      {
+	found = true;
+	break;
+      }
+  __libc_lock_unlock (profile_lock);
+
+  return found;
+}
+
+/* Allocate a sampled block of BYTES, cleared if ZERO.  */
+static void * __attribute_noinline__
+profile_malloc (size_t bytes, bool zero)
+{
+  void *frames[PROFILE_MAX_DEPTH + 1];
+  void *mem = NULL;
+
+  profile_busy = true;
+
+  size_t nb = checked_request2size (bytes);
+  if (nb != SIZE_MAX && mp_.n_mmaps < mp_.n_mmaps_max)
+    {
+      mem = sysmalloc_mmap (nb, GLRO (dl_pagesize), 0);
+      if (mem == MAP_FAILED)
+	mem = NULL;
+    }
+
+  if (mem != NULL)
+    {
+      /* Skip the frame of this function.  */
+      int depth = profile_backtrace (frames, PROFILE_MAX_DEPTH + 1) - 1;
+      if (depth < 0)
+	depth = 0;
+      profile_insert (mem, bytes, frames + 1, depth);
+      /* The mapping is already cleared.  */
+      if (zero && __glibc_unlikely (mtag_enabled))
+	mem = tag_new_zero_region (mem, memsize (mem2chunk (mem)));
+      else
+	mem = tag_new_usable (mem);
+    }
+  else
+    /* Fall back to an unsampled allocation.  */
+    mem = zero ? __libc_calloc2 (bytes) : __libc_malloc2 (bytes);
+
+  profile_busy = false;
+  return mem;
+}
+
+static void
+profile_fork_lock (void)
+{
+  __libc_lock_lock (profile_lock);
+}
+
+static void
+profile_fork_unlock_parent (void)
+{
+  __libc_lock_unlock (profile_lock);
+}
+
+static void
+profile_fork_unlock_child (void)
+{
+  __libc_lock_init (profile_lock);
+}
+
+/* Copy the live samples to a new mapping.  Return the number of
+   samples, and the size of the mapping in *MAPSIZE, or return 0 if
+   there is none.  */
+static size_t
+profile_snapshot (struct profile_sample **result, size_t *mapsize,
+		  size_t *live_bytes, size_t *total_count,
+		  size_t *total_bytes)
+{
+  size_t count = 0;
+  *result = NULL;
+  *mapsize = 0;
+
+  __libc_lock_lock (profile_lock);
+  *live_bytes = profile_live_bytes;
+  *total_count = profile_total_count;
+  *total_bytes = profile_total_bytes;
+  if (profile_live_count > 0)
+    {
+      size_t size = ALIGN_UP (profile_live_count * sizeof (**result),
+			      GLRO (dl_pagesize));
+      struct profile_sample *copy = MMAP (NULL, size,
+					  PROT_READ | PROT_WRITE, 0);
+      if (copy != MAP_FAILED)
+	{
+	  for (size_t h = 0; h < PROFILE_BUCKETS; ++h)
+	    for (struct profile_sample *s = profile_table[h]; s != NULL;
+		 s = s->next)
+	      copy[count++] = *s;
+	  *result = copy;
+	  *mapsize = size;
+	}
+      else
+	*live_bytes = 0;
+    }
+  __libc_lock_unlock (profile_lock);
+
+  return count;
+}
+
+#else /* !(IS_IN (libc) && defined SHARED) */
+
+/* The copy of malloc in libc_malloc_debug and static programs do not
+   sample allocations.  */
+
+struct profile_sample
+{
+  void *mem;
+  size_t size;
+  int depth;
+  void *frames[PROFILE_MAX_DEPTH];
+};
+
+static void
+profile_init (void)
+{
+  mp_.profile_rate = 0;
+}
+
+static __always_inline bool
+profile_sample_p (size_t bytes)
+{
+  return false;
+}
+
+static __always_inline void *
+profile_malloc (size_t bytes, bool zero)
+{
+  __builtin_unreachable ();
+}
+
+static __always_inline bool
+profile_forget (void *mem)
+{
+  return false;
+}
+
+static __always_inline bool
+profile_contains (void *mem)
+{
+  return false;
+}
+
+static void
+profile_fork_lock (void)
+{
+}
+
+static void
+profile_fork_unlock_parent (void)
+{
+}
+
+static void
+profile_fork_unlock_child (void)
+{
+}
+
+static __always_inline size_t
+profile_snapshot (struct profile_sample **result, size_t *mapsize,
+		  size_t *live_bytes, size_t *total_count,
+		  size_t *total_bytes)
+{
+  *result = NULL;
+  *mapsize = 0;
+  *live_bytes = *total_count = *total_bytes = 0;
+  return 0;
+}
+
+#endif /* !(IS_IN (libc) && defined SHARED) */
@@ -0,0 +1,709 @@
+/* Slab allocator for small objects.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* If glibc.malloc.slab_max is set, requests up to that size are served
+   from slabs instead of chunks.  A slab is a SLAB_SIZE block holding
+   objects of a single size class, which is a multiple of
+   MALLOC_ALIGNMENT.  Objects have no chunk header: the metadata of each
+   slab is kept out of line in an array of struct slab, so that objects
+   of the same size are packed densely.
+
+   All slabs live in one region of address space reserved at startup,
+   which starts with the slab descriptors.  free recognizes slab objects
+   by their address, and finds the descriptor by the slab index.  Parts
+   of the region are made accessible SLAB_EXTENT slabs at a time.  If the
+   region is exhausted, requests fall back to chunks.
+
+   Each size class has a lock and a list of slabs with free objects.
+   Threads cache up to SLAB_CACHE_COUNT objects per size class, and move
+   SLAB_CACHE_BATCH objects at a time between their cache and the slabs,
+   so that the class locks are taken rarely.  Slabs which become empty are
+   returned to the system, except the last one of their class.  */
+
+#define SLAB_SIZE (16 * 1024)
+#define SLAB_MAX_SIZE 256
+#define SLAB_NCLASSES (SLAB_MAX_SIZE / MALLOC_ALIGNMENT)
+
+#if __WORDSIZE == 64
+# define SLAB_REGION_SIZE ((size_t) 4 << 30)
+#else
+# define SLAB_REGION_SIZE ((size_t) 64 << 20)
+#endif
+#define SLAB_EXTENT 64
+
+#define SLAB_CACHE_COUNT 32
+#define SLAB_CACHE_BATCH 16
+
+#if IS_IN (libc)
+
+/* Free objects are linked through their first word, which is mangled
+   like the tcache links.  The second word holds slab_key, to detect
+   double frees like the key of tcache entries.  Objects are at least
+   MALLOC_ALIGNMENT bytes large, so both words fit.  */
+typedef struct slab_object
+{
+  struct slab_object *next;
+  uintptr_t key;
+} slab_object;
+
+struct slab
+{
+  /* Neighbors on the list of slabs with free objects of the class, or
+     on the list of released slabs.  */
+  struct slab *next;
+  struct slab *prev;
+  /* Objects freed to this slab.  */
+  slab_object *free;
+  /* Objects never handed out start here.  */
+  char *unused;
+  /* Number of objects handed out, including those in thread caches.  */
+  unsigned int used;
+  /* Size class of the objects.  */
+  unsigned int cls;
+  /* True if the slab is on the list of its class.  */
+  bool listed;
+};
+
+struct slab_class
+{
+  __libc_lock_define (, lock);
+  /* Slabs with free objects.  */
+  struct slab *partial;
+  /* Statistics for malloc_info.  */
+  size_t nslabs;
+  size_t used;
+};
+
+static struct slab_class slab_classes[SLAB_NCLASSES];
+
+/* The slab region.  These variables are set by slab_init while the
+   process is still single-threaded, and never change afterwards.  If
+   slab_region_size is 0, there are no slabs.  */
+static char *slab_base;
+static size_t slab_region_size;
+#define slab_descs ((struct slab *) slab_base)
+/* Index of the first slab after the descriptors.  */
+static size_t slab_first;
+/* Value of the key member of free objects.  */
+static uintptr_t slab_key;
+
+/* slab_lock protects the following variables.  It is acquired after the
+   class locks.  */
+__libc_lock_define_initialized (static, slab_lock);
+/* Index of the first slab never used.  */
+static size_t slab_next;
+/* Index of the first slab which is not accessible yet.  */
+static size_t slab_committed;
+/* Released slabs, linked through their next member.  */
+static struct slab *slab_released;
+
+/* Per-thread cache, analogous to the tcache: NUM_SLOTS is the number of
+   objects which may still be added for a class.  */
+typedef struct slab_cache
+{
+  uint16_t num_slots[SLAB_NCLASSES];
+  slab_object *entries[SLAB_NCLASSES];
+} slab_cache;
+
+static const union
+{
+  struct slab_cache inactive;
+  struct
+  {
+    char pad;
+    struct slab_cache disabled;
+  };
+} __slab_cache_dummy;
+
+static __thread slab_cache *slab_tcache =
+  (slab_cache *) &__slab_cache_dummy.inactive;
+
+static __always_inline bool
+slab_contains (void *mem)
+{
+  return (uintptr_t) mem - (uintptr_t) slab_base < slab_region_size;
+}
+
+static __always_inline size_t
+slab_class_index (size_t bytes)
+{
+  return bytes == 0 ? 0 : (bytes - 1) / MALLOC_ALIGNMENT;
+}
+
+static __always_inline size_t
+slab_class_size (size_t cls)
+{
+  return (cls + 1) * MALLOC_ALIGNMENT;
+}
+
+static __always_inline size_t
+slab_index (void *mem)
+{
+  return ((char *) mem - slab_base) / SLAB_SIZE;
+}
+
+/* Return the descriptor of the slab containing MEM, which is a pointer
+   passed to FUNCTION.  */
+static __always_inline struct slab *
+slab_desc (void *mem, const char *function)
+{
+  /* The descriptors are not followed by slabs of their own.  */
+  size_t idx = slab_index (mem);
+  if (__glibc_unlikely (idx < slab_first))
+    malloc_printerr (function);
+  return &slab_descs[idx];
+}
+
+static __always_inline char *
+slab_start (struct slab *s)
+{
+  return slab_base + (s - slab_descs) * SLAB_SIZE;
+}
+
+/* Reserve the slab region.  Called from ptmalloc_init.  */
+static void
+slab_init (void)
+{
+  if (mp_.slab_max_bytes == 0)
+    return;
+
+  /* Objects have no room for tags.  */
+  if (mtag_enabled)
+    {
+      mp_.slab_max_bytes = 0;
+      return;
+    }
+
+  char *base = (char *) MMAP (NULL, SLAB_REGION_SIZE, PROT_NONE,
+			      MAP_NORESERVE);
+  if (base == MAP_FAILED)
+    {
+      mp_.slab_max_bytes = 0;
+      return;
+    }
+
+  for (size_t i = 0; i < SLAB_NCLASSES; ++i)
+    __libc_lock_init (slab_classes[i].lock);
+
+  /* As for tcache_key, the key only has to be unlikely to occur in
+     application data.  */
+  if (__getrandom_nocancel_nostatus_direct (&slab_key, sizeof (slab_key),
+					    GRND_NONBLOCK)
+      != sizeof (slab_key))
+    {
+      slab_key = random_bits ();
+#if __WORDSIZE == 64
+      slab_key = (slab_key << 32) | random_bits ();
+#endif
+    }
+  /* Objects handed out have a zero key.  */
+  slab_key |= 1;
+
+  /* The slabs must start at a page boundary, so that slab_commit can
+     change their protection.  */
+  size_t descs_size = ALIGN_UP (SLAB_REGION_SIZE / SLAB_SIZE
+				* sizeof (struct slab),
+				MAX (SLAB_SIZE, GLRO (dl_pagesize)));
+  slab_first = descs_size / SLAB_SIZE;
+  slab_next = slab_first;
+  slab_committed = slab_first;
+  slab_base = base;
+  slab_region_size = SLAB_REGION_SIZE;
+}
+
+/* Make SLAB_EXTENT more slabs and their descriptors accessible.  Must
+   be called with slab_lock held.  */
+static bool
+slab_commit (void)
+{
+  size_t end = slab_committed + SLAB_EXTENT;
+  if (end > SLAB_REGION_SIZE / SLAB_SIZE)
+    return false;
+
+  const size_t ps = GLRO (dl_pagesize);
+  char *start = slab_base + slab_committed * SLAB_SIZE;
+  char *descs = PTR_ALIGN_DOWN ((char *) &slab_descs[slab_committed], ps);
+  char *descs_end = PTR_ALIGN_UP ((char *) &slab_descs[end], ps);
+  if (__mprotect (start, SLAB_EXTENT * SLAB_SIZE, PROT_READ | PROT_WRITE) != 0
+      || __mprotect (descs, descs_end - descs, PROT_READ | PROT_WRITE) != 0)
+    return false;
+  __set_vma_name (start, SLAB_EXTENT * SLAB_SIZE, " glibc: malloc slabs");
+
+  slab_committed = end;
+  return true;
+}
+
+/* Return a new slab for class CLS, or NULL if the region is exhausted.
+   Must be called with the class lock held.  */
+static struct slab *
+slab_new (size_t cls)
+{
+  struct slab *s = NULL;
+
+  __libc_lock_lock (slab_lock);
+  if (slab_released != NULL)
+    {
+      s = slab_released;
+      slab_released = s->next;
+    }
+  else if (slab_next < slab_committed || slab_commit ())
+    s = &slab_descs[slab_next++];
+  __libc_lock_unlock (slab_lock);
+
+  if (s == NULL)
+    return NULL;
+
+  s->free = NULL;
+  s->unused = slab_start (s);
+  s->used = 0;
+  s->cls = cls;
+  s->listed = false;
+  ++slab_classes[cls].nslabs;
+  return s;
+}
+
+/* Return slab S, which has no objects in use, to the system.  Must be
+   called with the class lock held.  */
+static void
+slab_release (struct slab *s)
+{
+  --slab_classes[s->cls].nslabs;
+
+  /* Slabs cannot be released separately if they are smaller than a
+     page.  */
+  if (SLAB_SIZE >= GLRO (dl_pagesize))
+    __madvise (slab_start (s), SLAB_SIZE, MADV_DONTNEED);
+
+  __libc_lock_lock (slab_lock);
+  s->next = slab_released;
+  slab_released = s;
+  __libc_lock_unlock (slab_lock);
+}
+
+static void
+slab_list_add (struct slab_class *sc, struct slab *s)
+{
+  s->prev = NULL;
+  s->next = sc->partial;
+  if (sc->partial != NULL)
+    sc->partial->prev = s;
+  sc->partial = s;
+  s->listed = true;
+}
+
+static void
+slab_list_remove (struct slab_class *sc, struct slab *s)
+{
+  if (s->prev != NULL)
+    s->prev->next = s->next;
+  else
+    sc->partial = s->next;
+  if (s->next != NULL)
+    s->next->prev = s->prev;
+  s->listed = false;
+}
+
+/* Take an object of class CLS from the slabs.  Return NULL if the slab
+   region is exhausted.  Must be called with the class lock held.  */
+static void *
+slab_class_get (size_t cls)
+{
+  struct slab_class *sc = &slab_classes[cls];
+  size_t size = slab_class_size (cls);
+
+  struct slab *s = sc->partial;
+  if (s == NULL)
+    {
+      s = slab_new (cls);
+      if (s == NULL)
+	return NULL;
+      slab_list_add (sc, s);
+    }
+
+  void *mem;
+  if (s->free != NULL)
+    {
+      slab_object *e = s->free;
+      if (__glibc_unlikely (misaligned_mem (e) || !slab_contains (e)))
+	malloc_printerr ("malloc(): corrupted slab free list");
+      s->free = REVEAL_PTR (e->next);
+      mem = e;
+    }
+  else
+    {
+      mem = s->unused;
+      s->unused += size;
+    }
+
+  if (s->free == NULL && s->unused + size > slab_start (s) + SLAB_SIZE)
+    slab_list_remove (sc, s);
+
+  /* Objects never handed out may still carry the key if the slab has
+     been used before.  */
+  ((slab_object *) mem)->key = 0;
+  ++s->used;
+  ++sc->used;
+  return mem;
+}
+
+/* Return the object MEM to its slab, which belongs to class CLS.  Must be
+   called with the class lock held.  */
+static void
+slab_class_put (void *mem, size_t cls)
+{
+  struct slab_class *sc = &slab_classes[cls];
+  struct slab *s = &slab_descs[slab_index (mem)];
+  size_t offset = (char *) mem - slab_start (s);
+
+  if (__glibc_unlikely (s->cls != cls || s->used == 0
+			|| (char *) mem >= s->unused
+			|| offset % slab_class_size (cls) != 0))
+    malloc_printerr ("free(): invalid pointer");
+
+  slab_object *e = mem;
+  e->next = PROTECT_PTR (&e->next, s->free);
+  e->key = slab_key;
+  s->free = e;
+  --s->used;
+  --sc->used;
+
+  if (!s->listed)
+    slab_list_add (sc, s);
+  else if (s->used == 0 && (sc->partial != s || s->next != NULL))
+    {
+      /* Keep one slab per class around, but release all other empty
+	 slabs.  */
+      slab_list_remove (sc, s);
+      slab_release (s);
+    }
+}
+
+static __always_inline void
+slab_class_lock (size_t cls)
+{
+  if (!SINGLE_THREAD_P)
+    __libc_lock_lock (slab_classes[cls].lock);
+}
+
+static __always_inline void
+slab_class_unlock (size_t cls)
+{
+  if (!SINGLE_THREAD_P)
+    __libc_lock_unlock (slab_classes[cls].lock);
+}
+
+static __always_inline bool
+slab_cache_inactive (void)
+{
+  return slab_tcache == &__slab_cache_dummy.inactive;
+}
+
+static __always_inline bool
+slab_cache_enabled (void)
+{
+  return (slab_tcache != &__slab_cache_dummy.inactive
+	  && slab_tcache != &__slab_cache_dummy.disabled);
+}
+
+/* Allocate the cache of the current thread from the slabs.  */
+static void
+slab_cache_init (void)
+{
+  slab_tcache = (slab_cache *) &__slab_cache_dummy.disabled;
+
+  size_t cls = slab_class_index (sizeof (slab_cache));
+  slab_class_lock (cls);
+  slab_cache *c = slab_class_get (cls);
+  slab_class_unlock (cls);
+
+  if (c != NULL)
+    {
+      memset (c, 0, sizeof (*c));
+      for (size_t i = 0; i < SLAB_NCLASSES; ++i)
+	c->num_slots[i] = SLAB_CACHE_COUNT;
+      slab_tcache = c;
+    }
+}
+
+static __always_inline void
+slab_cache_put (void *mem, size_t cls)
+{
+  slab_object *e = mem;
+  e->next = PROTECT_PTR (&e->next, slab_tcache->entries[cls]);
+  e->key = slab_key;
+  slab_tcache->entries[cls] = e;
+  --slab_tcache->num_slots[cls];
+}
+
+static __always_inline void *
+slab_cache_get (size_t cls)
+{
+  slab_object *e = slab_tcache->entries[cls];
+  if (__glibc_unlikely (misaligned_mem (e)))
+    malloc_printerr ("malloc(): unaligned slab cache object detected");
+  slab_tcache->entries[cls] = REVEAL_PTR (e->next);
+  e->key = 0;
+  ++slab_tcache->num_slots[cls];
+  return e;
+}
+
+/* Slow path of slab_malloc: take a batch of objects from the slabs.  */
+static void * __attribute_noinline__
+slab_malloc_refill (size_t cls)
+{
+  if (slab_cache_inactive ())
+    slab_cache_init ();
+
+  slab_class_lock (cls);
+  void *mem = slab_class_get (cls);
+  if (mem != NULL && slab_cache_enabled ())
+    for (int i = 1; i < SLAB_CACHE_BATCH && slab_tcache->num_slots[cls] != 0;
+	 ++i)
+      {
+	void *extra = slab_class_get (cls);
+	if (extra == NULL)
+	  break;
+	slab_cache_put (extra, cls);
+      }
+  slab_class_unlock (cls);
+
+  return mem;
+}
+
+/* Allocate an object for a request of BYTES bytes, which must be less
+   than mp_.slab_max_bytes.  Return NULL if no slab space is left.  */
+static __always_inline void *
+slab_malloc (size_t bytes)
+{
+  size_t cls = slab_class_index (bytes);
+  if (__glibc_likely (slab_tcache->entries[cls] != NULL))
+    return slab_cache_get (cls);
+  return slab_malloc_refill (cls);
+}
+
+/* Slow path of slab_free: return a batch of cached objects, and MEM, to
+   the slabs.  */
+static void __attribute_noinline__
+slab_free_flush (void *mem, size_t cls)
+{
+  if (slab_cache_inactive ())
+    {
+      slab_cache_init ();
+      if (slab_tcache->num_slots[cls] != 0)
+	{
+	  slab_cache_put (mem, cls);
+	  return;
+	}
+    }
+
+  slab_class_lock (cls);
+  slab_class_put (mem, cls);
+  for (int i = 0; i < SLAB_CACHE_BATCH && slab_tcache->entries[cls] != NULL;
+       ++i)
+    slab_class_put (slab_cache_get (cls), cls);
+  slab_class_unlock (cls);
+}
+
+/* Called by slab_free if the slab object E of class CLS carries the key
+   of free objects.  Look for E in the cache of the current thread and on
+   the free list of its slab.  Like tcache_double_free_verify, this does
+   not find objects in the caches of other threads.  */
+static __attribute__ ((noinline)) void
+slab_double_free_verify (slab_object *e, size_t cls)
+{
+  size_t cnt = 0;
+  if (slab_cache_enabled ())
+    for (slab_object *tmp = slab_tcache->entries[cls]; tmp != NULL;
+	 tmp = REVEAL_PTR (tmp->next), ++cnt)
+      {
+	if (cnt >= SLAB_CACHE_COUNT || misaligned_mem (tmp))
+	  malloc_printerr ("free(): corrupted slab cache detected");
+	if (tmp == e)
+	  malloc_printerr ("free(): double free detected in slab");
+      }
+
+  struct slab *s = &slab_descs[slab_index (e)];
+  size_t limit = SLAB_SIZE / slab_class_size (cls);
+  cnt = 0;
+  slab_class_lock (cls);
+  for (slab_object *tmp = s->free; tmp != NULL;
+       tmp = REVEAL_PTR (tmp->next), ++cnt)
+    {
+      if (cnt >= limit || misaligned_mem (tmp) || !slab_contains (tmp))
+	malloc_printerr ("free(): corrupted slab free list");
+      if (tmp == e)
+	malloc_printerr ("free(): double free detected in slab");
+    }
+  slab_class_unlock (cls);
+
+  /* Application data which happens to match the key, or an object in the
+     cache of another thread.  */
+  e->key = 0;
+}
+
+/* Free the slab object MEM.  */
+static __always_inline void
+slab_free (void *mem)
+{
+  size_t cls = slab_desc (mem, "free(): invalid pointer")->cls;
+  if (__glibc_unlikely (((slab_object *) mem)->key == slab_key))
+    slab_double_free_verify (mem, cls);
+  if (__glibc_likely (slab_tcache->num_slots[cls] != 0))
+    slab_cache_put (mem, cls);
+  else
+    slab_free_flush (mem, cls);
+}
+
+/* Return the usable size of the slab object MEM, which is a pointer
+   passed to FUNCTION.  */
+static __always_inline size_t
+slab_usable (void *mem, const char *function)
+{
+  return slab_class_size (slab_desc (mem, function)->cls);
+}
+
+/* Return the cached objects and the cache of the current thread to the
+   slabs.  */
+static void
+slab_thread_shutdown (void)
+{
+  slab_cache *c = slab_tcache;
+  bool need_free = slab_cache_enabled ();
+  slab_tcache = (slab_cache *) &__slab_cache_dummy.disabled;
+  if (!need_free)
+    return;
+
+  for (size_t cls = 0; cls < SLAB_NCLASSES; ++cls)
+    if (c->entries[cls] != NULL)
+      {
+	slab_class_lock (cls);
+	while (c->entries[cls] != NULL)
+	  {
+	    slab_object *e = c->entries[cls];
+	    c->entries[cls] = REVEAL_PTR (e->next);
+	    slab_class_put (e, cls);
+	  }
+	slab_class_unlock (cls);
+      }
+
+  size_t cls = slab_class_index (sizeof (slab_cache));
+  slab_class_lock (cls);
+  slab_class_put (c, cls);
+  slab_class_unlock (cls);
+}
+
+/* Write the slab statistics for malloc_info to FP.  */
+static void
+slab_info (FILE *fp)
+{
+  if (slab_region_size == 0)
+    return;
+
+  fputs ("<slabs>\n", fp);
+  for (size_t cls = 0; cls < SLAB_NCLASSES; ++cls)
+    {
+      struct slab_class *sc = &slab_classes[cls];
+      __libc_lock_lock (sc->lock);
+      size_t nslabs = sc->nslabs;
+      size_t used = sc->used;
+      __libc_lock_unlock (sc->lock);
+      if (nslabs != 0)
+	fprintf (fp, "  <slab size=\"%zu\" count=\"%zu\" used=\"%zu\"/>\n",
+		 slab_class_size (cls), nslabs, used);
+    }
+  fputs ("</slabs>\n", fp);
+}
+
+static void
+slab_fork_lock (void)
+{
+  if (slab_region_size == 0)
+    return;
+  for (size_t cls = 0; cls < SLAB_NCLASSES; ++cls)
+    __libc_lock_lock (slab_classes[cls].lock);
+  __libc_lock_lock (slab_lock);
+}
+
+static void
+slab_fork_unlock_parent (void)
+{
+  if (slab_region_size == 0)
+    return;
+  __libc_lock_unlock (slab_lock);
+  for (size_t cls = 0; cls < SLAB_NCLASSES; ++cls)
+    __libc_lock_unlock (slab_classes[cls].lock);
+}
+
+static void
+slab_fork_unlock_child (void)
+{
+  if (slab_region_size == 0)
+    return;
+  __libc_lock_init (slab_lock);
+  for (size_t cls = 0; cls < SLAB_NCLASSES; ++cls)
+    __libc_lock_init (slab_classes[cls].lock);
+}
+
+#else /* !IS_IN (libc) */
+
+/* The copy of malloc in libc_malloc_debug does not use slabs.  */
+
+static void
+slab_init (void)
+{
+  mp_.slab_max_bytes = 0;
+}
+
+static __always_inline bool
+slab_contains (void *mem)
+{
+  return false;
+}
+
+static __always_inline size_t
+slab_usable (void *mem, const char *function)
+{
+  return 0;
+}
+
+static void
+slab_info (FILE *fp)
+{
+}
+
+static void
+slab_thread_shutdown (void)
+{
+}
+
+static void
+slab_fork_lock (void)
+{
+}
+
+static void
+slab_fork_unlock_parent (void)
+{
+}
+
+static void
+slab_fork_unlock_child (void)
+{
+}
+
+#endif /* !IS_IN (libc) */
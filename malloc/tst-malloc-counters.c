@@ -0,0 +1,156 @@
+/* Test the malloc event counters.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { rounds = 1000 };
+
+static struct malloc_counters
+get_counters (int arena)
+{
+  struct malloc_counters c;
+  TEST_COMPARE (malloc_counters (arena, &c, sizeof (c)), 0);
+  return c;
+}
+
+/* Return the size class of a request of BYTES.  */
+static size_t
+class_of (const struct malloc_counters *c, size_t bytes)
+{
+  for (size_t i = 0; i < MALLOC_COUNTERS_CLASSES; ++i)
+    if (c->class_size[i] >= bytes)
+      return i;
+  FAIL_EXIT1 ("no size class for %zu bytes", bytes);
+}
+
+/* Free and allocate a block of BYTES repeatedly, so that all but the
+   first request are served from the thread cache.  */
+static void *
+reuse (void *closure)
+{
+  size_t bytes = (size_t) closure;
+  for (int i = 0; i < rounds; ++i)
+    free (xmalloc (bytes));
+  return NULL;
+}
+
+static pthread_barrier_t barrier;
+
+/* Allocate in a thread which takes the arena of the exited thread from
+   the free list, and keep that arena attached until the main thread is
+   done.  Thus the next thread gets a new arena.  */
+static void *
+attach_arena_thread (void *closure)
+{
+  free (xmalloc (100));
+  xpthread_barrier_wait (&barrier);
+  xpthread_barrier_wait (&barrier);
+  return NULL;
+}
+
+/* Grow the arena of a new thread many times.  */
+static void *
+grow_arena_thread (void *closure)
+{
+  enum { count = 200 };
+  static void *blocks[count];
+  for (int i = 0; i < count; ++i)
+    blocks[i] = xmalloc (100 * 1024);
+  for (int i = 0; i < count; ++i)
+    free (blocks[i]);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  struct malloc_counters before = get_counters (-1);
+  for (size_t i = 1; i < MALLOC_COUNTERS_CLASSES; ++i)
+    if (before.class_size[i] != 0)
+      TEST_VERIFY (before.class_size[i] > before.class_size[i - 1]);
+  size_t cls = class_of (&before, 40);
+
+  reuse ((void *) 40);
+  struct malloc_counters after = get_counters (-1);
+  TEST_VERIFY (after.class_hits[cls] >= before.class_hits[cls] + rounds - 1);
+  TEST_VERIFY (after.tcache_hits >= before.tcache_hits + rounds - 1);
+  TEST_VERIFY (after.tcache_hits >= after.class_hits[cls]);
+
+  /* The counters of exited threads are kept.  */
+  cls = class_of (&before, 100);
+  before = after;
+  xpthread_join (xpthread_create (NULL, reuse, (void *) 100));
+  after = get_counters (-1);
+  TEST_VERIFY (after.class_hits[cls] >= before.class_hits[cls] + rounds - 1);
+
+  /* Large blocks are allocated with mmap.  */
+  before = after;
+  free (xmalloc (16 * 1024 * 1024));
+  after = get_counters (-1);
+  TEST_VERIFY (after.mmapped_chunks > before.mmapped_chunks);
+
+  /* The main arena needed memory from the system at least once.  */
+  struct malloc_counters main_arena = get_counters (0);
+  TEST_VERIFY (main_arena.sysmalloc_calls > 0);
+  TEST_COMPARE (main_arena.tcache_hits, 0);
+  TEST_VERIFY (after.sysmalloc_calls >= main_arena.sysmalloc_calls);
+
+  /* Arenas keep their index when more arenas are created.  */
+  xpthread_barrier_init (&barrier, NULL, 2);
+  pthread_t attach = xpthread_create (NULL, attach_arena_thread, NULL);
+  xpthread_barrier_wait (&barrier);
+  enum { max_arenas = 64 };
+  struct malloc_counters arenas[max_arenas];
+  int narenas = 0;
+  while (narenas < max_arenas
+	 && malloc_counters (narenas, &arenas[narenas],
+			     sizeof (arenas[0])) == 0)
+    ++narenas;
+  TEST_VERIFY_EXIT (narenas < max_arenas);
+  xpthread_join (xpthread_create (NULL, grow_arena_thread, NULL));
+  for (int i = 0; i < narenas; ++i)
+    {
+      struct malloc_counters c = get_counters (i);
+      TEST_COMPARE (c.sysmalloc_calls, arenas[i].sysmalloc_calls);
+    }
+  TEST_VERIFY (get_counters (narenas).sysmalloc_calls > 0);
+  xpthread_barrier_wait (&barrier);
+  xpthread_join (attach);
+  xpthread_barrier_destroy (&barrier);
+
+  /* Arena indices end somewhere.  */
+  struct malloc_counters c;
+  errno = 0;
+  TEST_COMPARE (malloc_counters (INT_MAX, &c, sizeof (c)), -1);
+  TEST_COMPARE (errno, ENOENT);
+
+  /* Shorter buffers receive a prefix.  */
+  c.tcache_misses = 12345;
+  TEST_COMPARE (malloc_counters (-1, &c, sizeof (c.tcache_hits)), 0);
+  TEST_COMPARE (c.tcache_misses, 12345);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
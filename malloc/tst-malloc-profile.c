@@ -0,0 +1,118 @@
+/* Test the sampling heap profiler (glibc.malloc.profile_rate).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Allocate enough memory that some blocks are sampled with the rate of
+   4096 bytes set in the Makefile, check that the profile lists them, and
+   that it no longer does once they are freed.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+
+enum { block_size = 1000 };
+
+static void *blocks[2000];
+
+/* Return the number of live samples of the blocks in the profile, and
+   check its format.  */
+static size_t
+dump_profile (void)
+{
+  struct xmemstream stream;
+  xopen_memstream (&stream);
+  TEST_COMPARE (malloc_profile_dump (stream.out), 0);
+  xfclose_memstream (&stream);
+
+  size_t live, live_bytes, total, total_bytes, rate;
+  TEST_COMPARE (sscanf (stream.buffer,
+			"heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+			&live, &live_bytes, &total, &total_bytes, &rate), 5);
+  TEST_COMPARE (rate, 4096);
+  TEST_VERIFY (live <= total);
+  TEST_VERIFY (live_bytes <= total_bytes);
+
+  /* Each sample has a line with its size and a stack trace.  Samples
+     taken while the dynamic loader started the program may lack the
+     stack trace, but those of the blocks have one.  */
+  size_t lines = 0;
+  size_t block_samples = 0;
+  for (char *line = strchr (stream.buffer, '\n') + 1;
+       strncmp (line, "1: ", 3) == 0; line = strchr (line, '\n') + 1)
+    {
+      size_t size;
+      TEST_COMPARE (sscanf (line, "1: %zu [", &size), 1);
+      if (size == block_size)
+	{
+	  TEST_VERIFY (strncmp (strchr (line, '@'), "@ 0x", 4) == 0);
+	  ++block_samples;
+	}
+      ++lines;
+    }
+  TEST_COMPARE (lines, live);
+  TEST_VERIFY (strstr (stream.buffer, "\nMAPPED_LIBRARIES:\n") != NULL);
+
+  free (stream.buffer);
+  return block_samples;
+}
+
+static int
+do_test (void)
+{
+  for (size_t i = 0; i < array_length (blocks); ++i)
+    {
+      if (i % 2 == 0)
+	blocks[i] = xmalloc (block_size);
+      else
+	{
+	  unsigned char *p = xcalloc (1, block_size);
+	  for (size_t j = 0; j < block_size; ++j)
+	    TEST_COMPARE (p[j], 0);
+	  blocks[i] = p;
+	}
+      TEST_VERIFY (malloc_usable_size (blocks[i]) >= block_size);
+      memset (blocks[i], 0xa5, block_size);
+    }
+
+  /* About 500 blocks are expected to be sampled.  */
+  size_t before = dump_profile ();
+  printf ("info: %zu live samples\n", before);
+  TEST_VERIFY (before >= 100);
+
+  /* Sampled blocks keep their contents when they grow.  */
+  for (size_t i = 0; i < array_length (blocks); ++i)
+    {
+      blocks[i] = xrealloc (blocks[i], 2 * block_size);
+      for (size_t j = 0; j < block_size; ++j)
+	TEST_COMPARE (((unsigned char *) blocks[i])[j], 0xa5);
+    }
+
+  for (size_t i = 0; i < array_length (blocks); ++i)
+    free (blocks[i]);
+
+  size_t after = dump_profile ();
+  printf ("info: %zu live samples after free\n", after);
+  TEST_VERIFY (after < before / 2);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
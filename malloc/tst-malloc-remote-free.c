@@ -0,0 +1,114 @@
+/* Test freeing memory on contended arenas (glibc.malloc.remote_free=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Producer threads allocate blocks from a single arena and hand them to
+   consumer threads which free them while the producers keep the arena
+   busy.  Afterwards, all deferred frees must have been returned to the
+   arena.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum
+  {
+    pair_count = 4,
+    queue_length = 256,
+    blocks_per_producer = 50000,
+  };
+
+/* Single-producer single-consumer ring buffer.  */
+struct queue
+{
+  void *slots[queue_length];
+  unsigned int head;
+  unsigned int tail;
+};
+
+static struct queue queues[pair_count];
+
+static void *
+producer (void *closure)
+{
+  struct queue *q = closure;
+  for (unsigned int i = 0; i < blocks_per_producer; ++i)
+    {
+      size_t size = 16 + (i * 24) % 2048;
+      void *p = xmalloc (size);
+      memset (p, 0xa5, size);
+      while (__atomic_load_n (&q->head, __ATOMIC_ACQUIRE)
+	     - __atomic_load_n (&q->tail, __ATOMIC_RELAXED) == queue_length)
+	;
+      q->slots[q->head % queue_length] = p;
+      __atomic_store_n (&q->head, q->head + 1, __ATOMIC_RELEASE);
+    }
+  return NULL;
+}
+
+static void *
+consumer (void *closure)
+{
+  struct queue *q = closure;
+  for (unsigned int i = 0; i < blocks_per_producer; ++i)
+    {
+      while (__atomic_load_n (&q->head, __ATOMIC_ACQUIRE) == q->tail)
+	;
+      free (q->slots[q->tail % queue_length]);
+      __atomic_store_n (&q->tail, q->tail + 1, __ATOMIC_RELEASE);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  struct mallinfo2 before = mallinfo2 ();
+
+  pthread_t threads[2 * pair_count];
+  for (size_t i = 0; i < pair_count; ++i)
+    {
+      threads[2 * i] = xpthread_create (NULL, producer, &queues[i]);
+      threads[2 * i + 1] = xpthread_create (NULL, consumer, &queues[i]);
+    }
+  for (size_t i = 0; i < array_length (threads); ++i)
+    xpthread_join (threads[i]);
+
+  /* mallinfo2 returns deferred chunks to their arena first, so only the
+     memory of the exited threads' bookkeeping may remain in use.  */
+  struct mallinfo2 after = mallinfo2 ();
+  printf ("info: in use before: %zu, after: %zu\n",
+	  before.uordblks, after.uordblks);
+  TEST_VERIFY (after.uordblks < before.uordblks + 1024 * 1024);
+
+  /* The arenas must still be consistent.  */
+  void *blocks[1000];
+  for (size_t i = 0; i < array_length (blocks); ++i)
+    blocks[i] = xmalloc (16 + i);
+  for (size_t i = 0; i < array_length (blocks); ++i)
+    free (blocks[i]);
+  malloc_trim (0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
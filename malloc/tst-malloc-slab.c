@@ -0,0 +1,199 @@
+/* Test the slab allocator for small objects (glibc.malloc.slab_max).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+#include <support/xthread.h>
+
+enum { block_count = 20000 };
+
+struct block
+{
+  unsigned char *ptr;
+  size_t size;
+};
+
+static struct block blocks[block_count];
+
+static int
+compare_blocks (const void *a, const void *b)
+{
+  uintptr_t pa = (uintptr_t) ((const struct block *) a)->ptr;
+  uintptr_t pb = (uintptr_t) ((const struct block *) b)->ptr;
+  return pa < pb ? -1 : pa > pb;
+}
+
+static void
+check_contents (const struct block *b, unsigned char c)
+{
+  for (size_t j = 0; j < b->size; ++j)
+    if (b->ptr[j] != c)
+      FAIL_EXIT1 ("block %p of size %zu corrupted at offset %zu",
+		  b->ptr, b->size, j);
+}
+
+/* Allocate blocks of all slab sizes, check that they are disjoint, and
+   free them in a different order.  */
+static void
+check_blocks (void)
+{
+  for (size_t i = 0; i < block_count; ++i)
+    {
+      size_t size = (i * 7) % 257;
+      blocks[i].ptr = xmalloc (size);
+      blocks[i].size = malloc_usable_size (blocks[i].ptr);
+      TEST_VERIFY_EXIT (blocks[i].size >= size);
+      memset (blocks[i].ptr, (unsigned char) i, blocks[i].size);
+    }
+
+  for (size_t i = 0; i < block_count; ++i)
+    check_contents (&blocks[i], (unsigned char) i);
+
+  qsort (blocks, block_count, sizeof (blocks[0]), compare_blocks);
+  for (size_t i = 1; i < block_count; ++i)
+    TEST_VERIFY (blocks[i - 1].ptr + blocks[i - 1].size <= blocks[i].ptr);
+
+  for (size_t i = 0; i < block_count; i += 2)
+    free (blocks[i].ptr);
+  for (size_t i = 1; i < block_count; i += 2)
+    free (blocks[i].ptr);
+}
+
+static void *
+allocate_thread (void *closure)
+{
+  void **ptrs = closure;
+  for (size_t i = 0; i < 1000; ++i)
+    {
+      ptrs[i] = xmalloc (1 + i % 200);
+      memset (ptrs[i], 0xa5, 1 + i % 200);
+    }
+  return NULL;
+}
+
+/* Free an object twice while it is in the cache of the thread.  */
+static void
+double_free_cached (void *closure)
+{
+  void * volatile p = xmalloc (48);
+  free (p);
+  free (p);
+}
+
+/* Free an object twice after it has been returned to its slab.  */
+static void
+double_free_slab (void *closure)
+{
+  static void *others[200];
+  void * volatile keep = xmalloc (48);
+  void * volatile p = xmalloc (48);
+  for (size_t i = 0; i < array_length (others); ++i)
+    others[i] = xmalloc (48);
+  free (p);
+  for (size_t i = 0; i < array_length (others); ++i)
+    free (others[i]);
+  free (p);
+  free (keep);
+}
+
+static void
+check_double_free (void (*callback) (void *))
+{
+  struct support_capture_subprocess result
+    = support_capture_subprocess (callback, NULL);
+  TEST_VERIFY (WIFSIGNALED (result.status));
+  if (WIFSIGNALED (result.status))
+    TEST_COMPARE (WTERMSIG (result.status), SIGABRT);
+  TEST_COMPARE_STRING (result.err.buffer,
+		       "free(): double free detected in slab\n");
+  support_capture_subprocess_free (&result);
+}
+
+static int
+do_test (void)
+{
+  /* Small requests do not carry a chunk header.  */
+  void *p = xmalloc (16);
+  TEST_COMPARE (malloc_usable_size (p), 16);
+  free (p);
+  p = xmalloc (0);
+  TEST_VERIFY (malloc_usable_size (p) <= 16);
+  free (p);
+
+  for (int round = 0; round < 3; ++round)
+    check_blocks ();
+
+  /* calloc clears reused objects.  */
+  for (size_t size = 1; size <= 256; ++size)
+    {
+      unsigned char *q = xmalloc (size);
+      memset (q, 0xff, size);
+      free (q);
+      q = xcalloc (1, size);
+      for (size_t j = 0; j < size; ++j)
+	TEST_COMPARE (q[j], 0);
+      free (q);
+    }
+
+  /* realloc moves objects between slabs and chunks.  */
+  unsigned char *r = xmalloc (10);
+  memset (r, 1, 10);
+  r = xrealloc (r, 100);
+  for (size_t j = 0; j < 10; ++j)
+    TEST_COMPARE (r[j], 1);
+  memset (r, 2, 100);
+  r = xrealloc (r, 4000);
+  for (size_t j = 0; j < 100; ++j)
+    TEST_COMPARE (r[j], 2);
+  r = xrealloc (r, 50);
+  for (size_t j = 0; j < 50; ++j)
+    TEST_COMPARE (r[j], 2);
+  free (r);
+
+  /* Objects allocated by another thread can be freed here.  */
+  static void *ptrs[1000];
+  xpthread_join (xpthread_create (NULL, allocate_thread, ptrs));
+  for (size_t i = 0; i < array_length (ptrs); ++i)
+    free (ptrs[i]);
+
+  /* malloc_info reports the slabs.  */
+  void *keep = xmalloc (32);
+  struct xmemstream mem;
+  xopen_memstream (&mem);
+  TEST_COMPARE (malloc_info (0, mem.out), 0);
+  xfclose_memstream (&mem);
+  TEST_VERIFY (strstr (mem.buffer, "<slab size=\"32\"") != NULL);
+  free (mem.buffer);
+  free (keep);
+
+  check_double_free (double_free_cached);
+  check_double_free (double_free_slab);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,94 @@
+/* Test batched tcache refill and flush.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Allocate bursts of same-size blocks (served by chunks carved from the
+   top chunk in batches) and free them again (overflowing the tcache
+   bucket, which triggers batched flushes).  Check that no two live
+   blocks overlap and that their contents survive.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+
+enum { burst = 100 };
+
+struct block
+{
+  unsigned char *ptr;
+  size_t size;
+};
+
+static struct block blocks[burst];
+
+static int
+compare_blocks (const void *a, const void *b)
+{
+  uintptr_t pa = (uintptr_t) ((const struct block *) a)->ptr;
+  uintptr_t pb = (uintptr_t) ((const struct block *) b)->ptr;
+  return pa < pb ? -1 : pa > pb;
+}
+
+static void
+check_burst (size_t size, int round)
+{
+  for (size_t i = 0; i < burst; ++i)
+    {
+      blocks[i].ptr = xmalloc (size);
+      blocks[i].size = malloc_usable_size (blocks[i].ptr);
+      TEST_VERIFY_EXIT (blocks[i].size >= size);
+      memset (blocks[i].ptr, (int) (i + round), blocks[i].size);
+    }
+
+  for (size_t i = 0; i < burst; ++i)
+    for (size_t j = 0; j < blocks[i].size; ++j)
+      if (blocks[i].ptr[j] != (unsigned char) (i + round))
+	FAIL_EXIT1 ("block %zu of size %zu corrupted at offset %zu",
+		    i, size, j);
+
+  qsort (blocks, burst, sizeof (blocks[0]), compare_blocks);
+  for (size_t i = 1; i < burst; ++i)
+    TEST_VERIFY (blocks[i - 1].ptr + blocks[i - 1].size <= blocks[i].ptr);
+
+  /* Free in an order different from the allocation order, so that
+     flushed chunks are not all adjacent.  */
+  for (size_t i = 0; i < burst; i += 2)
+    free (blocks[i].ptr);
+  for (size_t i = 1; i < burst; i += 2)
+    free (blocks[i].ptr);
+}
+
+static int
+do_test (void)
+{
+  for (int round = 0; round < 4; ++round)
+    for (size_t size = 1; size <= 1024; size += 24)
+      check_burst (size, round);
+
+  /* Freed memory is usable again after the flushes.  */
+  struct mallinfo2 mi = mallinfo2 ();
+  TEST_VERIFY (mi.fordblks > 0);
+  malloc_trim (0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
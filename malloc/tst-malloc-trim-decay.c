@@ -0,0 +1,116 @@
+/* Test deferred trimming (glibc.malloc.trim_decay).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Free a large amount of memory at the top of the main arena.  free must
+   not return it to the system right away, but the trim thread must do so
+   after the decay time.  The trim thread exits once there is nothing left
+   to trim, and is started again for the next deferred trim.  */
+
+#include <dirent.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdirent.h>
+
+enum
+  {
+    /* Below the mmap threshold, so that the blocks come from the heap.  */
+    block_size = 64 * 1024,
+    block_count = 256,
+    total_size = block_size * block_count,
+  };
+
+static void *blocks[block_count];
+
+/* Return the number of threads in the process.  */
+static int
+thread_count (void)
+{
+  DIR *dir = xopendir ("/proc/self/task");
+  int count = 0;
+  struct dirent *e;
+  while ((e = readdir (dir)) != NULL)
+    if (e->d_name[0] != '.')
+      ++count;
+  xclosedir (dir);
+  return count;
+}
+
+static void
+sleep_10ms (void)
+{
+  nanosleep (&(struct timespec) { .tv_nsec = 10 * 1000 * 1000 }, NULL);
+}
+
+static void
+allocate_and_free (void)
+{
+  for (size_t i = 0; i < block_count; ++i)
+    {
+      blocks[i] = xmalloc (block_size);
+      memset (blocks[i], 0x5a, block_size);
+    }
+  size_t allocated = mallinfo2 ().arena;
+  TEST_VERIFY_EXIT (allocated >= total_size);
+
+  /* Free from the top down, so that each free extends the top chunk.  */
+  for (size_t i = block_count; i > 0; --i)
+    free (blocks[i - 1]);
+
+  /* The decay time of 100 ms has not passed yet.  */
+  size_t after_free = mallinfo2 ().arena;
+  printf ("info: arena size after allocation: %zu, after free: %zu\n",
+	  allocated, after_free);
+  TEST_VERIFY (after_free >= total_size);
+
+  /* Wait up to ten seconds for the trim thread.  */
+  size_t current = after_free;
+  for (int i = 0; i < 1000 && current >= total_size / 2; ++i)
+    {
+      sleep_10ms ();
+      current = mallinfo2 ().arena;
+    }
+  printf ("info: arena size after decay: %zu\n", current);
+  TEST_VERIFY (current < total_size / 2);
+}
+
+static int
+do_test (void)
+{
+  TEST_COMPARE (thread_count (), 1);
+  allocate_and_free ();
+
+  /* Wait up to ten seconds for the idle trim thread to exit.  */
+  int threads = thread_count ();
+  for (int i = 0; i < 1000 && threads > 1; ++i)
+    {
+      sleep_10ms ();
+      threads = thread_count ();
+    }
+  TEST_COMPARE (threads, 1);
+
+  /* A new thread is started for the next deferred trim.  */
+  allocate_and_free ();
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,213 @@
+/* Test malloc_trim on huge page backed heaps (glibc.malloc.hugetlb=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Fragment the heaps of the main arena and of a thread arena so that
+   free chunks of varying sizes sit between live blocks, then trim them.
+   Only free memory may be released: the live blocks must keep their
+   contents.  With glibc.malloc.hugetlb=1, trimming must also not split
+   the transparent huge pages backing the main arena.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xstdio.h>
+#include <support/xthread.h>
+
+enum { block_count = 512 };
+
+static void
+fragment_and_trim (unsigned char **blocks, size_t *sizes)
+{
+  for (size_t i = 0; i < block_count; ++i)
+    {
+      /* Stay below the mmap threshold, so that all blocks come from
+         the arena heaps.  */
+      sizes[i] = 1024 + (i % 13) * 8 * 1024;
+      blocks[i] = xmalloc (sizes[i]);
+      memset (blocks[i], (int) i, sizes[i]);
+    }
+
+  /* Leave short free runs in the first half and free runs spanning
+     several huge pages in the second half.  */
+  for (size_t i = 0; i < block_count; ++i)
+    if (i < block_count / 2 ? i % 5 != 0 : i % 64 != 0)
+      {
+        free (blocks[i]);
+        blocks[i] = NULL;
+      }
+
+  malloc_trim (0);
+
+  for (size_t i = 0; i < block_count; ++i)
+    if (blocks[i] != NULL)
+      {
+        for (size_t j = 0; j < sizes[i]; ++j)
+          if (blocks[i][j] != (unsigned char) i)
+            FAIL_EXIT1 ("block %zu corrupted at offset %zu", i, j);
+        free (blocks[i]);
+      }
+
+  /* The trimmed memory is usable again.  */
+  for (size_t i = 0; i < block_count; ++i)
+    {
+      blocks[i] = xmalloc (sizes[i]);
+      memset (blocks[i], 0xcc, sizes[i]);
+    }
+  for (size_t i = 0; i < block_count; ++i)
+    free (blocks[i]);
+  malloc_trim (0);
+}
+
+/* Return the transparent huge page size if the system allows huge
+   pages for malloc, or 0.  */
+static size_t
+thp_pagesize (void)
+{
+  FILE *f = fopen ("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (f == NULL)
+    return 0;
+  char *line = NULL;
+  size_t n = 0;
+  bool enabled = (getline (&line, &n, f) > 0
+		  && (strstr (line, "[always]") != NULL
+		      || strstr (line, "[madvise]") != NULL));
+  free (line);
+  xfclose (f);
+  if (!enabled)
+    return 0;
+
+  f = fopen ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+  if (f == NULL)
+    return 0;
+  size_t size;
+  if (fscanf (f, "%zu", &size) != 1)
+    size = 0;
+  xfclose (f);
+  return size;
+}
+
+/* Return the AnonHugePages total in kB of the mappings overlapping
+   [START, END).  */
+static long int
+anon_huge_kb (uintptr_t start, uintptr_t end)
+{
+  FILE *f = xfopen ("/proc/self/smaps", "r");
+  char *line = NULL;
+  size_t n = 0;
+  bool overlaps = false;
+  long int total = 0;
+  while (getline (&line, &n, f) > 0)
+    {
+      unsigned long int from, to;
+      long int kb;
+      if (sscanf (line, "%lx-%lx ", &from, &to) == 2)
+	overlaps = from < end && start < to;
+      else if (overlaps && sscanf (line, "AnonHugePages: %ld kB", &kb) == 1)
+	total += kb;
+    }
+  free (line);
+  xfclose (f);
+  return total;
+}
+
+/* Leave one live block in each huge page of the main arena, with the
+   rest of the huge page free, and check that malloc_trim releases none
+   of these huge pages.  */
+static void
+check_huge_pages_kept (void)
+{
+  const char *tunables = getenv ("GLIBC_TUNABLES");
+  if (tunables == NULL || strstr (tunables, "glibc.malloc.hugetlb=1") == NULL)
+    return;
+  size_t hpsize = thp_pagesize ();
+  if (hpsize == 0)
+    FAIL_UNSUPPORTED ("transparent huge pages are not available");
+
+  /* Below the mmap threshold and above the tcache sizes, so that the
+     blocks are freed to the arena.  */
+  enum { hp_block_count = 256, hp_block_size = 64 * 1024 };
+  static unsigned char *hp_blocks[hp_block_count];
+  uintptr_t start = UINTPTR_MAX;
+  uintptr_t end = 0;
+  for (size_t i = 0; i < hp_block_count; ++i)
+    {
+      hp_blocks[i] = xmalloc (hp_block_size - 64);
+      memset (hp_blocks[i], 1, hp_block_size - 64);
+      if ((uintptr_t) hp_blocks[i] < start)
+	start = (uintptr_t) hp_blocks[i];
+      if ((uintptr_t) hp_blocks[i] + hp_block_size > end)
+	end = (uintptr_t) hp_blocks[i] + hp_block_size;
+    }
+
+  /* The last block keeps the free memory away from the top chunk.  */
+  size_t per_page = hpsize / hp_block_size;
+  for (size_t i = 0; i < hp_block_count; ++i)
+    if (i % per_page != 0 && i != hp_block_count - 1)
+      {
+	free (hp_blocks[i]);
+	hp_blocks[i] = NULL;
+      }
+
+  long int before = anon_huge_kb (start, end);
+  if (before == 0)
+    FAIL_UNSUPPORTED ("the main arena is not backed by huge pages");
+  malloc_trim (0);
+  long int after = anon_huge_kb (start, end);
+  if (after < before)
+    FAIL ("malloc_trim split huge pages: AnonHugePages %ld kB -> %ld kB",
+	  before, after);
+
+  for (size_t i = 0; i < hp_block_count; ++i)
+    free (hp_blocks[i]);
+}
+
+static unsigned char *thread_blocks[block_count];
+static size_t thread_sizes[block_count];
+
+static void *
+thread_func (void *closure)
+{
+  fragment_and_trim (thread_blocks, thread_sizes);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  static unsigned char *blocks[block_count];
+  static size_t sizes[block_count];
+
+  /* The thread allocates from an arena of its own, backed by heaps
+     allocated with new_heap.  */
+  pthread_t thr = xpthread_create (NULL, thread_func, NULL);
+  xpthread_join (thr);
+
+  fragment_and_trim (blocks, sizes);
+
+  check_huge_pages_kept ();
+
+  return 0;
+}
+
+#include <support/test-driver.c>
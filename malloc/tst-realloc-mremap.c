@@ -0,0 +1,143 @@
+/* Test growing blocks with glibc.malloc.realloc_mremap_threshold.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Grow a buffer from a few bytes to 64 MiB in steps of a quarter, as a
+   vector would, with the threshold of 1 MiB set in the Makefile.  The
+   contents must survive every step.  Past the threshold, the block must
+   be mmapped, get half its size as headroom whenever it is resized, and
+   be resized at most every other step.  Blocks which can grow in place
+   in the heap are not moved.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+
+enum
+  {
+    threshold = 1024 * 1024,
+    max_size = 64 * 1024 * 1024,
+  };
+
+static unsigned char
+pattern (size_t i)
+{
+  return (unsigned char) (i * 7 + (i >> 12));
+}
+
+static void
+check_contents (const unsigned char *p, size_t size)
+{
+  /* Checking every byte would take too long for the larger sizes.  */
+  for (size_t i = 0; i < size; i += size < 65536 ? 1 : 4093)
+    if (p[i] != pattern (i))
+      FAIL_EXIT1 ("byte %zu of %zu-byte block changed", i, size);
+  if (p[size - 1] != pattern (size - 1))
+    FAIL_EXIT1 ("last byte of %zu-byte block changed", size);
+}
+
+static int
+do_test (void)
+{
+  size_t size = 16;
+  unsigned char *p = xmalloc (size);
+  for (size_t i = 0; i < size; ++i)
+    p[i] = pattern (i);
+
+  unsigned int steps = 0;
+  unsigned int resizes = 0;
+  while (size < max_size)
+    {
+      size_t old_usable = malloc_usable_size (p);
+      size_t new_size = size + size / 4;
+      p = xrealloc (p, new_size);
+      check_contents (p, size);
+      for (size_t i = size; i < new_size; ++i)
+	p[i] = pattern (i);
+      size = new_size;
+
+      if (size >= threshold)
+	{
+	  TEST_VERIFY (mallinfo2 ().hblks >= 1);
+	  ++steps;
+	  if (malloc_usable_size (p) != old_usable)
+	    {
+	      TEST_VERIFY (malloc_usable_size (p) >= size + size / 2);
+	      ++resizes;
+	    }
+	}
+    }
+  check_contents (p, size);
+  printf ("info: %u resizes in %u steps past the threshold\n",
+	  resizes, steps);
+  TEST_VERIFY (resizes <= steps / 2 + 1);
+
+  /* Freeing a block moved to a mapping by realloc does not raise the
+     dynamic mmap threshold, so a new allocation of the same size is
+     still mmapped.  */
+  {
+    void *tmp = xrealloc (xmalloc (threshold / 2), 2 * threshold);
+    free (tmp);
+    size_t before = mallinfo2 ().hblks;
+    tmp = xmalloc (2 * threshold);
+    TEST_COMPARE (mallinfo2 ().hblks, before + 1);
+    free (tmp);
+  }
+
+  /* Shrinking a little keeps the block and its headroom.  */
+  size_t usable = malloc_usable_size (p);
+  unsigned char *q = xrealloc (p, size - size / 4);
+  TEST_VERIFY (q == p);
+  TEST_COMPARE (malloc_usable_size (q), usable);
+  check_contents (q, size - size / 4);
+
+  /* Shrinking a lot releases the headroom.  */
+  p = xrealloc (q, threshold);
+  TEST_VERIFY (malloc_usable_size (p) < usable / 2);
+  check_contents (p, threshold);
+
+  free (p);
+
+  /* A block which can grow in place in the heap stays there.  Keep the
+     blocks below in the heap, and the free block after A away from the
+     top chunk.  The mmap threshold cannot be raised this far on 32-bit
+     targets.  */
+  if (mallopt (M_MMAP_THRESHOLD, 8 * threshold) == 1)
+    {
+      unsigned char *a = xmalloc (threshold / 2);
+      void *b = xmalloc (4 * threshold);
+      void *guard = xmalloc (16);
+      for (size_t i = 0; i < threshold / 2; ++i)
+	a[i] = pattern (i);
+      free (b);
+      size_t before = mallinfo2 ().hblks;
+      q = xrealloc (a, 2 * threshold);
+      TEST_VERIFY (q == a);
+      TEST_COMPARE (mallinfo2 ().hblks, before);
+      check_contents (q, threshold / 2);
+      free (q);
+      free (guard);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -35,6 +35,7 @@
 #include <tls-internal.h>
 #include <intprops.h>
 #include <setvmaname.h>
+#include <rseq-internal.h>
 
 /* Default alignment of stack.  */
 #ifndef STACK_ALIGN
@@ -54,6 +55,10 @@
 # define MAP_STACK 0
 #endif
 
+/* Number of usable stacks of a size class which get_cached_stack looks
+   at, in search of one which has the exact size and is local.  */
+#define STACK_CACHE_SCAN 8
+
 /* Get a stack frame from the cache.  We have to match by size since
    some blocks might be too small or far too large.  */
 static struct pthread *
@@ -61,32 +66,50 @@ get_cached_stack (size_t *sizep, void **memp)
 {
   size_t size = *sizep;
   struct pthread *result = NULL;
+  unsigned int class = __nptl_stack_cache_class (size);
+  int node = rseq_current_node ();
   list_t *entry;
 
   lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
 
-  /* Search the cache for a matching entry.  We search for the
-     smallest stack which has at least the required size.  Note that
-     in normal situations the size of all allocated stacks is the
-     same.  As the very least there are only a few different sizes.
-     Therefore this loop will exit early most of the time with an
-     exact match.  */
-  list_for_each (entry, &GL (dl_stack_cache))
+  /* Search the cache for a matching entry.  Stacks in the size class of
+     SIZE may be too small, but all stacks in the next class are large
+     enough.  We search for the smallest stack which has at least the
+     required size, preferring stacks which were allocated on the NUMA
+     node we run on.  Note that in normal situations the size of all
+     allocated stacks is the same.  As the very least there are only a
+     few different sizes.  Therefore this loop will exit early most of
+     the time with an exact match, and it never looks at more than a few
+     candidates, however many stacks are cached.  */
+  for (unsigned int c = class;
+       result == NULL && c <= class + 1 && c < DL_STACK_CACHE_CLASSES; ++c)
     {
-      struct pthread *curr;
+      unsigned int scan = STACK_CACHE_SCAN;
 
-      curr = list_entry (entry, struct pthread, list);
-      if (__nptl_stack_in_use (curr) && curr->stackblock_size >= size)
+      list_for_each (entry, &GL (dl_stack_cache)[c])
 	{
-	  if (curr->stackblock_size == size)
+	  struct pthread *curr;
+
+	  curr = list_entry (entry, struct pthread, list);
+	  if (__nptl_stack_in_use (curr) && curr->stackblock_size >= size)
 	    {
-	      result = curr;
-	      break;
+	      bool local = curr->stack_node == node;
+
+	      if (curr->stackblock_size == size && local)
+		{
+		  result = curr;
+		  break;
+		}
+
+	      if (result == NULL
+		  || result->stackblock_size > curr->stackblock_size
+		  || (result->stackblock_size == curr->stackblock_size
+		      && local))
+		result = curr;
+
+	      if (--scan == 0)
+		break;
 	    }
-
-	  if (result == NULL
-	      || result->stackblock_size > curr->stackblock_size)
-	    result = curr;
 	}
     }
 
@@ -324,21 +347,24 @@ adjust_stack_prot (char *mem, size_t size, struct pthread *pd,
 }
 
 /* Mark the memory of the stack as usable to the kernel.  It frees everything
-   except for the space used for the TCB itself.  */
+   except for the space used for the TCB itself, and for the part of the
+   stack which is kept hot for the next thread according to
+   glibc.pthread.stack_prefault.  */
 static __always_inline void
 advise_stack_range (void *mem, size_t size, uintptr_t pd, size_t guardsize)
 {
   uintptr_t sp = (uintptr_t) CURRENT_STACK_FRAME;
   size_t pagesize_m1 = __getpagesize () - 1;
+  size_t keep = MAX (PTHREAD_STACK_MIN, __nptl_stack_prefault);
 #if _STACK_GROWS_DOWN
   size_t freesize = (sp - (uintptr_t) mem) & ~pagesize_m1;
   assert (freesize < size);
-  if (freesize > PTHREAD_STACK_MIN)
-    __madvise (mem, freesize - PTHREAD_STACK_MIN, MADV_DONTNEED);
+  if (freesize > keep)
+    __madvise (mem, (freesize - keep) & ~pagesize_m1, MADV_DONTNEED);
 #else
   /* Page aligned start of memory to free (higher than or equal
-     to current sp plus the minimum stack size).  */
-  uintptr_t freeblock = (sp + PTHREAD_STACK_MIN + pagesize_m1) & ~pagesize_m1;
+     to current sp plus the size to keep).  */
+  uintptr_t freeblock = (sp + keep + pagesize_m1) & ~pagesize_m1;
   uintptr_t free_end = (pd - guardsize) & ~pagesize_m1;
   if (free_end > freeblock)
     {
@@ -349,6 +375,29 @@ advise_stack_range (void *mem, size_t size, uintptr_t pd, size_t guardsize)
 #endif
 }
 
+/* Populate the first __nptl_stack_prefault bytes of the new stack MEM
+   which the thread uses, so that it does not fault them in one page at a
+   time.  Failure is
+   not an error: older kernels do not support MADV_POPULATE_WRITE.  */
+static void
+prefault_stack (void *mem, size_t size, struct pthread *pd, size_t guardsize,
+		size_t pagesize_m1)
+{
+  size_t len = (__nptl_stack_prefault + pagesize_m1) & ~pagesize_m1;
+#if _STACK_GROWS_DOWN
+  uintptr_t start = (uintptr_t) mem + guardsize;
+  uintptr_t end = (uintptr_t) pd & ~pagesize_m1;
+  if (end - start > len)
+    start = end - len;
+#else
+  uintptr_t start = (uintptr_t) mem;
+  uintptr_t end = ((uintptr_t) pd - guardsize) & ~pagesize_m1;
+  if (end - start > len)
+    end = start + len;
+#endif
+  __madvise ((void *) start, end - start, MADV_POPULATE_WRITE);
+}
+
 /* Returns a usable stack for a new thread either by allocating a
    new stack or reusing a cached stack of sufficient size.
    ATTR must be non-NULL and point to a valid pthread_attr.
@@ -544,6 +593,10 @@ allocate_stack (const struct pthread_attr *attr, struct pthread **pdp,
 	  /* Update guardsize for newly allocated guardsize to avoid
 	     an mprotect in guard resize below.  */
 	  pd->guardsize = guardsize;
+	  pd->stack_node = rseq_current_node ();
+
+	  if (__nptl_stack_prefault != 0)
+	    prefault_stack (mem, size, pd, guardsize, pagesize_m1);
 
 	  /* We allocated the first block thread-specific data array.
 	     This address will not change for the lifetime of this
@@ -334,8 +334,10 @@ struct pthread
   /* Two-level array for the thread-specific data.  */
   struct pthread_key_data *specific[PTHREAD_KEY_1STLEVEL_SIZE];
 
-  /* Flag which is set when specific data is set.  */
-  bool specific_used;
+  /* Bit I is set when specific data is set in specific[I].  Blocks other
+     than the first one are allocated when the first data is set in them,
+     so they remain allocated while their bit is set.  */
+  unsigned int specific_used;
 
   /* True if events must be reported.  */
   bool report_events;
@@ -387,6 +389,13 @@ struct pthread
   size_t guardsize;
   /* This is what the user specified and what we will report.  */
   size_t reported_guardsize;
+  /* NUMA node of the thread which allocated the stackblock area, or -1 if
+     unknown.  Used to prefer local stacks when reusing cached ones.  */
+  int stack_node;
+
+  /* Number of contended lock acquisitions until the lock contention
+     profiler samples one.  */
+  unsigned int lock_profile_countdown;
 
   /* Thread Priority Protection data.  */
   struct priority_protection_data *tpp;
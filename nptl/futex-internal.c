@@ -21,6 +21,7 @@
 #include <time.h>
 #include <futex-internal.h>
 #include <kernel-features.h>
+#include <atomic.h>
 
 #ifndef __ASSUME_TIME64_SYSCALLS
 static int
@@ -203,3 +204,54 @@ __futex_lock_pi64 (int *futex_word, clockid_t clockid,
       futex_fatal_error ();
     }
 }
+
+int
+__futex_abstimed_waitv_cancelable64 (struct futex_waitv_entry *entries,
+				     unsigned int n, clockid_t clockid,
+				     const struct __timespec64 *abstime)
+{
+#ifdef __NR_futex_waitv
+  /* Set once futex_waitv turned out to be unavailable.  */
+  static int waitv_unsupported;
+  if (atomic_load_relaxed (&waitv_unsupported))
+    return ENOSYS;
+
+  /* See __futex_abstimed_wait_common.  */
+  if (__glibc_unlikely ((abstime != NULL) && (abstime->tv_sec < 0)))
+    return ETIMEDOUT;
+
+  if (! lll_futex_supported_clockid (clockid))
+    return EINVAL;
+
+  /* The timeout of futex_waitv is always a 64-bit struct timespec, and its
+     clock is only used if there is a timeout.  */
+  int err = INTERNAL_SYSCALL_CANCEL (futex_waitv, entries, n, 0, abstime,
+				     clockid);
+  /* On success, futex_waitv returns the index of the futex word which was
+     woken up.  */
+  if (err >= 0)
+    return 0;
+
+  switch (err)
+    {
+    case -EAGAIN:
+    case -EINTR:
+    case -ETIMEDOUT:
+      return -err;
+
+    case -ENOSYS:
+    case -EPERM: /* The system call may be blocked by a seccomp filter.  */
+      atomic_store_relaxed (&waitv_unsupported, 1);
+      return ENOSYS;
+
+    case -EFAULT: /* Must have been caused by a glibc or application bug.  */
+    case -EINVAL: /* Must have been caused by a glibc bug.  */
+    /* No other errors are documented at this time.  */
+    default:
+      futex_fatal_error ();
+    }
+#else
+  return ENOSYS;
+#endif
+}
+libc_hidden_def (__futex_abstimed_waitv_cancelable64)
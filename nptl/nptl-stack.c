@@ -22,6 +22,7 @@
 
 size_t __nptl_stack_cache_maxsize = 40 * 1024 * 1024;
 int32_t __nptl_stack_hugetlb = 1;
+size_t __nptl_stack_prefault;
 
 void
 __nptl_stack_list_del (list_t *elem)
@@ -57,40 +58,44 @@ void
 __nptl_free_stacks (size_t limit)
 {
   /* We reduce the size of the cache.  Remove the last entries until
-     the size is below the limit.  */
-  list_t *entry;
-  list_t *prev;
-
-  /* Search from the end of the list.  */
-  list_for_each_prev_safe (entry, prev, &GL (dl_stack_cache))
+     the size is below the limit.  Start with the largest stacks, which
+     are the least likely to be reused.  */
+  for (int class = DL_STACK_CACHE_CLASSES - 1; class >= 0; --class)
     {
-      struct pthread *curr;
+      list_t *entry;
+      list_t *prev;
 
-      curr = list_entry (entry, struct pthread, list);
-      if (__nptl_stack_in_use (curr))
+      /* Search from the end of the list.  */
+      list_for_each_prev_safe (entry, prev, &GL (dl_stack_cache)[class])
 	{
-	  /* Unlink the block.  */
-	  __nptl_stack_list_del (entry);
-
-	  /* Account for the freed memory.  */
-	  GL (dl_stack_cache_actsize) -= curr->stackblock_size;
-
-	  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
-	    GLRO (dl_debug_printf) (
-		"TCB cache full, deallocating: TID=%ld, TCB=0x%lx\n",
-		(long int) curr->tid, (unsigned long int) curr);
-
-	  /* Free the memory associated with the ELF TLS.  */
-	  _dl_deallocate_tls (TLS_TPADJ (curr), false);
-
-	  /* Remove this block.  This should never fail.  If it does
-	     something is really wrong.  */
-	  if (__munmap (curr->stackblock, curr->stackblock_size) != 0)
-	    abort ();
-
-	  /* Maybe we have freed enough.  */
-	  if (GL (dl_stack_cache_actsize) <= limit)
-	    break;
+	  struct pthread *curr;
+
+	  curr = list_entry (entry, struct pthread, list);
+	  if (__nptl_stack_in_use (curr))
+	    {
+	      /* Unlink the block.  */
+	      __nptl_stack_list_del (entry);
+
+	      /* Account for the freed memory.  */
+	      GL (dl_stack_cache_actsize) -= curr->stackblock_size;
+
+	      if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
+		GLRO (dl_debug_printf) (
+		    "TCB cache full, deallocating: TID=%ld, TCB=0x%lx\n",
+		    (long int) curr->tid, (unsigned long int) curr);
+
+	      /* Free the memory associated with the ELF TLS.  */
+	      _dl_deallocate_tls (TLS_TPADJ (curr), false);
+
+	      /* Remove this block.  This should never fail.  If it does
+		 something is really wrong.  */
+	      if (__munmap (curr->stackblock, curr->stackblock_size) != 0)
+		abort ();
+
+	      /* Maybe we have freed enough.  */
+	      if (GL (dl_stack_cache_actsize) <= limit)
+		return;
+	    }
 	}
     }
 }
@@ -110,7 +115,9 @@ queue_stack (struct pthread *stack)
   /* We unconditionally add the stack to the list.  The memory may
      still be in use but it will not be reused until the kernel marks
      the stack as not used anymore.  */
-  __nptl_stack_list_add (&stack->list, &GL (dl_stack_cache));
+  __nptl_stack_list_add (&stack->list,
+			 &GL (dl_stack_cache)[__nptl_stack_cache_class
+					      (stack->stackblock_size)]);
 
   GL (dl_stack_cache_actsize) += stack->stackblock_size;
   if (__glibc_unlikely (GL (dl_stack_cache_actsize)
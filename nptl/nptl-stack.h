@@ -23,6 +23,7 @@
 #include <ldsodefs.h>
 #include <list.h>
 #include <stdbool.h>
+#include <sys/param.h>
 
 /* Maximum size of the cache, in bytes.  40 MiB by default.  */
 extern size_t __nptl_stack_cache_maxsize attribute_hidden;
@@ -30,6 +31,29 @@ extern size_t __nptl_stack_cache_maxsize attribute_hidden;
 /* Should allow stacks to use hugetlb. (1) is default.  */
 extern int32_t __nptl_stack_hugetlb;
 
+/* Number of bytes at the top of each stack which are prefaulted when the
+   stack is allocated, and kept when the thread exits.  0 by default.  */
+extern size_t __nptl_stack_prefault attribute_hidden;
+
+/* Stacks in the cache are kept in GL (dl_stack_cache)[CLASS], where
+   CLASS is the binary logarithm of their size in units of
+   2**NPTL_STACK_CACHE_CLASS_SHIFT bytes.  All stacks in the next class
+   are larger than a stack of the current class, but less than four times
+   as large, which is the limit for reusing a cached stack.  */
+#define NPTL_STACK_CACHE_CLASS_SHIFT 16
+
+/* Return the size class of a stack of SIZE bytes.  */
+static inline unsigned int
+__nptl_stack_cache_class (size_t size)
+{
+  size >>= NPTL_STACK_CACHE_CLASS_SHIFT;
+  if (size == 0)
+    return 0;
+  unsigned int class = sizeof (unsigned long int) * 8 - 1
+		       - __builtin_clzl (size);
+  return MIN (class, DL_STACK_CACHE_CLASSES - 1);
+}
+
 /* Check whether the stack is still used or not.  */
 static inline bool
 __nptl_stack_in_use (struct pthread *pd)
@@ -42,7 +66,7 @@ void __nptl_stack_list_del (list_t *elem);
 libc_hidden_proto (__nptl_stack_list_del)
 
 /* Add ELEM to a stack list.  LIST can be either &GL (dl_stack_used)
-   or &GL (dl_stack_cache).  */
+   or one of the &GL (dl_stack_cache)[CLASS].  */
 void __nptl_stack_list_add (list_t *elem, list_t *list);
 libc_hidden_proto (__nptl_stack_list_add)
 
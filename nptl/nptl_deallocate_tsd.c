@@ -15,8 +15,13 @@
    License along with the GNU C Library; if not, see
    <https://www.gnu.org/licenses/>.  */
 
+#include <limits.h>
 #include <pthreadP.h>
 
+_Static_assert (PTHREAD_KEY_1STLEVEL_SIZE
+		<= sizeof (unsigned int) * CHAR_BIT,
+		"specific_used has a bit for each second-level block");
+
 /* Deallocate POSIX thread-local-storage.  */
 void
 __nptl_deallocate_tsd (void)
@@ -25,62 +30,60 @@ __nptl_deallocate_tsd (void)
 
   /* Maybe no data was ever allocated.  This happens often so we have
      a flag for this.  */
-  if (THREAD_GETMEM (self, specific_used))
+  unsigned int used = THREAD_GETMEM (self, specific_used);
+  if (used != 0)
     {
-      size_t round;
-      size_t cnt;
+      /* The second-level blocks to free at the end.  */
+      unsigned int allocated = used;
+      size_t round = 0;
 
-      round = 0;
       do
         {
-          size_t idx;
-
           /* So far no new nonzero data entry.  */
-          THREAD_SETMEM (self, specific_used, false);
+          THREAD_SETMEM (self, specific_used, 0);
 
-          for (cnt = idx = 0; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
+          /* Only visit the blocks in which data was set.  */
+          while (used != 0)
             {
-              struct pthread_key_data *level2;
-
-              level2 = THREAD_GETMEM_NC (self, specific, cnt);
-
-              if (level2 != NULL)
+              unsigned int cnt = __builtin_ctz (used);
+              used &= used - 1;
+
+              struct pthread_key_data *level2
+                = THREAD_GETMEM_NC (self, specific, cnt);
+              size_t idx = cnt * PTHREAD_KEY_2NDLEVEL_SIZE;
+              for (size_t inner = 0; inner < PTHREAD_KEY_2NDLEVEL_SIZE;
+                   ++inner, ++idx)
                 {
-                  size_t inner;
+                  void *data = level2[inner].data;
 
-                  for (inner = 0; inner < PTHREAD_KEY_2NDLEVEL_SIZE;
-                       ++inner, ++idx)
+                  if (data != NULL)
                     {
-                      void *data = level2[inner].data;
-
-                      if (data != NULL)
-                        {
-                          /* Always clear the data.  */
-                          level2[inner].data = NULL;
-
-                          /* Make sure the data corresponds to a valid
-                             key.  This test fails if the key was
-                             deallocated and also if it was
-                             re-allocated.  It is the user's
-                             responsibility to free the memory in this
-                             case.  */
-                          if (level2[inner].seq
-                              == __pthread_keys[idx].seq
-                              /* It is not necessary to register a destructor
-                                 function.  */
-                              && __pthread_keys[idx].destr != NULL)
-                            /* Call the user-provided destructor.  */
-                            __pthread_keys[idx].destr (data);
-                        }
+                      /* Always clear the data.  */
+                      level2[inner].data = NULL;
+
+                      /* Make sure the data corresponds to a valid
+                         key.  This test fails if the key was
+                         deallocated and also if it was
+                         re-allocated.  It is the user's
+                         responsibility to free the memory in this
+                         case.  */
+                      if (level2[inner].seq
+                          == __pthread_keys[idx].seq
+                          /* It is not necessary to register a destructor
+                             function.  */
+                          && __pthread_keys[idx].destr != NULL)
+                        /* Call the user-provided destructor.  */
+                        __pthread_keys[idx].destr (data);
                     }
                 }
-              else
-                idx += PTHREAD_KEY_1STLEVEL_SIZE;
             }
 
-          if (THREAD_GETMEM (self, specific_used) == 0)
+          /* The destructors may have set data again.  */
+          used = THREAD_GETMEM (self, specific_used);
+          if (used == 0)
             /* No data has been modified.  */
             goto just_free;
+          allocated |= used;
         }
       /* We only repeat the process a fixed number of times.  */
       while (__builtin_expect (++round < PTHREAD_DESTRUCTOR_ITERATIONS, 0));
@@ -90,22 +93,18 @@ __nptl_deallocate_tsd (void)
               sizeof (self->specific_1stblock));
 
     just_free:
-      /* Free the memory for the other blocks.  */
-      for (cnt = 1; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
+      /* Free the memory for the other blocks.  The first block is
+         allocated as part of the thread descriptor.  */
+      allocated &= ~1U;
+      while (allocated != 0)
         {
-          struct pthread_key_data *level2;
-
-          level2 = THREAD_GETMEM_NC (self, specific, cnt);
-          if (level2 != NULL)
-            {
-              /* The first block is allocated as part of the thread
-                 descriptor.  */
-              free (level2);
-              THREAD_SETMEM_NC (self, specific, cnt, NULL);
-            }
+          unsigned int cnt = __builtin_ctz (allocated);
+          allocated &= allocated - 1;
+          free (THREAD_GETMEM_NC (self, specific, cnt));
+          THREAD_SETMEM_NC (self, specific, cnt, NULL);
         }
 
-      THREAD_SETMEM (self, specific_used, false);
+      THREAD_SETMEM (self, specific_used, 0);
     }
 }
 libc_hidden_def (__nptl_deallocate_tsd)
@@ -0,0 +1,35 @@
+/* Enable fast spawning in a POSIX thread attribute.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthreadP.h>
+
+int
+pthread_attr_setfastspawn_np (pthread_attr_t *attr, int fastspawn)
+{
+  struct pthread_attr *iattr = (struct pthread_attr *) attr;
+
+  if (fastspawn == 1)
+    iattr->flags |= ATTR_FLAG_FAST_SPAWN;
+  else if (fastspawn == 0)
+    iattr->flags &= ~ATTR_FLAG_FAST_SPAWN;
+  else
+    return EINVAL;
+
+  return 0;
+}
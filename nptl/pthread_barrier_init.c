@@ -50,6 +50,19 @@ ___pthread_barrier_init (pthread_barrier_t *barrier,
 
   ibarrier = (struct pthread_barrier *) barrier;
 
+  /* Use a combining tree for large process-private barriers.  If the
+     count is beyond the range of trees, or the tree cannot be allocated,
+     fall back to the default algorithm.  */
+  if (count >= BARRIER_TREE_THRESHOLD
+      && iattr->pshared == PTHREAD_PROCESS_PRIVATE
+      && __pthread_barrier_tree_create (&ibarrier->tree, count) == 0)
+    {
+      ibarrier->count = 0;
+      ibarrier->shared = FUTEX_PRIVATE;
+      ibarrier->out = 0;
+      return 0;
+    }
+
   /* Initialize the individual fields.  */
   ibarrier->in = 0;
   ibarrier->out = 0;
@@ -0,0 +1,347 @@
+/* Combining-tree barriers.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <errno.h>
+#include <futex-internal.h>
+#include <pthreadP.h>
+#include <rseq-internal.h>
+#include <sys/mman.h>
+
+/* With many threads, the barrier algorithm in pthread_barrier_wait makes
+   all threads update the same cache line to enter the barrier, and wakes
+   all of them with one futex_wake, which serializes a round on that cache
+   line.  Process-private barriers for at least BARRIER_TREE_THRESHOLD
+   and at most BARRIER_TREE_MAX threads instead use a combining tree,
+   which is allocated by pthread_barrier_init.
+
+   The leaves of the tree have room for up to TREE_LEAF_SIZE threads each,
+   and the capacities of all leaves add up to COUNT.  Each inner node
+   combines up to TREE_FANIN children.  Threads do not have fixed
+   positions in the tree, because any thread can use the barrier in any
+   round.  A thread starts at a leaf chosen by the CPU it runs on and
+   claims a slot in the first leaf which has one left, probing the
+   following leaves if a leaf is full.  Exactly COUNT slots are claimed in
+   each round, so all leaves fill up.  The thread filling up a node
+   resets it for the next round and moves on to the parent node, where it
+   increments the number of children which have arrived.  The thread
+   which completes the root completes the round.
+
+   Each round has a generation number, GENERATION.  The arrival word of a
+   leaf contains the generation it is used for in the upper bits, so that
+   a thread which is still probing for a slot does not claim a slot in a
+   leaf that has been reset for the next round already.  Each leaf has its
+   own release word, which contains the number of the last generation
+   completed for the threads in this leaf.  The thread completing a round
+   advances GENERATION and then the release words of all leaves, so that
+   waiters spin on their leaf only, and only wake up from futex_wait
+   those leaves where threads stopped spinning.  The lowest bit of
+   GENERATION and of the release words is set if there are threads
+   blocked in futex_wait on the word.
+
+   If more than COUNT threads use the barrier at the same time, the
+   threads finding all leaves full wait on GENERATION for the next round.
+
+   pthread_barrier_destroy must not unmap the tree while threads are still
+   leaving the barrier.  Each thread increments the LEFT counter of its
+   leaf once it is done with the tree.  After G rounds, the LEFT counter
+   of a leaf with capacity C is C * G, and pthread_barrier_destroy waits
+   for this.  The lowest bit of LEFT is set if pthread_barrier_destroy
+   waits on it.
+
+   All generation numbers and counters are modulo 2^31, except for the
+   generation in the arrival words, which is modulo 2^16.  */
+
+#define TREE_LEAF_SIZE 8
+#define TREE_FANIN 4
+
+#define TREE_ROOT UINT_MAX
+
+struct barrier_tree_node
+{
+  /* For leaves, the generation (modulo 2^16) in the upper and the number
+     of claimed slots in the lower 16 bits.  For inner nodes, the number
+     of children which have arrived.  */
+  unsigned int arrive;
+  /* Number of slots or children.  */
+  unsigned int capacity;
+  /* Index of the parent node, or TREE_ROOT.  */
+  unsigned int parent;
+  /* Leaves only: the generation completed last, shifted left by one,
+     and the futex waiters bit.  */
+  unsigned int release;
+  /* Leaves only: the number of threads which have left the barrier,
+     shifted left by one, and the futex waiters bit.  */
+  unsigned int left;
+} __attribute__ ((aligned (64)));
+
+struct pthread_barrier_tree
+{
+  /* The current generation, shifted left by one, and the futex waiters
+     bit.  */
+  unsigned int generation;
+  unsigned int nleaves;
+  size_t size;
+  /* The leaves come first, followed by the inner nodes in the order of
+     the levels.  The last node is the root.  */
+  struct barrier_tree_node nodes[];
+};
+
+#define TREE_GEN_MASK 0x7fffffffU
+#define TREE_ARRIVE_SHIFT 16
+#define TREE_ARRIVE_MASK 0xffffU
+
+/* Allocate a tree for COUNT threads and store it in *TREEP.  Return 0 on
+   success, EINVAL if COUNT is out of the range of tree barriers, or
+   ENOMEM if the tree cannot be allocated.  */
+int
+__pthread_barrier_tree_create (struct pthread_barrier_tree **treep,
+			       unsigned int count)
+{
+  if (count < BARRIER_TREE_THRESHOLD || count > BARRIER_TREE_MAX)
+    return EINVAL;
+
+  unsigned int nleaves = (count + TREE_LEAF_SIZE - 1) / TREE_LEAF_SIZE;
+  size_t nnodes = 0;
+  for (size_t n = nleaves; n > 1; n = (n + TREE_FANIN - 1) / TREE_FANIN)
+    nnodes += n;
+  ++nnodes;
+
+  size_t size = (sizeof (struct pthread_barrier_tree)
+		 + nnodes * sizeof (struct barrier_tree_node));
+  struct pthread_barrier_tree *tree
+    = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (tree == MAP_FAILED)
+    return ENOMEM;
+  tree->nleaves = nleaves;
+  tree->size = size;
+
+  /* Spread COUNT evenly over the leaves.  */
+  for (unsigned int i = 0; i < nleaves; ++i)
+    tree->nodes[i].capacity = (count / nleaves
+			       + (i < count % nleaves ? 1 : 0));
+
+  /* Link each level to the next.  */
+  size_t first = 0;
+  for (size_t n = nleaves; n > 1; )
+    {
+      size_t up = (n + TREE_FANIN - 1) / TREE_FANIN;
+      for (size_t i = 0; i < n; ++i)
+	{
+	  tree->nodes[first + i].parent = first + n + i / TREE_FANIN;
+	  ++tree->nodes[first + n + i / TREE_FANIN].capacity;
+	}
+      first += n;
+      n = up;
+    }
+  tree->nodes[nnodes - 1].parent = TREE_ROOT;
+
+  *treep = tree;
+  return 0;
+}
+
+/* Return the leaf at which the calling thread starts looking for a
+   slot.  Threads running on nearby CPUs share leaves.  */
+static unsigned int
+tree_start_leaf (struct pthread_barrier_tree *tree)
+{
+  int cpu = rseq_current_cpu ();
+  if (cpu < 0)
+    cpu = THREAD_GETMEM (THREAD_SELF, tid);
+  return ((unsigned int) cpu / TREE_LEAF_SIZE) % tree->nleaves;
+}
+
+/* Claim a slot in a leaf in generation GEN.  Return the leaf, and store
+   the number of slots claimed in it including ours in *ARRIVED.  Return
+   NULL if all leaves are full.  */
+static struct barrier_tree_node *
+tree_claim (struct pthread_barrier_tree *tree, unsigned int gen,
+	    unsigned int *arrived)
+{
+  unsigned int start = tree_start_leaf (tree);
+  unsigned int tag = (gen & TREE_ARRIVE_MASK) << TREE_ARRIVE_SHIFT;
+  for (unsigned int i = 0; i < tree->nleaves; ++i)
+    {
+      struct barrier_tree_node *leaf
+	= &tree->nodes[(start + i) % tree->nleaves];
+      unsigned int v = atomic_load_relaxed (&leaf->arrive);
+      /* Release MO to propagate our pre-barrier effects to the thread
+	 completing the leaf, which uses an acquire MO fence.  */
+      while ((v & ~TREE_ARRIVE_MASK) == tag
+	     && (v & TREE_ARRIVE_MASK) < leaf->capacity)
+	if (atomic_compare_exchange_weak_release (&leaf->arrive, &v, v + 1))
+	  {
+	    *arrived = (v & TREE_ARRIVE_MASK) + 1;
+	    return leaf;
+	  }
+    }
+  return NULL;
+}
+
+/* Return true if the generation in word value V is GEN or later.  A
+   release word can lag behind GENERATION by one round, and, if more than
+   COUNT threads use the barrier, get ahead of a thread which has not
+   noticed the end of its round yet.  */
+static inline bool
+tree_reached (unsigned int v, unsigned int gen)
+{
+  return (((v >> 1) - gen) & TREE_GEN_MASK) < (TREE_GEN_MASK >> 1);
+}
+
+/* Block on WORD until the generation in it is GEN or later, spinning
+   first.  WORD is GENERATION or a release word.  */
+static void
+tree_wait_generation (unsigned int *word, unsigned int gen)
+{
+  int max_cnt = max_adaptive_count ();
+  unsigned int v;
+  for (int cnt = 0; cnt < max_cnt; ++cnt)
+    {
+      if (tree_reached (atomic_load_relaxed (word), gen))
+	goto done;
+      atomic_spin_nop ();
+    }
+  v = atomic_load_relaxed (word);
+  while (!tree_reached (v, gen))
+    {
+      if ((v & 1) == 0
+	  && !atomic_compare_exchange_weak_relaxed (word, &v, v | 1))
+	continue;
+      futex_wait_simple (word, v | 1, FUTEX_PRIVATE);
+      v = atomic_load_relaxed (word);
+    }
+ done:
+  /* Synchronize with the thread which completed the round.  */
+  atomic_thread_fence_acquire ();
+}
+
+/* Complete generation GEN.  */
+static void
+tree_release (struct pthread_barrier_tree *tree, unsigned int gen)
+{
+  unsigned int next = ((gen + 1) & TREE_GEN_MASK) << 1;
+  /* Release MO so that threads starting the next round find the nodes
+     reset.  */
+  unsigned int old = atomic_exchange_release (&tree->generation, next);
+  for (unsigned int i = 0; i < tree->nleaves; ++i)
+    {
+      /* If more than COUNT threads use the barrier, they can start and
+	 complete the next round as soon as GENERATION is advanced, so the
+	 release word may be ahead of us already, and we must not move it
+	 back.  */
+      unsigned int *release = &tree->nodes[i].release;
+      unsigned int v = atomic_load_relaxed (release);
+      while (!tree_reached (v, (gen + 1) & TREE_GEN_MASK))
+	if (atomic_compare_exchange_weak_release (release, &v, next))
+	  {
+	    if (v & 1)
+	      futex_wake (release, INT_MAX, FUTEX_PRIVATE);
+	    break;
+	  }
+    }
+  if (old & 1)
+    futex_wake (&tree->generation, INT_MAX, FUTEX_PRIVATE);
+}
+
+int
+__pthread_barrier_tree_wait (struct pthread_barrier_tree *tree)
+{
+  struct barrier_tree_node *leaf;
+  unsigned int gen;
+  unsigned int arrived;
+
+  for (;;)
+    {
+      /* Acquire MO so that we see the nodes reset for GEN.  */
+      gen = atomic_load_acquire (&tree->generation) >> 1;
+      leaf = tree_claim (tree, gen, &arrived);
+      if (leaf != NULL)
+	break;
+      /* More than COUNT threads use the barrier.  Wait for the next
+	 round.  */
+      tree_wait_generation (&tree->generation, (gen + 1) & TREE_GEN_MASK);
+    }
+
+  int result = 0;
+  if (arrived < leaf->capacity)
+    tree_wait_generation (&leaf->release, (gen + 1) & TREE_GEN_MASK);
+  else
+    {
+      /* We filled up LEAF.  Reset it for the next round, and climb up as
+	 long as we complete nodes.  The release MO of the RMWs on the
+	 inner nodes orders the resets before the next round.  */
+      atomic_thread_fence_acquire ();
+      atomic_store_relaxed (&leaf->arrive,
+			    ((gen + 1) & TREE_ARRIVE_MASK)
+			    << TREE_ARRIVE_SHIFT);
+      struct barrier_tree_node *node = leaf;
+      bool complete = true;
+      while (node->parent != TREE_ROOT)
+	{
+	  node = &tree->nodes[node->parent];
+	  if (atomic_fetch_add_acq_rel (&node->arrive, 1) + 1
+	      < node->capacity)
+	    {
+	      complete = false;
+	      break;
+	    }
+	  atomic_store_relaxed (&node->arrive, 0);
+	}
+      if (complete)
+	{
+	  tree_release (tree, gen);
+	  result = PTHREAD_BARRIER_SERIAL_THREAD;
+	}
+      else
+	tree_wait_generation (&leaf->release, (gen + 1) & TREE_GEN_MASK);
+    }
+
+  /* Confirm that we left.  Release MO so that our use of the tree happens
+     before pthread_barrier_destroy unmaps it.  */
+  if (atomic_fetch_add_release (&leaf->left, 2) & 1)
+    futex_wake (&leaf->left, INT_MAX, FUTEX_PRIVATE);
+
+  return result;
+}
+
+void
+__pthread_barrier_tree_destroy (struct pthread_barrier_tree *tree)
+{
+  /* No thread is blocked on the barrier, so no round is in progress.
+     Wait until all threads of the rounds so far have left.  */
+  unsigned int gen = atomic_load_relaxed (&tree->generation) >> 1;
+  for (unsigned int i = 0; i < tree->nleaves; ++i)
+    {
+      struct barrier_tree_node *leaf = &tree->nodes[i];
+      unsigned int expected = (leaf->capacity * gen) & TREE_GEN_MASK;
+      unsigned int v = atomic_load_relaxed (&leaf->left);
+      while (((v >> 1) & TREE_GEN_MASK) != expected)
+	{
+	  if ((v & 1) == 0
+	      && !atomic_compare_exchange_weak_relaxed (&leaf->left, &v,
+							v | 1))
+	    continue;
+	  futex_wait_simple (&leaf->left, v | 1, FUTEX_PRIVATE);
+	  v = atomic_load_relaxed (&leaf->left);
+	}
+    }
+  /* Synchronize with the threads which left.  */
+  atomic_thread_fence_acquire ();
+  __munmap (tree, tree->size);
+}
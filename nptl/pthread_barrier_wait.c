@@ -87,6 +87,8 @@
      pthread_barrier_destroy will of course wait for the signal handler thread
      to confirm that it left the barrier.
 
+   Large barriers use a combining tree instead, see pthread_barrier_tree.c.
+
    TODO We should add spinning with back-off.  Once we do that, we could also
    try to avoid the futex_wake syscall when a round is detected as finished.
    If we do not spin, it is quite likely that at least some other threads will
@@ -96,6 +98,9 @@ ___pthread_barrier_wait (pthread_barrier_t *barrier)
 {
   struct pthread_barrier *bar = (struct pthread_barrier *) barrier;
 
+  if (__glibc_unlikely (bar->count == 0))
+    return __pthread_barrier_tree_wait (bar->tree);
+
   /* How many threads entered so far, including ourself.  */
   unsigned int i;
 
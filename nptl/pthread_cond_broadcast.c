@@ -29,6 +29,32 @@
 #include "pthread_cond_common.c"
 
 
+/* Wake all waiters blocked on the futex of group G, whose __g_signals is
+   SIGNALS.  All of them will acquire the mutex next, so if the mutex allows
+   it (see __pthread_cond_wait_common), wake only one of them and requeue
+   the others to the mutex.  Each of them then gets woken by the unlock of
+   the mutex by the previous one, instead of all of them contending for it
+   at once.  The woken waiter reacquires the mutex with
+   __pthread_mutex_cond_lock, which marks it as having waiters, so the
+   requeued waiters do not miss that unlock.  If the futex word has changed
+   in the meantime, fall back to waking all waiters.
+
+   Must be called while having acquired the condvar-internal lock, so that
+   the futex of G cannot be reused by a later group whose waiters do not
+   have a signal yet, and which thus would not acquire the mutex after being
+   woken.  */
+static void
+__condvar_wake_group (pthread_cond_t *cond, unsigned int g,
+		      unsigned int signals, int private)
+{
+  pthread_mutex_t *mutex = atomic_load_relaxed (&cond->__data.__mutex);
+  if (mutex != NULL
+      && futex_requeue (cond->__data.__g_signals + g, signals, 1, INT_MAX,
+			(unsigned int *) &mutex->__data.__lock, private))
+    return;
+  futex_wake (cond->__data.__g_signals + g, INT_MAX, private);
+}
+
 /* We do the following steps from __pthread_cond_signal in one critical
    section: (1) signal all waiters in G1, (2) close G1 so that it can become
    the new G2 and make G2 the new G1, and (3) signal all waiters in the new
@@ -47,6 +73,10 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   __condvar_acquire_lock (cond, private);
 
   unsigned long long int wseq = __condvar_load_wseq_relaxed (cond);
+  /* Synchronize with the release fence in __pthread_cond_wait_common, so
+     that we see the __mutex stored by all waiters that we are going to
+     wake.  */
+  atomic_thread_fence_acquire ();
   unsigned int g2 = wseq & 1;
   unsigned int g1 = g2 ^ 1;
   wseq >>= 1;
@@ -56,15 +86,17 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   if (cond->__data.__g_size[g1] != 0)
     {
       /* Add as many signals as the remaining size of the group.  */
-      atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
-				cond->__data.__g_size[g1]);
+      unsigned int signals
+	= atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
+				    cond->__data.__g_size[g1]);
+      signals += cond->__data.__g_size[g1];
       cond->__data.__g_size[g1] = 0;
 
       /* We need to wake G1 waiters before we switch G1 below.  */
       /* TODO Only set it if there are indeed futex waiters.  We could
 	 also try to move this out of the critical section in cases when
 	 G2 is empty (and we don't need to quiesce).  */
-      futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
+      __condvar_wake_group (cond, g1, signals, private);
     }
 
   /* G1 is complete.  Step (2) is next unless there are no waiters in G2, in
@@ -72,11 +104,18 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   if (__condvar_switch_g1 (cond, wseq, &g1, private))
     {
       /* Step (3): Send signals to all waiters in the old G2 / new G1.  */
-      atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
-				cond->__data.__g_size[g1]);
+      unsigned int signals
+	= atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
+				    cond->__data.__g_size[g1]);
+      signals += cond->__data.__g_size[g1];
       cond->__data.__g_size[g1] = 0;
       /* TODO Only set it if there are indeed futex waiters.  */
-      do_futex_wake = true;
+      if (atomic_load_relaxed (&cond->__data.__mutex) != NULL)
+	/* Requeueing has to happen in the critical section, see
+	   __condvar_wake_group.  */
+	__condvar_wake_group (cond, g1, signals, private);
+      else
+	do_futex_wake = true;
     }
 
   __condvar_release_lock (cond, private);
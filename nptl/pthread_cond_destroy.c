@@ -36,7 +36,11 @@
    signal or broadcast calls.
    Thus, we can assume that all waiters that are still accessing the condvar
    have been woken.  We wait until they have confirmed to have woken up by
-   decrementing __wrefs.  */
+   decrementing __wrefs.
+
+   pthread_cond_broadcast may have requeued waiters to the mutex, where they
+   would only wake up when the mutex is released.  The caller may hold the
+   mutex, so wake them up; they confirm and then block on the mutex.  */
 int
 __pthread_cond_destroy (pthread_cond_t *cond)
 {
@@ -48,6 +52,9 @@ __pthread_cond_destroy (pthread_cond_t *cond)
      that they finished.  */
   unsigned int wrefs = atomic_fetch_or_acquire (&cond->__data.__wrefs, 4);
   int private = __condvar_get_private (wrefs);
+  pthread_mutex_t *mutex = atomic_load_relaxed (&cond->__data.__mutex);
+  if (wrefs >> 3 != 0 && mutex != NULL)
+    futex_wake ((unsigned int *) &mutex->__data.__lock, INT_MAX, private);
   while (wrefs >> 3 != 0)
     {
       futex_wait_simple (&cond->__data.__wrefs, wrefs, private);
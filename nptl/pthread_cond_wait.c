@@ -272,6 +272,12 @@ __condvar_cleanup_waiting (void *arg)
      * Simple reference count used by both waiters and pthread_cond_destroy.
      (If the format of __wrefs is changed, update nptl_lock_constants.pysym
       and the pretty printers.)
+   __mutex: The mutex used by the most recent waiter.
+     * NULL if the condvar is process-shared or the mutex is of a kind that
+       pthread_cond_broadcast cannot requeue waiters to.
+     * Stored by waiters before they acquire a position in __wseq.  Because
+       POSIX does not allow concurrent waiters to use different mutexes, all
+       waiters that a broadcast wakes use this mutex.
    For each of the two groups, we have:
    __g_signals: The number of signals that can still be consumed, relative to
      the current g1_start.  (i.e. g1_start with the signal count added)
@@ -332,6 +338,7 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
 {
   int err;
   int result = 0;
+  uint64_t profile = 0;
 
   LIBC_PROBE (cond_wait, 2, cond, mutex);
 
@@ -340,6 +347,22 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
      don't use it if abstime is NULL, so we don't need to check it
      here. */
 
+  /* Record the mutex so that pthread_cond_broadcast can requeue us to it.
+     This is only possible for the mutex kinds that are acquired by
+     __pthread_mutex_cond_lock through a plain lll_cond_lock on __lock, and
+     if both the condvar and the mutex are process-private.  The release
+     fence makes the store visible to broadcasts that observe our position
+     in __wseq.  */
+  pthread_mutex_t *requeue_mutex = NULL;
+  if (__condvar_get_private (atomic_load_relaxed (&cond->__data.__wrefs))
+      == FUTEX_PRIVATE
+      && PTHREAD_MUTEX_PSHARED (mutex) == LLL_PRIVATE
+      && (PTHREAD_MUTEX_TYPE (mutex) & ~PTHREAD_MUTEX_KIND_MASK_NP) == 0)
+    requeue_mutex = mutex;
+  if (atomic_load_relaxed (&cond->__data.__mutex) != requeue_mutex)
+    atomic_store_relaxed (&cond->__data.__mutex, requeue_mutex);
+  atomic_thread_fence_release ();
+
   /* Acquire a position (SEQ) in the waiter sequence (WSEQ).  We use an
      atomic operation because signals and broadcasts may update the group
      switch without acquiring the mutex.  We do not need release MO here
@@ -418,6 +441,7 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
       cbuffer.private = private;
       __pthread_cleanup_push (&buffer, __condvar_cleanup_waiting, &cbuffer);
 
+      lock_profile_wait (&profile);
       err = __futex_abstimed_wait_cancelable64 (
         cond->__data.__g_signals + g, signals, clockid, abstime, private);
 
@@ -437,6 +461,9 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
      mutex.  */
   __condvar_confirm_wakeup (cond, private);
 
+  lock_profile_done (cond, LOCK_PROFILE_COND, __builtin_return_address (0),
+		     profile);
+
   /* Woken up; now re-acquire the mutex.  If this doesn't fail, return RESULT,
      which is set to ETIMEDOUT if a timeout occurred, or zero otherwise.  */
   err = __pthread_mutex_cond_lock (mutex);
@@ -376,8 +376,13 @@ start_thread (void *arg)
   /* Initialize pointers to locale data.  */
   __ctype_init ();
 
+  /* Threads created with pthread_attr_setfastspawn_np skip the system
+     calls below which are not needed to run plain computations.  */
+  bool fast_spawn = THREAD_GETMEM (pd, flags) & ATTR_FLAG_FAST_SPAWN;
+
   /* Name the thread stack if kernel supports it.  */
-  name_stack_maps (pd, true);
+  if (!fast_spawn)
+    name_stack_maps (pd, true);
 
   /* Register rseq TLS to the kernel.  */
   {
@@ -387,7 +392,9 @@ start_thread (void *arg)
   }
 
 #ifndef __ASSUME_SET_ROBUST_LIST
-  if (__nptl_set_robust_list_avail)
+  if (__nptl_set_robust_list_avail && !fast_spawn)
+#else
+  if (!fast_spawn)
 #endif
     {
       /* This call should never fail because the initial call in init.c
@@ -573,7 +580,9 @@ start_thread (void *arg)
      to avoid creating a new free-state block during thread release.  */
   __getrandom_vdso_release (pd);
 
-  if (pd->stack_mode != ALLOCATE_GUARD_USER)
+  /* A fast-spawn thread leaves its stack as it is for the next thread
+     which reuses it.  */
+  if (pd->stack_mode != ALLOCATE_GUARD_USER && !fast_spawn)
     advise_stack_range (pd->stackblock, pd->stackblock_size, (uintptr_t) pd,
 			pd->guardsize);
 
@@ -598,7 +607,8 @@ start_thread (void *arg)
     __nptl_free_tcb (pd);
 
   /* Remove the associated name from the thread stack.  */
-  name_stack_maps (pd, false);
+  if (!fast_spawn)
+    name_stack_maps (pd, false);
 
   pd->tid = 0;
 
@@ -715,8 +725,12 @@ __pthread_create_2_1 (pthread_t *newthread, const pthread_attr_t *attr,
 	       | (self->flags & (ATTR_FLAG_SCHED_SET | ATTR_FLAG_POLICY_SET)));
 
   /* Inherit rseq registration state.  Without seccomp filters, rseq
-     registration will either always fail or always succeed.  */
-  if ((int) RSEQ_GETMEM_ONCE (cpu_id) >= 0)
+     registration will either always fail or always succeed.  A
+     fast-spawn thread is not registered itself, but __rseq_size tells
+     whether the initial thread is.  */
+  if ((iattr->flags & ATTR_FLAG_FAST_SPAWN) == 0
+      && ((self->flags & ATTR_FLAG_FAST_SPAWN) != 0
+	  ? __rseq_size != 0 : (int) RSEQ_GETMEM_ONCE (cpu_id) >= 0))
     pd->flags |= ATTR_FLAG_DO_RSEQ;
 
   /* Initialize the field for the ID of the thread which is waiting
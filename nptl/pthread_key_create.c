@@ -23,7 +23,10 @@
 int
 ___pthread_key_create (pthread_key_t *key, void (*destr) (void *))
 {
-  /* Find a slot in __pthread_keys which is unused.  */
+  /* Find the first slot in __pthread_keys which is unused.  This keeps
+     the keys dense, so that most keys are in the first block of keys in
+     the thread descriptor, whose data is accessed without indirection and
+     never needs to be allocated.  */
   for (size_t cnt = 0; cnt < PTHREAD_KEYS_MAX; ++cnt)
     {
       uintptr_t seq = __pthread_keys[cnt].seq;
@@ -0,0 +1,306 @@
+/* Lock contention profiler.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* If glibc.pthread.lock_profile_rate is set, the slow paths of
+   pthread_mutex_lock, of the rwlock lock functions and of the condition
+   variable wait functions sample one in lock_profile_rate acquisitions
+   which have to block.  Uncontended acquisitions are never sampled and
+   only pay for a check of the rate.  Each thread counts down to its next
+   sample.
+
+   For sampled acquisitions, the time from the first futex wait until the
+   lock is acquired is accumulated per lock, kind of wait and call site,
+   which is the return address of the public function.  For condition
+   variables, the time until the waiter is woken up or times out is
+   recorded instead.  pthread_lock_profile_dump_np writes the profile as
+   text.
+
+   The profile is a fixed-size hash table which is allocated on first use
+   and protected by a low-level lock, so that recording a sample does not
+   wait on a pthread lock and thus never recurses into the profiler.  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <not-cancel.h>
+#include <pthreadP.h>
+#include <setvmaname.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define LOCK_PROFILE_ENTRIES 4096
+
+struct lock_profile_entry
+{
+  void *lock;
+  void *site;
+  unsigned int kind;
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t max_ns;
+};
+
+unsigned int __nptl_lock_profile_rate;
+int __nptl_lock_profile_lock = LLL_LOCK_INITIALIZER;
+
+/* __nptl_lock_profile_lock protects the following variables.  The
+   table is allocated on first use.  An entry is unused if its count is
+   0.  */
+static struct lock_profile_entry *lock_profile_table;
+static size_t lock_profile_used;
+/* Samples which did not fit into the table.  */
+static uint64_t lock_profile_dropped;
+
+static const char *const lock_profile_kinds[] =
+  {
+    [LOCK_PROFILE_MUTEX] = "mutex",
+    [LOCK_PROFILE_RDLOCK] = "rdlock",
+    [LOCK_PROFILE_WRLOCK] = "wrlock",
+    [LOCK_PROFILE_COND] = "cond",
+  };
+
+static uint64_t
+lock_profile_now (void)
+{
+  struct __timespec64 ts;
+  __clock_gettime64 (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * UINT64_C (1000000000) + ts.tv_nsec;
+}
+
+uint64_t
+__nptl_lock_profile_wait (void)
+{
+  struct pthread *self = THREAD_SELF;
+  unsigned int countdown = THREAD_GETMEM (self, lock_profile_countdown);
+  if (countdown > 1)
+    {
+      THREAD_SETMEM (self, lock_profile_countdown, countdown - 1);
+      return LOCK_PROFILE_SKIP;
+    }
+  THREAD_SETMEM (self, lock_profile_countdown, __nptl_lock_profile_rate);
+
+  /* 0 and LOCK_PROFILE_SKIP have special meanings.  Neither is a
+     plausible time since boot.  */
+  return lock_profile_now ();
+}
+
+void
+__nptl_lock_profile_done (void *lock, unsigned int kind, void *site,
+			  uint64_t start)
+{
+  uint64_t ns = lock_profile_now () - start;
+
+  lll_lock (__nptl_lock_profile_lock, LLL_PRIVATE);
+
+  if (lock_profile_table == NULL)
+    {
+      size_t size = LOCK_PROFILE_ENTRIES * sizeof (*lock_profile_table);
+      void *p = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p != MAP_FAILED)
+	{
+	  __set_vma_name (p, size, " glibc: lock profile");
+	  lock_profile_table = p;
+	}
+    }
+
+  if (lock_profile_table != NULL)
+    {
+      /* Open addressing with linear probing.  Entries are never
+	 removed.  */
+      size_t h = ((((uintptr_t) lock >> 4) ^ (uintptr_t) site ^ kind)
+		  * 0x9e3779b1U) % LOCK_PROFILE_ENTRIES;
+      struct lock_profile_entry *e = NULL;
+      for (size_t i = 0; i < LOCK_PROFILE_ENTRIES; ++i)
+	{
+	  struct lock_profile_entry *c
+	    = &lock_profile_table[(h + i) % LOCK_PROFILE_ENTRIES];
+	  if (c->count == 0)
+	    {
+	      /* Keep some room so that probe sequences stay short.  */
+	      if (lock_profile_used < LOCK_PROFILE_ENTRIES * 3 / 4)
+		{
+		  c->lock = lock;
+		  c->site = site;
+		  c->kind = kind;
+		  ++lock_profile_used;
+		  e = c;
+		}
+	      break;
+	    }
+	  if (c->lock == lock && c->site == site && c->kind == kind)
+	    {
+	      e = c;
+	      break;
+	    }
+	}
+
+      if (e != NULL)
+	{
+	  ++e->count;
+	  e->total_ns += ns;
+	  if (ns > e->max_ns)
+	    e->max_ns = ns;
+	}
+      else
+	++lock_profile_dropped;
+    }
+  else
+    ++lock_profile_dropped;
+
+  lll_unlock (__nptl_lock_profile_lock, LLL_PRIVATE);
+}
+
+/* Restore the heap property of the min-heap of the first COUNT entries
+   of TABLE, ordered by total wait time, below entry I.  */
+static void
+lock_profile_sift_down (struct lock_profile_entry *table, size_t count,
+			size_t i)
+{
+  while (2 * i + 1 < count)
+    {
+      size_t child = 2 * i + 1;
+      if (child + 1 < count
+	  && table[child + 1].total_ns < table[child].total_ns)
+	++child;
+      if (table[i].total_ns <= table[child].total_ns)
+	break;
+      struct lock_profile_entry tmp = table[i];
+      table[i] = table[child];
+      table[child] = tmp;
+      i = child;
+    }
+}
+
+/* Sort the COUNT entries of TABLE by decreasing total wait time.  Unlike
+   qsort, this never calls malloc.  */
+static void
+lock_profile_sort (struct lock_profile_entry *table, size_t count)
+{
+  for (size_t i = count / 2; i > 0; --i)
+    lock_profile_sift_down (table, count, i - 1);
+  for (size_t n = count; n > 1; --n)
+    {
+      struct lock_profile_entry tmp = table[0];
+      table[0] = table[n - 1];
+      table[n - 1] = tmp;
+      lock_profile_sift_down (table, n - 1, 0);
+    }
+}
+
+/* Write the N bytes at BUF to FD, retrying after short writes and
+   interruptions.  Return 0 on success, or an error number.  The dump
+   does not use stdio, whose writes are cancellation points, nor
+   malloc.  */
+static int
+lock_profile_write_all (int fd, const char *buf, size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t written = __write_nocancel (fd, buf, n);
+      if (written < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return errno;
+	}
+      if (written == 0)
+	return EIO;
+      buf += written;
+      n -= written;
+    }
+  return 0;
+}
+
+/* Write the LEN bytes formatted into BUF of SIZE bytes to FD.  */
+static int
+lock_profile_write (int fd, const char *buf, size_t size, int len)
+{
+  if (len < 0)
+    return errno;
+  if ((size_t) len >= size)
+    len = size - 1;
+  return lock_profile_write_all (fd, buf, len);
+}
+
+int
+pthread_lock_profile_dump_np (int fd)
+{
+  struct lock_profile_entry *copy = NULL;
+  size_t count = 0;
+  size_t mapsize = 0;
+  uint64_t dropped;
+
+  lll_lock (__nptl_lock_profile_lock, LLL_PRIVATE);
+  dropped = lock_profile_dropped;
+  if (lock_profile_used > 0)
+    {
+      mapsize = lock_profile_used * sizeof (*copy);
+      copy = __mmap (NULL, mapsize, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (copy == MAP_FAILED)
+	{
+	  lll_unlock (__nptl_lock_profile_lock, LLL_PRIVATE);
+	  return errno;
+	}
+      for (size_t i = 0; i < LOCK_PROFILE_ENTRIES; ++i)
+	if (lock_profile_table[i].count != 0)
+	  copy[count++] = lock_profile_table[i];
+    }
+  lll_unlock (__nptl_lock_profile_lock, LLL_PRIVATE);
+
+  lock_profile_sort (copy, count);
+
+  char line[128];
+  int len = __snprintf (line, sizeof (line),
+			"lock profile: rate %u, %" PRIu64 " dropped\n"
+			"kind lock site count total_ns max_ns\n",
+			__nptl_lock_profile_rate, dropped);
+  int result = lock_profile_write (fd, line, sizeof (line), len);
+  for (size_t i = 0; result == 0 && i < count; ++i)
+    {
+      len = __snprintf (line, sizeof (line),
+			"%s %p %p %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+			lock_profile_kinds[copy[i].kind], copy[i].lock,
+			copy[i].site, copy[i].count, copy[i].total_ns,
+			copy[i].max_ns);
+      result = lock_profile_write (fd, line, sizeof (line), len);
+    }
+  if (copy != NULL)
+    __munmap (copy, mapsize);
+
+  /* The mappings are needed to symbolize the call sites.  */
+  if (result == 0)
+    {
+      len = __snprintf (line, sizeof (line), "\nMAPPED_LIBRARIES:\n");
+      result = lock_profile_write (fd, line, sizeof (line), len);
+    }
+  int maps = __open_nocancel ("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (maps >= 0)
+    {
+      char buf[1024];
+      ssize_t n;
+      while (result == 0
+	     && (n = __read_nocancel (maps, buf, sizeof (buf))) > 0)
+	result = lock_profile_write_all (fd, buf, n);
+      __close_nocancel_nostatus (maps);
+    }
+
+  return result;
+}
@@ -23,6 +23,7 @@
 #include <unistd.h>  /* Get STDOUT_FILENO for _dl_printf.  */
 #include <elf/dl-tunables.h>
 #include <nptl-stack.h>
+#include <pthreadP.h>
 
 struct mutex_config __mutex_aconf =
 {
@@ -50,6 +51,18 @@ TUNABLE_CALLBACK (set_stack_hugetlb) (tunable_val_t *valp)
   __nptl_stack_hugetlb = (int32_t) valp->numval;
 }
 
+static void
+TUNABLE_CALLBACK (set_stack_prefault) (tunable_val_t *valp)
+{
+  __nptl_stack_prefault = valp->numval;
+}
+
+static void
+TUNABLE_CALLBACK (set_lock_profile_rate) (tunable_val_t *valp)
+{
+  __nptl_lock_profile_rate = (int32_t) valp->numval;
+}
+
 void
 __pthread_tunables_init (void)
 {
@@ -59,4 +72,8 @@ __pthread_tunables_init (void)
                TUNABLE_CALLBACK (set_stack_cache_size));
   TUNABLE_GET (stack_hugetlb, int32_t,
 	       TUNABLE_CALLBACK (set_stack_hugetlb));
+  TUNABLE_GET (stack_prefault, size_t,
+	       TUNABLE_CALLBACK (set_stack_prefault));
+  TUNABLE_GET (lock_profile_rate, int32_t,
+	       TUNABLE_CALLBACK (set_lock_profile_rate));
 }
@@ -30,9 +30,24 @@
 /* Some of the following definitions differ when pthread_mutex_cond_lock.c
    includes this file.  */
 #ifndef LLL_MUTEX_LOCK
+/* lll_lock, but record the time spent blocking in the lock profile.  SITE
+   is the caller of pthread_mutex_lock.  */
+static __always_inline void
+lll_mutex_lock_profiled (pthread_mutex_t *mutex, void *site)
+{
+  if (__glibc_unlikely (atomic_compare_and_exchange_bool_acq
+			(&mutex->__data.__lock, 1, 0)))
+    {
+      uint64_t profile = 0;
+      lock_profile_wait (&profile);
+      __lll_lock_wait (&mutex->__data.__lock, PTHREAD_MUTEX_PSHARED (mutex));
+      lock_profile_done (mutex, LOCK_PROFILE_MUTEX, site, profile);
+    }
+}
+
 /* lll_lock with single-thread optimization.  */
-static inline void
-lll_mutex_lock_optimized (pthread_mutex_t *mutex)
+static __always_inline void
+lll_mutex_lock_optimized (pthread_mutex_t *mutex, void *site)
 {
   /* The single-threaded optimization is only valid for private
      mutexes.  For process-shared mutexes, the mutex could be in a
@@ -45,15 +60,17 @@ lll_mutex_lock_optimized (pthread_mutex_t *mutex)
   if (private == LLL_PRIVATE && SINGLE_THREAD_P && mutex->__data.__lock == 0)
     mutex->__data.__lock = 1;
   else
-    lll_lock (mutex->__data.__lock, private);
+    lll_mutex_lock_profiled (mutex, site);
 }
 
 # define LLL_MUTEX_LOCK(mutex)						\
-  lll_lock ((mutex)->__data.__lock, PTHREAD_MUTEX_PSHARED (mutex))
-# define LLL_MUTEX_LOCK_OPTIMIZED(mutex) lll_mutex_lock_optimized (mutex)
+  lll_mutex_lock_profiled (mutex, __builtin_return_address (0))
+# define LLL_MUTEX_LOCK_OPTIMIZED(mutex)				\
+  lll_mutex_lock_optimized (mutex, __builtin_return_address (0))
 # define LLL_MUTEX_TRYLOCK(mutex) \
   lll_trylock ((mutex)->__data.__lock)
 # define LLL_ROBUST_MUTEX_LOCK_MODIFIER 0
+# define LLL_QUEUED_MUTEX_COND false
 # define PTHREAD_MUTEX_LOCK ___pthread_mutex_lock
 # define PTHREAD_MUTEX_VERSIONS 1
 #endif
@@ -63,7 +80,7 @@ lll_mutex_lock_optimized (pthread_mutex_t *mutex)
   atomic_load_relaxed (&(mutex)->__data.__lock)
 #endif
 
-static int __pthread_mutex_lock_full (pthread_mutex_t *mutex)
+static int __pthread_mutex_lock_full (pthread_mutex_t *mutex, void *site)
      __attribute_noinline__;
 
 int
@@ -76,7 +93,7 @@ PTHREAD_MUTEX_LOCK (pthread_mutex_t *mutex)
   LIBC_PROBE (mutex_entry, 1, mutex);
 
   if (__glibc_unlikely (type & ~PTHREAD_MUTEX_KIND_MASK_NP))
-    return __pthread_mutex_lock_full (mutex);
+    return __pthread_mutex_lock_full (mutex, __builtin_return_address (0));
 
   pid_t id = THREAD_GETMEM (THREAD_SELF, tid);
 
@@ -115,33 +132,36 @@ PTHREAD_MUTEX_LOCK (pthread_mutex_t *mutex)
       if (LLL_MUTEX_TRYLOCK (mutex) != 0)
 	{
 	  int cnt = 0;
-	  int max_cnt = MIN (max_adaptive_count (),
-			     mutex->__data.__spins * 2 + 10);
+	  int max_cnt = adaptive_spin_limit (mutex);
 	  int spin_count, exp_backoff = 1;
 	  unsigned int jitter = get_jitter ();
-	  do
-	    {
-	      /* In each loop, spin count is exponential backoff plus
-		 random jitter, random range is [0, exp_backoff-1].  */
-	      spin_count = exp_backoff + (jitter & (exp_backoff - 1));
-	      cnt += spin_count;
-	      if (cnt >= max_cnt)
-		{
-		  /* If cnt exceeds max spin count, just go to wait
-		     queue.  */
-		  LLL_MUTEX_LOCK (mutex);
-		  break;
-		}
-	      do
-		atomic_spin_nop ();
-	      while (--spin_count > 0);
-	      /* Prepare for next loop.  */
-	      exp_backoff = get_next_backoff (exp_backoff);
-	    }
-	  while (LLL_MUTEX_READ_LOCK (mutex) != 0
-		 || LLL_MUTEX_TRYLOCK (mutex) != 0);
+	  if (max_cnt == 0)
+	    /* Spinning has not paid off recently.  */
+	    LLL_MUTEX_LOCK (mutex);
+	  else
+	    do
+	      {
+		/* In each loop, spin count is exponential backoff plus
+		   random jitter, random range is [0, exp_backoff-1].  */
+		spin_count = exp_backoff + (jitter & (exp_backoff - 1));
+		cnt += spin_count;
+		if (cnt >= max_cnt)
+		  {
+		    /* If cnt exceeds max spin count, just go to wait
+		       queue.  */
+		    LLL_MUTEX_LOCK (mutex);
+		    break;
+		  }
+		do
+		  atomic_spin_nop ();
+		while (--spin_count > 0);
+		/* Prepare for next loop.  */
+		exp_backoff = get_next_backoff (exp_backoff);
+	      }
+	    while (LLL_MUTEX_READ_LOCK (mutex) != 0
+		   || LLL_MUTEX_TRYLOCK (mutex) != 0);
 
-	  mutex->__data.__spins += (cnt - mutex->__data.__spins) / 8;
+	  adaptive_spin_update (mutex, cnt, max_cnt);
 	}
       assert (mutex->__data.__owner == 0);
     }
@@ -166,9 +186,10 @@ PTHREAD_MUTEX_LOCK (pthread_mutex_t *mutex)
 }
 
 static int
-__pthread_mutex_lock_full (pthread_mutex_t *mutex)
+__pthread_mutex_lock_full (pthread_mutex_t *mutex, void *site)
 {
   int oldval;
+  uint64_t profile = 0;
   pid_t id = THREAD_GETMEM (THREAD_SELF, tid);
 
   switch (PTHREAD_MUTEX_TYPE (mutex))
@@ -308,6 +329,7 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
 	  assume_other_futex_waiters |= FUTEX_WAITERS;
 
 	  /* Block using the futex and reload current lock value.  */
+	  lock_profile_wait (&profile);
 	  futex_wait ((unsigned int *) &mutex->__data.__lock, oldval,
 		      PTHREAD_ROBUST_MUTEX_PSHARED (mutex));
 	  oldval = mutex->__data.__lock;
@@ -414,6 +436,7 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
 	    int private = (robust
 			   ? PTHREAD_ROBUST_MUTEX_PSHARED (mutex)
 			   : PTHREAD_MUTEX_PSHARED (mutex));
+	    lock_profile_wait (&profile);
 	    int e = __futex_lock_pi64 (&mutex->__data.__lock, 0 /* unused  */,
 				       NULL, private);
 	    if (e == ESRCH || e == EDEADLK)
@@ -570,9 +593,12 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
 		  break;
 
 		if (oldval != ceilval)
-		  futex_wait ((unsigned int * ) &mutex->__data.__lock,
-			      ceilval | 2,
-			      PTHREAD_MUTEX_PSHARED (mutex));
+		  {
+		    lock_profile_wait (&profile);
+		    futex_wait ((unsigned int * ) &mutex->__data.__lock,
+				ceilval | 2,
+				PTHREAD_MUTEX_PSHARED (mutex));
+		  }
 	      }
 	    while (atomic_compare_and_exchange_val_acq (&mutex->__data.__lock,
 							ceilval | 2, ceilval)
@@ -585,6 +611,15 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
       }
       break;
 
+    case PTHREAD_MUTEX_QUEUED_NP:
+      if (LLL_MUTEX_TRYLOCK (mutex) != 0)
+	{
+	  lock_profile_wait (&profile);
+	  __pthread_mutex_queued_lock (mutex, LLL_QUEUED_MUTEX_COND);
+	}
+      assert (mutex->__data.__owner == 0);
+      break;
+
     default:
       /* Correct code cannot set any other type.  */
       return EINVAL;
@@ -598,6 +633,7 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
 
   LIBC_PROBE (mutex_acquired, 1, mutex);
 
+  lock_profile_done (mutex, LOCK_PROFILE_MUTEX, site, profile);
   return 0;
 }
 
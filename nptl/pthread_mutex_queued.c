@@ -0,0 +1,216 @@
+/* Contended path of NUMA-aware queued mutexes.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pthreadP.h"
+#include <atomic.h>
+#include <futex-internal.h>
+#include <lowlevellock.h>
+#include <rseq-internal.h>
+
+/* A PTHREAD_MUTEX_QUEUED_NP mutex is owned by the thread which sets
+   __lock from 0 to nonzero, exactly like a PTHREAD_MUTEX_NORMAL mutex, so
+   that trylock, timedlock and unlock need nothing special.  What differs
+   is how blocked threads contend for __lock: only the thread at the head
+   of an MCS queue spins on (and eventually futex-waits on) __lock.  All
+   other waiters spin on a word in their own queue node, which lives on
+   their stack, and then sleep on it.  The queue tail is kept in
+   __data.__list.__next, which only robust mutexes use otherwise.
+
+   When the head acquires __lock, it makes the next waiter the head.  To
+   keep the lock and the data it protects on one NUMA node for as long as
+   possible, it prefers the first waiter running on its own node: the
+   waiters it skips are moved to a secondary queue, which is handed from
+   head to head along with the head role.  This is the compact NUMA-aware
+   lock of Dice and Kogan.  The secondary queue goes back in front of the
+   main queue when no waiter of the current node is left, and after
+   QUEUE_MAX_LOCAL_HANDOFFS handoffs within one node, so that waiters on
+   other nodes are not starved.  */
+
+#define QUEUE_MAX_LOCAL_HANDOFFS 64
+
+/* Values of the state of a queue node.  */
+enum
+{
+  /* The waiter spins on STATE.  */
+  QUEUE_WAITING,
+  /* The waiter sleeps on STATE.  */
+  QUEUE_SLEEPING,
+  /* The waiter is the head of the queue.  */
+  QUEUE_HEAD
+};
+
+struct queue_node
+{
+  struct queue_node *next;
+  unsigned int state;
+  /* NUMA node of the waiter, or -1 if unknown.  In the latter case the
+     waiter is never handed the lock out of FIFO order.  */
+  int numa_node;
+  /* Secondary queue and number of handoffs within the node of the
+     head, passed on with the head role.  */
+  struct queue_node *secondary_head;
+  struct queue_node *secondary_tail;
+  unsigned int local_handoffs;
+} __attribute__ ((aligned (64)));
+
+static inline struct queue_node **
+queue_tail (pthread_mutex_t *mutex)
+{
+  return (struct queue_node **) &mutex->__data.__list.__next;
+}
+
+/* Make NODE the head of the queue, with the given secondary queue.  NODE
+   may return from __pthread_mutex_queued_lock at any point after the
+   store, so it must not be accessed afterwards, except for the futex
+   wake-up (spurious wake-ups are harmless for futex users).  */
+static void
+queue_grant (struct queue_node *node, struct queue_node *secondary_head,
+	     struct queue_node *secondary_tail, unsigned int local_handoffs)
+{
+  node->secondary_head = secondary_head;
+  node->secondary_tail = secondary_tail;
+  node->local_handoffs = local_handoffs;
+  if (atomic_exchange_release (&node->state, QUEUE_HEAD) == QUEUE_SLEEPING)
+    futex_wake (&node->state, 1, FUTEX_PRIVATE);
+}
+
+/* Pass the head role of the queue of MUTEX on from SELF, which has
+   acquired __lock.  */
+static void
+queue_handoff (pthread_mutex_t *mutex, struct queue_node *self)
+{
+  struct queue_node *sec_head = self->secondary_head;
+  struct queue_node *sec_tail = self->secondary_tail;
+  struct queue_node *next = atomic_load_acquire (&self->next);
+
+  if (next == NULL)
+    {
+      /* SELF is the last node of the main queue.  Remove it, or replace
+	 it with the secondary queue.  */
+      struct queue_node *expected = self;
+      do
+	if (atomic_compare_exchange_weak_release (queue_tail (mutex),
+						  &expected, sec_tail))
+	  {
+	    if (sec_head != NULL)
+	      queue_grant (sec_head, NULL, NULL, 0);
+	    return;
+	  }
+      while (expected == self);
+      /* Another waiter is being linked behind SELF.  */
+      while ((next = atomic_load_acquire (&self->next)) == NULL)
+	atomic_spin_nop ();
+    }
+
+  if (self->local_handoffs < QUEUE_MAX_LOCAL_HANDOFFS
+      && self->numa_node >= 0)
+    {
+      /* Look for a waiter on the node of SELF.  Stop at the first node
+	 whose successor is not linked yet: it may be the tail.  */
+      struct queue_node *prev = NULL;
+      struct queue_node *node = next;
+      while (node != NULL && node->numa_node != self->numa_node)
+	{
+	  prev = node;
+	  node = atomic_load_acquire (&node->next);
+	}
+      if (node != NULL)
+	{
+	  if (prev != NULL)
+	    {
+	      /* Move the waiters from NEXT to PREV to the secondary
+		 queue.  Only the head writes the next pointers of linked
+		 nodes.  */
+	      atomic_store_relaxed (&prev->next, NULL);
+	      if (sec_tail != NULL)
+		atomic_store_relaxed (&sec_tail->next, next);
+	      else
+		sec_head = next;
+	      sec_tail = prev;
+	    }
+	  queue_grant (node, sec_head, sec_tail, self->local_handoffs + 1);
+	  return;
+	}
+    }
+
+  /* Give the waiters of other nodes their turn.  */
+  if (sec_head != NULL)
+    {
+      atomic_store_relaxed (&sec_tail->next, next);
+      queue_grant (sec_head, NULL, NULL, 0);
+    }
+  else
+    queue_grant (next, NULL, NULL, 0);
+}
+
+void
+__pthread_mutex_queued_lock (pthread_mutex_t *mutex, bool cond)
+{
+  struct queue_node self =
+    {
+      .state = QUEUE_WAITING,
+      .numa_node = rseq_current_node ()
+    };
+  int max_cnt = max_adaptive_count ();
+
+  struct queue_node *prev = atomic_exchange_acq_rel (queue_tail (mutex),
+						     &self);
+  if (prev != NULL)
+    {
+      atomic_store_release (&prev->next, &self);
+
+      /* Wait until we are the head of the queue, spinning on our own
+	 node first.  */
+      int cnt = 0;
+      while (atomic_load_acquire (&self.state) != QUEUE_HEAD)
+	{
+	  if (cnt++ < max_cnt)
+	    {
+	      atomic_spin_nop ();
+	      continue;
+	    }
+	  unsigned int expected = QUEUE_WAITING;
+	  if (atomic_compare_exchange_weak_acquire (&self.state, &expected,
+						    QUEUE_SLEEPING)
+	      || expected == QUEUE_SLEEPING)
+	    futex_wait_simple (&self.state, QUEUE_SLEEPING, FUTEX_PRIVATE);
+	}
+    }
+
+  /* As the head, compete for __lock with threads not in the queue.  */
+  int cnt = 0;
+  while (atomic_load_relaxed (&mutex->__data.__lock) != 0
+	 || (cond
+	     ? lll_cond_trylock (mutex->__data.__lock)
+	     : lll_trylock (mutex->__data.__lock)) != 0)
+    {
+      if (cnt++ >= max_cnt)
+	{
+	  if (cond)
+	    lll_cond_lock (mutex->__data.__lock, LLL_PRIVATE);
+	  else
+	    lll_lock (mutex->__data.__lock, LLL_PRIVATE);
+	  break;
+	}
+      atomic_spin_nop ();
+    }
+
+  queue_handoff (mutex, &self);
+}
@@ -79,6 +79,9 @@ __pthread_mutex_clocklock_common (pthread_mutex_t *mutex,
       [[fallthrough]];
 
     case PTHREAD_MUTEX_TIMED_NP:
+    /* Timed waiters of queued mutexes do not join the queue, so that they
+       can give up without unlinking their node.  */
+    case PTHREAD_MUTEX_QUEUED_NP:
       /* Normal mutex.  */
       result = __futex_clocklock64 (&mutex->__data.__lock, clockid, abstime,
                                     PTHREAD_MUTEX_PSHARED (mutex));
@@ -88,8 +91,7 @@ __pthread_mutex_clocklock_common (pthread_mutex_t *mutex,
       if (lll_trylock (mutex->__data.__lock) != 0)
 	{
 	  int cnt = 0;
-	  int max_cnt = MIN (max_adaptive_count (),
-			     mutex->__data.__spins * 2 + 10);
+	  int max_cnt = adaptive_spin_limit (mutex);
 	  do
 	    {
 	      if (cnt++ >= max_cnt)
@@ -103,7 +105,9 @@ __pthread_mutex_clocklock_common (pthread_mutex_t *mutex,
 	    }
 	  while (lll_trylock (mutex->__data.__lock) != 0);
 
-	  mutex->__data.__spins += (cnt - mutex->__data.__spins) / 8;
+	  /* A waiter which timed out does not own the mutex.  */
+	  if (result == 0)
+	    adaptive_spin_update (mutex, cnt, max_cnt);
 	}
       break;
 
@@ -61,6 +61,7 @@ ___pthread_mutex_trylock (pthread_mutex_t *mutex)
     case PTHREAD_MUTEX_TIMED_NP:
     case PTHREAD_MUTEX_ADAPTIVE_NP:
     case PTHREAD_MUTEX_ERRORCHECK_NP:
+    case PTHREAD_MUTEX_QUEUED_NP:
       /* Mutex type is already loaded, lock check overhead should
          be minimal.  */
       if (atomic_load_relaxed (&(mutex->__data.__lock)) != 0
@@ -342,6 +342,14 @@ __pthread_mutex_unlock_full (pthread_mutex_t *mutex, int decr)
 
       return __pthread_tpp_change_priority (oldprio, -1);
 
+    case PTHREAD_MUTEX_QUEUED_NP:
+      /* The queue is only used by waiters, unlock like a normal mutex.  */
+      mutex->__data.__owner = 0;
+      if (decr)
+	--mutex->__data.__nusers;
+      lll_unlock (mutex->__data.__lock, LLL_PRIVATE);
+      break;
+
     default:
       /* Correct code cannot set any other type.  */
       return EINVAL;
@@ -0,0 +1,165 @@
+/* Reader bias of PTHREAD_RWLOCK_READER_BIASED_NP rwlocks.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include "pthreadP.h"
+#include <atomic.h>
+#include <futex-internal.h>
+
+/* See pthread_rwlock_common.c for how readers use this table.  It is
+   shared by all biased rwlocks of the process.  */
+struct pthread_rwlock_bias_slot
+  __pthread_rwlock_bias_slots[PTHREAD_RWLOCK_BIAS_SLOTS];
+
+/* Number of writers blocked in __pthread_rwlock_bias_revoke, and the futex
+   word they block on.  */
+unsigned int __pthread_rwlock_bias_waiters;
+unsigned int __pthread_rwlock_bias_wake_seq;
+
+/* Number of times a writer checks a slot before it blocks.  */
+#define BIAS_SPIN_COUNT 100
+
+/* After a writer revoked the bias, it stays off for this many times the
+   duration of the revocation, which bounds the share of time writers
+   spend revoking.  */
+#define BIAS_INHIBIT_FACTOR 9
+
+/* The bias stays off for at most this many microseconds.  __bias_inhibit
+   only holds the low 32 bits of the deadline, so a deadline further away
+   than this is one that has passed and wrapped around.  */
+#define BIAS_INHIBIT_MAX 1000000
+
+/* While the bias is off, a thread reads the clock to check whether it
+   can be enabled again only on every this many read acquisitions.  */
+#define BIAS_CHECK_INTERVAL 64
+
+static __thread unsigned int bias_check_countdown;
+
+/* Return the current CLOCK_MONOTONIC time in microseconds.  */
+static uint64_t
+bias_now (void)
+{
+  struct __timespec64 ts;
+  __clock_gettime64 (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * (uint64_t) 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool
+bias_timed_out (clockid_t clockid, const struct __timespec64 *abstime)
+{
+  struct __timespec64 ts;
+  __clock_gettime64 (clockid, &ts);
+  return (ts.tv_sec > abstime->tv_sec
+	  || (ts.tv_sec == abstime->tv_sec && ts.tv_nsec >= abstime->tv_nsec));
+}
+
+int
+__pthread_rwlock_bias_revoke (pthread_rwlock_t *rwlock, clockid_t clockid,
+			      const struct __timespec64 *abstime, bool try)
+{
+  uint64_t start = bias_now ();
+
+  /* Readers publish their slot before they check that the bias is still
+     enabled, so after the fence either they see it disabled, or we see
+     their slot.  */
+  atomic_store_relaxed (&rwlock->__data.__bias, PTHREAD_RWLOCK_BIAS_KIND);
+  atomic_thread_fence_seq_cst ();
+
+  for (size_t i = 0; i < PTHREAD_RWLOCK_BIAS_SLOTS; ++i)
+    {
+      struct pthread_rwlock_bias_slot *slot = &__pthread_rwlock_bias_slots[i];
+      unsigned int spin = 0;
+      /* Acquire MO so that we synchronize with the release of the read
+	 lock.  */
+      while (atomic_load_acquire (&slot->rwlock) == rwlock)
+	{
+	  int err = 0;
+	  if (try)
+	    err = EBUSY;
+	  else if (abstime != NULL && bias_timed_out (clockid, abstime))
+	    err = ETIMEDOUT;
+	  if (err != 0)
+	    {
+	      /* The caller gives up the write lock.  Readers may still hold
+		 slots, so the next writer must revoke the bias again.  */
+	      atomic_store_relaxed (&rwlock->__data.__bias,
+				    (PTHREAD_RWLOCK_BIAS_KIND
+				     | PTHREAD_RWLOCK_BIAS_ENABLED));
+	      return err;
+	    }
+	  if (spin < BIAS_SPIN_COUNT)
+	    {
+	      ++spin;
+	      atomic_spin_nop ();
+	      continue;
+	    }
+
+	  /* See __pthread_rwlock_bias_release.  Acquire MO on the sequence
+	     number so that if we see the increment of the reader that
+	     released the slot, we also see the slot released.  */
+	  atomic_fetch_add_relaxed (&__pthread_rwlock_bias_waiters, 1);
+	  unsigned int seq
+	    = atomic_load_acquire (&__pthread_rwlock_bias_wake_seq);
+	  atomic_thread_fence_seq_cst ();
+	  if (atomic_load_relaxed (&slot->rwlock) == rwlock)
+	    /* Timeouts are handled at the top of the loop, and other errors
+	       are spurious wake-ups.  */
+	    __futex_abstimed_wait64 (&__pthread_rwlock_bias_wake_seq, seq,
+				     clockid, abstime, FUTEX_PRIVATE);
+	  atomic_fetch_add_relaxed (&__pthread_rwlock_bias_waiters, -1);
+	}
+    }
+
+  uint64_t inhibit = (bias_now () - start + 1) * (BIAS_INHIBIT_FACTOR + 1);
+  if (inhibit > BIAS_INHIBIT_MAX)
+    inhibit = BIAS_INHIBIT_MAX;
+  atomic_store_relaxed (&rwlock->__data.__bias_inhibit,
+			(unsigned int) (start + inhibit));
+  return 0;
+}
+
+void
+__pthread_rwlock_bias_enable (pthread_rwlock_t *rwlock)
+{
+  if (bias_check_countdown > 0)
+    {
+      --bias_check_countdown;
+      return;
+    }
+  bias_check_countdown = BIAS_CHECK_INTERVAL - 1;
+
+  unsigned int deadline = atomic_load_relaxed (&rwlock->__data.__bias_inhibit);
+  unsigned int left = deadline - (unsigned int) bias_now ();
+  if (left == 0 || left > BIAS_INHIBIT_MAX)
+    /* Release MO so that readers which see the bias enabled synchronize
+       with the writers we synchronized with.  */
+    atomic_store_release (&rwlock->__data.__bias,
+			  PTHREAD_RWLOCK_BIAS_KIND | PTHREAD_RWLOCK_BIAS_ENABLED);
+}
+
+void
+__pthread_rwlock_bias_wake (void)
+{
+  /* Release MO so that a writer which sees the new sequence number also
+     sees the slot released.  */
+  atomic_fetch_add_release (&__pthread_rwlock_bias_wake_seq, 1);
+  futex_wake (&__pthread_rwlock_bias_wake_seq, INT_MAX, FUTEX_PRIVATE);
+}
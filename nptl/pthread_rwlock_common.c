@@ -23,6 +23,7 @@
 #include <sys/time.h>
 #include <stap-probe.h>
 #include <atomic.h>
+#include <stdint.h>
 #include <futex-internal.h>
 #include <time.h>
 
@@ -205,6 +206,34 @@
    waiting thread because the waiting thread came first.
 
 
+   Rwlocks of kind PTHREAD_RWLOCK_READER_BIASED_NP are reader-preferring
+   rwlocks with an additional fast path for readers, following the BRAVO
+   scheme of Dice and Kogan.  While PTHREAD_RWLOCK_BIAS_ENABLED is set in
+   __bias, a reader acquires the lock by publishing itself in a slot of the
+   process-wide visible readers table __pthread_rwlock_bias_slots, chosen by
+   hashing the rwlock and the thread descriptor, and does not modify the
+   rwlock at all.
+   Thus concurrent readers on different CPUs do not contend for the cache
+   line of __readers.  If the slot is taken, the reader uses the normal
+   algorithm instead.
+   A writer first acquires the lock as described above, which excludes new
+   readers that use the normal algorithm, and then revokes the bias: it
+   clears PTHREAD_RWLOCK_BIAS_ENABLED and waits until no slot refers to the
+   rwlock anymore.  Readers publish their slot before they check that the
+   bias is enabled, and the writer clears it before it scans the table, with
+   a seq_cst fence in between in both cases, so either the reader sees the
+   bias revoked and backs out, or the writer sees and waits for the reader.
+   The writer spins for a short while and then blocks on the futex word
+   __pthread_rwlock_bias_wake_seq, which readers increment when they
+   release a slot while __pthread_rwlock_bias_waiters is nonzero.
+   A writer which gives up waiting (trywrlock, or a timeout) enables the
+   bias again before it releases the lock.
+   Because revocation scans the whole table, the bias is re-enabled by a
+   reader only after a delay proportional to the duration of the last
+   revocation, and readers check whether the delay has passed only on
+   every few acquisitions (see pthread_rwlock_bias.c).
+
+
    POSIX allows but does not require rwlock acquisitions to be a cancellation
    point.  We do not support cancellation.  */
 
@@ -215,6 +244,94 @@ __pthread_rwlock_get_private (pthread_rwlock_t *rwlock)
   return rwlock->__data.__shared != 0 ? FUTEX_SHARED : FUTEX_PRIVATE;
 }
 
+/* Return the visible readers slot of the calling thread for RWLOCK.  */
+static __always_inline struct pthread_rwlock_bias_slot *
+__pthread_rwlock_bias_slot (pthread_rwlock_t *rwlock)
+{
+  /* Use the thread descriptor rather than the TID, which changes in the
+     child after fork while the locks held by the forking thread stay
+     held.  Thread descriptors are at least page aligned and far apart,
+     so multiply in 64 bits and use the upper half.  */
+  uint64_t h = (((uint64_t) ((uintptr_t) rwlock >> 4)
+		 ^ (uint64_t) ((uintptr_t) THREAD_SELF >> 12))
+		* 0x9e3779b97f4a7c15ULL);
+  return &__pthread_rwlock_bias_slots[(h >> 32) % PTHREAD_RWLOCK_BIAS_SLOTS];
+}
+
+/* Release SLOT, which the calling thread published for a read lock, and
+   wake the writers that wait for a slot to be released, if any.  */
+static __always_inline void
+__pthread_rwlock_bias_release (struct pthread_rwlock_bias_slot *slot)
+{
+  atomic_store_relaxed (&slot->thread, NULL);
+  /* Release MO so that a writer waiting for the slot synchronizes with
+     the end of our critical section.  The writer increments the number of
+     waiters before it checks the slot, with a seq_cst fence in between,
+     so either it sees the slot released, or we see it waiting.  */
+  atomic_store_release (&slot->rwlock, NULL);
+  atomic_thread_fence_seq_cst ();
+  if (__glibc_unlikely (atomic_load_relaxed (&__pthread_rwlock_bias_waiters)
+			!= 0))
+    __pthread_rwlock_bias_wake ();
+}
+
+/* Try to acquire a read lock on RWLOCK through the visible readers
+   table.  Return true on success.  */
+static __always_inline bool
+__pthread_rwlock_bias_rdlock (pthread_rwlock_t *rwlock)
+{
+  if ((atomic_load_relaxed (&rwlock->__data.__bias)
+       & PTHREAD_RWLOCK_BIAS_ENABLED) == 0)
+    return false;
+
+  struct pthread_rwlock_bias_slot *slot = __pthread_rwlock_bias_slot (rwlock);
+  pthread_rwlock_t *expected = NULL;
+  if (!atomic_compare_exchange_weak_relaxed (&slot->rwlock, &expected,
+					       rwlock))
+    return false;
+  atomic_store_relaxed (&slot->thread, THREAD_SELF);
+  /* See above.  Acquire MO so that we synchronize with the reader that
+     re-enabled the bias, which in turn synchronized with prior writers.  */
+  atomic_thread_fence_seq_cst ();
+  if ((atomic_load_acquire (&rwlock->__data.__bias)
+       & PTHREAD_RWLOCK_BIAS_ENABLED) != 0)
+    return true;
+
+  /* A writer is revoking the bias; let it proceed.  */
+  __pthread_rwlock_bias_release (slot);
+  return false;
+}
+
+/* Release a read lock on RWLOCK acquired through the visible readers
+   table.  Return false if the calling thread did not acquire it that
+   way.  */
+static __always_inline bool
+__pthread_rwlock_bias_rdunlock (pthread_rwlock_t *rwlock)
+{
+  if ((atomic_load_relaxed (&rwlock->__data.__bias)
+       & PTHREAD_RWLOCK_BIAS_KIND) == 0)
+    return false;
+
+  /* Only this thread stores THREAD_SELF into the slot.  If the thread
+     holds RWLOCK more than once, it does not matter which acquisition we
+     release.  */
+  struct pthread_rwlock_bias_slot *slot = __pthread_rwlock_bias_slot (rwlock);
+  if (atomic_load_relaxed (&slot->rwlock) != rwlock
+      || atomic_load_relaxed (&slot->thread) != THREAD_SELF)
+    return false;
+  __pthread_rwlock_bias_release (slot);
+  return true;
+}
+
+/* Called by readers which acquired RWLOCK through the normal algorithm.  */
+static __always_inline void
+__pthread_rwlock_bias_rdlocked (pthread_rwlock_t *rwlock)
+{
+  if (__glibc_unlikely (atomic_load_relaxed (&rwlock->__data.__bias)
+			== PTHREAD_RWLOCK_BIAS_KIND))
+    __pthread_rwlock_bias_enable (rwlock);
+}
+
 static __always_inline void
 __pthread_rwlock_rdunlock (pthread_rwlock_t *rwlock)
 {
@@ -276,6 +393,7 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
                                 const struct __timespec64 *abstime)
 {
   unsigned int r;
+  uint64_t profile = 0;
 
   /* Make sure any passed in clockid and timeout value are valid.  Note that
      the previous implementation assumed that this check *must* not be
@@ -293,6 +411,9 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 			== THREAD_GETMEM (THREAD_SELF, tid)))
     return EDEADLK;
 
+  if (__pthread_rwlock_bias_rdlock (rwlock))
+    return 0;
+
   /* If we prefer writers, recursive rdlock is disallowed, we are in a read
      phase, and there are other readers present, we try to wait without
      extending the read phase.  We will be unblocked by either one of the
@@ -323,6 +444,7 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 		      & PTHREAD_RWLOCK_RWAITING) != 0)
 		{
 		  int private = __pthread_rwlock_get_private (rwlock);
+		  lock_profile_wait (&profile);
 		  int err = __futex_abstimed_wait64 (&rwlock->__data.__readers,
 		                                     r, clockid, abstime,
 		                                     private);
@@ -382,7 +504,12 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
      this seems to be a corner case and handling it specially not be worth the
      complexity.  */
   if (__glibc_likely ((r & PTHREAD_RWLOCK_WRPHASE) == 0))
-    return 0;
+    {
+      __pthread_rwlock_bias_rdlocked (rwlock);
+      lock_profile_done (rwlock, LOCK_PROFILE_RDLOCK,
+			 __builtin_return_address (0), profile);
+      return 0;
+    }
   /* Otherwise, if we were in a write phase (states #6 or #8), we must wait
      for explicit hand-over of the read phase; the only exception is if we
      can start a read phase if there is no primary writer currently.  */
@@ -410,6 +537,9 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 	      int private = __pthread_rwlock_get_private (rwlock);
 	      futex_wake (&rwlock->__data.__wrphase_futex, INT_MAX, private);
 	    }
+	  __pthread_rwlock_bias_rdlocked (rwlock);
+	  lock_profile_done (rwlock, LOCK_PROFILE_RDLOCK,
+			     __builtin_return_address (0), profile);
 	  return 0;
 	}
       else
@@ -451,6 +581,7 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 		  (&rwlock->__data.__wrphase_futex,
 		   &wpf, wpf | PTHREAD_RWLOCK_FUTEX_USED)))
 	    continue;
+	  lock_profile_wait (&profile);
 	  int err = __futex_abstimed_wait64 (&rwlock->__data.__wrphase_futex,
 					     1 | PTHREAD_RWLOCK_FUTEX_USED,
 					     clockid, abstime, private);
@@ -513,6 +644,9 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 	ready = true;
     }
 
+  __pthread_rwlock_bias_rdlocked (rwlock);
+  lock_profile_done (rwlock, LOCK_PROFILE_RDLOCK,
+		     __builtin_return_address (0), profile);
   return 0;
 }
 
@@ -582,6 +716,8 @@ static __always_inline int
 __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
                                 const struct __timespec64 *abstime)
 {
+  uint64_t profile = 0;
+
   /* Make sure any passed in clockid and timeout value are valid.  Note that
      the previous implementation assumed that this check *must* not be
      performed if there would in fact be no blocking; however, POSIX only
@@ -721,6 +857,7 @@ __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 	     share the flag, and another writer will wake one of the writers
 	     in this group.  */
 	  may_share_futex_used_flag = true;
+	  lock_profile_wait (&profile);
 	  int err = __futex_abstimed_wait64 (&rwlock->__data.__writers_futex,
 					     1 | PTHREAD_RWLOCK_FUTEX_USED,
 					     clockid, abstime, private);
@@ -820,6 +957,7 @@ __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 		  (&rwlock->__data.__wrphase_futex, &wpf,
 		   PTHREAD_RWLOCK_FUTEX_USED)))
 	    continue;
+	  lock_profile_wait (&profile);
 	  int err = __futex_abstimed_wait64 (&rwlock->__data.__wrphase_futex,
 					     PTHREAD_RWLOCK_FUTEX_USED,
 					     clockid, abstime, private);
@@ -940,5 +1078,19 @@ __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
  done:
   atomic_store_relaxed (&rwlock->__data.__cur_writer,
 			THREAD_GETMEM (THREAD_SELF, tid));
+  /* Wait for the readers which bypassed the normal algorithm.  */
+  if ((atomic_load_relaxed (&rwlock->__data.__bias)
+       & PTHREAD_RWLOCK_BIAS_ENABLED) != 0)
+    {
+      int err = __pthread_rwlock_bias_revoke (rwlock, clockid, abstime,
+					      false);
+      if (__glibc_unlikely (err != 0))
+	{
+	  __pthread_rwlock_wrunlock (rwlock);
+	  return err;
+	}
+    }
+  lock_profile_done (rwlock, LOCK_PROFILE_WRLOCK,
+		     __builtin_return_address (0), profile);
   return 0;
 }
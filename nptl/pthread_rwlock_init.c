@@ -47,11 +47,22 @@ ___pthread_rwlock_init (pthread_rwlock_t *rwlock,
 
   memset (rwlock, '\0', sizeof (*rwlock));
 
-  rwlock->__data.__flags = iattr->lockkind;
-
   /* The value of __SHARED in a private rwlock must be zero.  */
   rwlock->__data.__shared = (iattr->pshared != PTHREAD_PROCESS_PRIVATE);
 
+  if (iattr->lockkind == PTHREAD_RWLOCK_READER_BIASED_NP)
+    {
+      /* Apart from the reader bias, this is a reader-preferring rwlock.
+	 The visible readers table is local to the process, so the bias is
+	 not used for process-shared rwlocks.  */
+      rwlock->__data.__flags = PTHREAD_RWLOCK_PREFER_READER_NP;
+      if (iattr->pshared == PTHREAD_PROCESS_PRIVATE)
+	rwlock->__data.__bias = (PTHREAD_RWLOCK_BIAS_KIND
+				 | PTHREAD_RWLOCK_BIAS_ENABLED);
+    }
+  else
+    rwlock->__data.__flags = iattr->lockkind;
+
   return 0;
 }
 versioned_symbol (libc, ___pthread_rwlock_init, pthread_rwlock_init,
@@ -19,6 +19,7 @@
 #include "pthreadP.h"
 #include <atomic.h>
 #include <shlib-compat.h>
+#include "pthread_rwlock_common.c"
 
 /* See pthread_rwlock_common.c for an overview.  */
 int
@@ -57,6 +58,16 @@ ___pthread_rwlock_trywrlock (pthread_rwlock_t *rwlock)
 	    atomic_store_relaxed (&rwlock->__data.__wrphase_futex, 1);
 	  atomic_store_relaxed (&rwlock->__data.__cur_writer,
 	      THREAD_GETMEM (THREAD_SELF, tid));
+	  /* Fail instead of waiting for readers which bypassed the normal
+	     algorithm (see pthread_rwlock_common.c).  */
+	  if ((atomic_load_relaxed (&rwlock->__data.__bias)
+	       & PTHREAD_RWLOCK_BIAS_ENABLED) != 0
+	      && __pthread_rwlock_bias_revoke (rwlock, CLOCK_MONOTONIC,
+					       NULL, true) != 0)
+	    {
+	      __pthread_rwlock_wrunlock (rwlock);
+	      return EBUSY;
+	    }
 	  return 0;
 	}
       /* TODO Back-off.  */
@@ -42,9 +42,13 @@ ___pthread_setspecific (pthread_key_t key, const void *value)
 
       level2 = &self->specific_1stblock[key];
 
-      /* Remember that we stored at least one set of data.  */
+      /* Remember that we stored data in the first block.  */
       if (value != NULL)
-	THREAD_SETMEM (self, specific_used, true);
+	{
+	  unsigned int used = THREAD_GETMEM (self, specific_used);
+	  if (__glibc_unlikely ((used & 1) == 0))
+	    THREAD_SETMEM (self, specific_used, used | 1);
+	}
     }
   else
     {
@@ -77,8 +81,9 @@ ___pthread_setspecific (pthread_key_t key, const void *value)
       /* Pointer to the right array element.  */
       level2 = &level2[idx2nd];
 
-      /* Remember that we stored at least one set of data.  */
-      THREAD_SETMEM (self, specific_used, true);
+      /* Remember that we stored data in this block.  */
+      THREAD_SETMEM (self, specific_used,
+		     THREAD_GETMEM (self, specific_used) | (1U << idx1st));
     }
 
   /* Store the data and the sequence number so that we can recognize
@@ -0,0 +1,247 @@
+/* Wait on several semaphores at once.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <time.h>
+#include "semaphoreP.h"
+#include "sem_waitcommon.c"
+
+/* A waiter in sem_clockwaitany registers as a waiter on all semaphores,
+   exactly like a sem_wait on each of them would, and then blocks on all
+   their futex words at once with futex_waitv.  When it wakes up, it takes
+   a token from the first semaphore which has one.
+
+   sem_post wakes one waiter at most, so a waiter that was woken up for a
+   token but takes a token of another semaphore, or none at all, must pass
+   the wake-up on.  We do this conservatively when we stop being a waiter:
+   if a semaphore still has tokens and other waiters, we wake one of them.
+
+   Kernels before Linux 5.16 lack futex_waitv.  There, we block on one
+   semaphore at a time for a slice of time, taking turns, and check the
+   others when the slice ends.  This adds latency but keeps the waiter
+   from spinning.  */
+
+/* Minimum and maximum length, in nanoseconds, of the time we block on one
+   semaphore without futex_waitv.  */
+#define WAITANY_SLICE_MIN 1000000
+#define WAITANY_SLICE_MAX 16000000
+
+struct waitany_args
+{
+  struct new_sem *const *sems;
+  unsigned int nsems;
+};
+
+/* Stop being a waiter on SEM, and wake up another waiter if SEM has
+   tokens (see above).  */
+static void
+waitany_finish (struct new_sem *sem)
+{
+#if USE_64B_ATOMICS_ON_SEM_T
+  uint64_t d = atomic_fetch_add_relaxed (&sem->data,
+      -((uint64_t) 1 << SEM_NWAITERS_SHIFT));
+  d -= (uint64_t) 1 << SEM_NWAITERS_SHIFT;
+  if ((d & SEM_VALUE_MASK) != 0 && (d >> SEM_NWAITERS_SHIFT) != 0)
+    futex_wake (((unsigned int *) &sem->data) + SEM_VALUE_OFFSET, 1,
+		sem->private);
+#else
+  __sem_wait_32_finish (sem);
+  unsigned int v = atomic_load_relaxed (&sem->value);
+  if ((v >> SEM_VALUE_SHIFT) != 0 && (v & SEM_NWAITERS_MASK) != 0)
+    futex_wake (&sem->value, 1, sem->private);
+#endif
+}
+
+static void
+waitany_cleanup (void *arg)
+{
+  struct waitany_args *args = arg;
+  for (unsigned int i = 0; i < args->nsems; ++i)
+    waitany_finish (args->sems[i]);
+}
+
+/* Take a token from the first of SEMS which has one, and return its
+   index, or -1 if none has a token.  */
+static int
+waitany_fast (struct new_sem *const *sems, unsigned int nsems)
+{
+  for (unsigned int i = 0; i < nsems; ++i)
+    if (__new_sem_wait_fast (sems[i], 1) == 0)
+      return i;
+  return -1;
+}
+
+/* Register as a waiter on SEM and initialize ENTRY to block until SEM may
+   have a token.  */
+static void
+waitany_prepare (struct new_sem *sem, struct futex_waitv_entry *entry)
+{
+#if USE_64B_ATOMICS_ON_SEM_T
+  /* See __new_sem_wait_slow64.  */
+  atomic_fetch_add_relaxed (&sem->data, (uint64_t) 1 << SEM_NWAITERS_SHIFT);
+  futex_waitv_entry_init (entry,
+			  ((unsigned int *) &sem->data) + SEM_VALUE_OFFSET,
+			  0, sem->private);
+#else
+  /* See __new_sem_wait_slow64 for the MO.  */
+  atomic_fetch_add_acquire (&sem->nwaiters, 1);
+  futex_waitv_entry_init (entry, &sem->value, SEM_NWAITERS_MASK,
+			  sem->private);
+#endif
+}
+
+#if !USE_64B_ATOMICS_ON_SEM_T
+/* Make sure that the nwaiters bit of SEM is set before we block, unless
+   SEM has a token.  See __new_sem_wait_slow64 for the MO.  */
+static void
+waitany_set_nwaiters (struct new_sem *sem)
+{
+  unsigned int v = atomic_load_relaxed (&sem->value);
+  while ((v & SEM_NWAITERS_MASK) == 0 && (v >> SEM_VALUE_SHIFT) == 0
+	 && !atomic_compare_exchange_weak_release (&sem->value, &v,
+						   v | SEM_NWAITERS_MASK))
+    ;
+}
+#endif
+
+/* Block on the semaphore of ENTRY alone until ABSTIME, but at most for
+   *SLICE nanoseconds, which doubles for the next call.  */
+static int
+waitany_wait_one (struct futex_waitv_entry *entry, clockid_t clockid,
+		  const struct __timespec64 *abstime, int private,
+		  long int *slice)
+{
+  struct __timespec64 end;
+  if (__clock_gettime64 (clockid, &end) != 0)
+    return EINVAL;
+  end.tv_nsec += *slice;
+  if (end.tv_nsec >= 1000000000)
+    {
+      end.tv_nsec -= 1000000000;
+      ++end.tv_sec;
+    }
+  if (*slice < WAITANY_SLICE_MAX)
+    *slice *= 2;
+
+  bool slice_ends_first = (abstime == NULL
+			   || end.tv_sec < abstime->tv_sec
+			   || (end.tv_sec == abstime->tv_sec
+			       && end.tv_nsec < abstime->tv_nsec));
+  int err = __futex_abstimed_wait_cancelable64
+    ((unsigned int *) (uintptr_t) entry->futex_word, entry->expected,
+     clockid, slice_ends_first ? &end : abstime, private);
+  if (err == ETIMEDOUT && slice_ends_first)
+    err = 0;
+  return err;
+}
+
+static int
+__attribute__ ((noinline))
+waitany_slow (struct new_sem *const *sems, unsigned int nsems,
+	      clockid_t clockid, const struct __timespec64 *abstime)
+{
+  struct futex_waitv_entry entries[nsems];
+  struct waitany_args args = { sems, nsems };
+  int result = -1;
+  int err = 0;
+  unsigned int turn = 0;
+  long int slice = WAITANY_SLICE_MIN;
+
+  for (unsigned int i = 0; i < nsems; ++i)
+    waitany_prepare (sems[i], &entries[i]);
+
+  pthread_cleanup_push (waitany_cleanup, &args);
+
+  for (;;)
+    {
+#if !USE_64B_ATOMICS_ON_SEM_T
+      for (unsigned int i = 0; i < nsems; ++i)
+	waitany_set_nwaiters (sems[i]);
+#endif
+      result = waitany_fast (sems, nsems);
+      if (result >= 0)
+	break;
+
+      err = __futex_abstimed_waitv_cancelable64 (entries, nsems, clockid,
+						 abstime);
+      if (err == ENOSYS)
+	{
+	  /* Without futex_waitv, the time we block on one semaphore needs
+	     a clock even if there is no timeout.  */
+	  err = waitany_wait_one (&entries[turn],
+				  abstime != NULL ? clockid : CLOCK_MONOTONIC,
+				  abstime, sems[turn]->private, &slice);
+	  turn = (turn + 1) % nsems;
+	}
+      /* See __new_sem_wait_slow64.  */
+      if (err == ETIMEDOUT || err == EINTR || err == EOVERFLOW
+	  || err == EINVAL)
+	break;
+    }
+
+  pthread_cleanup_pop (1);
+
+  if (result < 0)
+    __set_errno (err);
+  return result;
+}
+
+int
+___sem_clockwaitany64 (sem_t *const sems[], unsigned int nsems,
+		       clockid_t clockid, const struct __timespec64 *abstime)
+{
+  if (nsems == 0 || nsems > FUTEX_WAITV_MAX
+      || !futex_abstimed_supported_clockid (clockid)
+      || (abstime != NULL && ! valid_nanoseconds (abstime->tv_nsec)))
+    {
+      __set_errno (EINVAL);
+      return -1;
+    }
+
+  struct new_sem *const *nsem = (struct new_sem *const *) sems;
+  int result = waitany_fast (nsem, nsems);
+  if (result >= 0)
+    return result;
+  if (nsems == 1)
+    return __new_sem_wait_slow64 (nsem[0], clockid, abstime);
+  return waitany_slow (nsem, nsems, clockid, abstime);
+}
+
+#if __TIMESIZE == 64
+strong_alias (___sem_clockwaitany64, sem_clockwaitany)
+#else /* __TIMESPEC64 != 64 */
+strong_alias (___sem_clockwaitany64, __sem_clockwaitany64)
+
+int
+sem_clockwaitany (sem_t *const sems[], unsigned int nsems,
+		  clockid_t clockid, const struct timespec *abstime)
+{
+  struct __timespec64 ts64, *pts64 = NULL;
+  if (abstime != NULL)
+    {
+      ts64 = valid_timespec_to_timespec64 (*abstime);
+      pts64 = &ts64;
+    }
+  return ___sem_clockwaitany64 (sems, nsems, clockid, pts64);
+}
+#endif /* __TIMESPEC64 != 64 */
+
+int
+sem_waitany (sem_t *const sems[], unsigned int nsems)
+{
+  return ___sem_clockwaitany64 (sems, nsems, CLOCK_REALTIME, NULL);
+}
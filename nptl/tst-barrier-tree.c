@@ -0,0 +1,131 @@
+/* Test barriers for many threads, which use a combining tree.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <internaltypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Not a multiple of the leaf size, so that the leaves differ in size.  */
+enum { nthreads = 2 * BARRIER_TREE_THRESHOLD + 3, rounds = 500 };
+
+static pthread_barrier_t barrier;
+static pthread_barrier_t barrier2;
+static int values[nthreads];
+static atomic_int serial;
+
+static void *
+worker (void *closure)
+{
+  int index = (intptr_t) closure;
+  for (int round = 1; round <= rounds; ++round)
+    {
+      values[index] = round;
+      if (pthread_barrier_wait (&barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+	{
+	  atomic_fetch_add (&serial, 1);
+	  /* Destroy the barrier right after waiting on it now and then.
+	     The other threads use it again only after BARRIER2.  */
+	  if (round % 100 == 0)
+	    {
+	      xpthread_barrier_destroy (&barrier);
+	      xpthread_barrier_init (&barrier, NULL, nthreads);
+	    }
+	}
+      /* All threads have stored their value for this round.  */
+      for (int i = 0; i < nthreads; ++i)
+	TEST_VERIFY (values[i] >= round);
+      /* No thread stores the next value before all have checked.  */
+      xpthread_barrier_wait (&barrier2);
+    }
+  return NULL;
+}
+
+/* Used with twice as many threads as the barrier count.  */
+static void *
+wait_once (void *closure)
+{
+  if (pthread_barrier_wait (&barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+    atomic_fetch_add (&serial, 1);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_barrierattr_t attr;
+  xpthread_barrierattr_init (&attr);
+  xpthread_barrierattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+  xpthread_barrier_init (&barrier, &attr, nthreads);
+  /* Process-shared barriers cannot use a tree.  */
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count == nthreads);
+  xpthread_barrier_destroy (&barrier);
+  xpthread_barrierattr_destroy (&attr);
+
+  xpthread_barrier_init (&barrier, NULL, BARRIER_TREE_THRESHOLD - 1);
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count
+	       == BARRIER_TREE_THRESHOLD - 1);
+  xpthread_barrier_destroy (&barrier);
+
+  /* Barriers for more threads than trees support use the default
+     algorithm.  */
+  xpthread_barrier_init (&barrier, NULL, BARRIER_TREE_MAX);
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count == 0);
+  xpthread_barrier_destroy (&barrier);
+  xpthread_barrier_init (&barrier, NULL, BARRIER_TREE_MAX + 1);
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count
+	       == BARRIER_TREE_MAX + 1);
+  xpthread_barrier_destroy (&barrier);
+  xpthread_barrier_init (&barrier, NULL, BARRIER_IN_THRESHOLD - 1);
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count
+	       == BARRIER_IN_THRESHOLD - 1);
+  xpthread_barrier_destroy (&barrier);
+
+  xpthread_barrier_init (&barrier, NULL, nthreads);
+  TEST_VERIFY (((struct pthread_barrier *) &barrier)->count == 0);
+  xpthread_barrier_init (&barrier2, NULL, nthreads);
+
+  pthread_t threads[2 * nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    threads[i] = xpthread_create (NULL, worker, (void *) (intptr_t) i);
+  for (int i = 0; i < nthreads; ++i)
+    xpthread_join (threads[i]);
+  TEST_COMPARE (atomic_load (&serial), rounds);
+  xpthread_barrier_destroy (&barrier2);
+
+  /* More threads than the count use the barrier at the same time.  The
+     threads in excess of the count start and complete the second round
+     while the thread which completed the first round may still be
+     releasing the leaves.  */
+  for (int repeat = 0; repeat < 20; ++repeat)
+    {
+      atomic_store (&serial, 0);
+      for (int i = 0; i < 2 * nthreads; ++i)
+	threads[i] = xpthread_create (NULL, wait_once, NULL);
+      for (int i = 0; i < 2 * nthreads; ++i)
+	xpthread_join (threads[i]);
+      TEST_COMPARE (atomic_load (&serial), 2);
+    }
+
+  xpthread_barrier_destroy (&barrier);
+  return 0;
+}
+
+#include <support/test-driver.c>
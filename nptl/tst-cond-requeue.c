@@ -0,0 +1,172 @@
+/* Test pthread_cond_broadcast requeueing waiters to the mutex.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <array_length.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xthread.h>
+#include <support/xtime.h>
+#include <time.h>
+
+enum { nthreads = 16, rounds = 200 };
+
+static pthread_mutex_t mutex;
+static pthread_cond_t cond;
+static unsigned int generation;
+static unsigned int waiting;
+static bool timed;
+
+static void *
+waiter (void *closure)
+{
+  for (int round = 0; round < rounds; ++round)
+    {
+      xpthread_mutex_lock (&mutex);
+      unsigned int current = generation;
+      ++waiting;
+      struct timespec timeout = timespec_add (xclock_now (CLOCK_REALTIME),
+					      make_timespec (0, 1000 * 1000));
+      while (generation == current)
+	{
+	  int ret;
+	  if (timed)
+	    ret = pthread_cond_timedwait (&cond, &mutex, &timeout);
+	  else
+	    ret = pthread_cond_wait (&cond, &mutex);
+	  if (ret == ETIMEDOUT)
+	    /* Keep the timeout short so that it happens both before and
+	       after the broadcast.  */
+	    timeout = timespec_add (xclock_now (CLOCK_REALTIME),
+				    make_timespec (0, 1000 * 1000));
+	  else
+	    TEST_COMPARE (ret, 0);
+	}
+      xpthread_mutex_unlock (&mutex);
+    }
+  return NULL;
+}
+
+/* Lock the mutex once all threads wait for the next generation.  */
+static void
+lock_all_waiting (void)
+{
+  while (true)
+    {
+      xpthread_mutex_lock (&mutex);
+      if (waiting == nthreads)
+	break;
+      xpthread_mutex_unlock (&mutex);
+      sched_yield ();
+    }
+}
+
+static void
+broadcast_round (void)
+{
+  lock_all_waiting ();
+  waiting = 0;
+  ++generation;
+  TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+  xpthread_mutex_unlock (&mutex);
+}
+
+static void
+run (int type, int protocol, bool timedwait, bool requeue)
+{
+  printf ("info: type %d, protocol %d, %s\n", type, protocol,
+	  timedwait ? "pthread_cond_timedwait" : "pthread_cond_wait");
+
+  pthread_mutexattr_t attr;
+  xpthread_mutexattr_init (&attr);
+  xpthread_mutexattr_settype (&attr, type);
+  xpthread_mutexattr_setprotocol (&attr, protocol);
+  xpthread_mutex_init (&mutex, &attr);
+  xpthread_mutexattr_destroy (&attr);
+  TEST_COMPARE (pthread_cond_init (&cond, NULL), 0);
+  timed = timedwait;
+  waiting = 0;
+
+  pthread_t threads[nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    threads[i] = xpthread_create (NULL, waiter, NULL);
+  for (int round = 0; round < rounds; ++round)
+    broadcast_round ();
+  for (int i = 0; i < nthreads; ++i)
+    xpthread_join (threads[i]);
+
+  /* Only mutexes which __pthread_mutex_cond_lock acquires with
+     lll_cond_lock are used for requeueing.  */
+  TEST_VERIFY (cond.__data.__mutex == (requeue ? &mutex : NULL));
+
+  TEST_COMPARE (pthread_cond_destroy (&cond), 0);
+  xpthread_mutex_destroy (&mutex);
+}
+
+static void *
+waiter_once (void *closure)
+{
+  xpthread_mutex_lock (&mutex);
+  ++waiting;
+  while (generation == 0)
+    xpthread_cond_wait (&cond, &mutex);
+  xpthread_mutex_unlock (&mutex);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  static const int types[] =
+    {
+      PTHREAD_MUTEX_NORMAL, PTHREAD_MUTEX_RECURSIVE,
+      PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_ADAPTIVE_NP
+    };
+  for (int i = 0; i < array_length (types); ++i)
+    {
+      run (types[i], PTHREAD_PRIO_NONE, false, true);
+      run (types[i], PTHREAD_PRIO_NONE, true, true);
+    }
+  run (PTHREAD_MUTEX_NORMAL, PTHREAD_PRIO_INHERIT, false, false);
+
+  /* Destroying the condvar while holding the mutex must wake waiters that
+     have been requeued to the mutex.  */
+  xpthread_mutex_init (&mutex, NULL);
+  TEST_COMPARE (pthread_cond_init (&cond, NULL), 0);
+  generation = 0;
+  waiting = 0;
+  pthread_t threads[nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    threads[i] = xpthread_create (NULL, waiter_once, NULL);
+  lock_all_waiting ();
+  generation = 1;
+  TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+  TEST_COMPARE (pthread_cond_destroy (&cond), 0);
+  xpthread_mutex_unlock (&mutex);
+  for (int i = 0; i < nthreads; ++i)
+    xpthread_join (threads[i]);
+  xpthread_mutex_destroy (&mutex);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,189 @@
+/* Test the lock contention profile (glibc.pthread.lock_profile_rate).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/temp_file.h>
+#include <support/xstdio.h>
+#include <support/xthread.h>
+#include <support/xunistd.h>
+#include <time.h>
+
+/* The time for which the main thread holds each lock while the other
+   thread blocks on it.  */
+#define HOLD_NS (50 * 1000 * 1000)
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t mutex_pi;
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_barrier_t barrier;
+static bool signaled;
+
+static void
+hold (void)
+{
+  nanosleep (&(struct timespec) { 0, HOLD_NS }, NULL);
+}
+
+static void *
+thread_mutex (void *closure)
+{
+  pthread_mutex_t *m = closure;
+  xpthread_barrier_wait (&barrier);
+  xpthread_mutex_lock (m);
+  xpthread_mutex_unlock (m);
+  return NULL;
+}
+
+static void *
+thread_rdlock (void *closure)
+{
+  xpthread_barrier_wait (&barrier);
+  xpthread_rwlock_rdlock (&rwlock);
+  xpthread_rwlock_unlock (&rwlock);
+  return NULL;
+}
+
+static void *
+thread_wrlock (void *closure)
+{
+  xpthread_barrier_wait (&barrier);
+  xpthread_rwlock_wrlock (&rwlock);
+  xpthread_rwlock_unlock (&rwlock);
+  return NULL;
+}
+
+static void *
+thread_cond (void *closure)
+{
+  xpthread_mutex_lock (&mutex);
+  xpthread_barrier_wait (&barrier);
+  while (!signaled)
+    xpthread_cond_wait (&cond, &mutex);
+  xpthread_mutex_unlock (&mutex);
+  return NULL;
+}
+
+/* Block on M in another thread while the main thread holds it.  */
+static void
+contend_mutex (pthread_mutex_t *m)
+{
+  xpthread_mutex_lock (m);
+  pthread_t thr = xpthread_create (NULL, thread_mutex, m);
+  xpthread_barrier_wait (&barrier);
+  hold ();
+  xpthread_mutex_unlock (m);
+  xpthread_join (thr);
+}
+
+/* Block on the rwlock with START in another thread while the main thread
+   holds a write lock.  */
+static void
+contend_rwlock (void *(*start) (void *))
+{
+  xpthread_rwlock_wrlock (&rwlock);
+  pthread_t thr = xpthread_create (NULL, start, NULL);
+  xpthread_barrier_wait (&barrier);
+  hold ();
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_join (thr);
+}
+
+/* Return true if the profile in PROFILE has an entry of KIND for LOCK
+   which waited for at least HOLD_NS / 2.  */
+static bool
+find_entry (const char *profile, const char *kind, void *lock)
+{
+  char prefix[64];
+  snprintf (prefix, sizeof (prefix), "%s %p ", kind, lock);
+  for (const char *p = profile; p != NULL && *p != '\0';
+       p = strchr (p, '\n'), p = p != NULL ? p + 1 : NULL)
+    if (strncmp (p, prefix, strlen (prefix)) == 0)
+      {
+	void *site;
+	uint64_t count, total, max;
+	TEST_COMPARE (sscanf (p + strlen (prefix),
+			      "%p %" SCNu64 " %" SCNu64 " %" SCNu64,
+			      &site, &count, &total, &max), 4);
+	TEST_VERIFY (site != NULL);
+	TEST_VERIFY (count >= 1);
+	TEST_VERIFY (max <= total);
+	return total >= HOLD_NS / 2;
+      }
+  return false;
+}
+
+static int
+do_test (void)
+{
+  xpthread_barrier_init (&barrier, NULL, 2);
+
+  pthread_mutexattr_t attr;
+  TEST_COMPARE (pthread_mutexattr_init (&attr), 0);
+  TEST_COMPARE (pthread_mutexattr_setprotocol (&attr, PTHREAD_PRIO_INHERIT),
+		0);
+  TEST_COMPARE (pthread_mutex_init (&mutex_pi, &attr), 0);
+  TEST_COMPARE (pthread_mutexattr_destroy (&attr), 0);
+
+  contend_mutex (&mutex);
+  contend_mutex (&mutex_pi);
+  contend_rwlock (thread_rdlock);
+  contend_rwlock (thread_wrlock);
+
+  pthread_t thr = xpthread_create (NULL, thread_cond, NULL);
+  xpthread_barrier_wait (&barrier);
+  hold ();
+  xpthread_mutex_lock (&mutex);
+  signaled = true;
+  xpthread_cond_signal (&cond);
+  xpthread_mutex_unlock (&mutex);
+  xpthread_join (thr);
+
+  int fd = create_temp_file ("tst-lock-profile", NULL);
+  TEST_VERIFY_EXIT (fd >= 0);
+  TEST_COMPARE (pthread_lock_profile_dump_np (fd), 0);
+  xlseek (fd, 0, SEEK_SET);
+  FILE *fp = fdopen (fd, "r");
+  TEST_VERIFY_EXIT (fp != NULL);
+  char *profile = NULL;
+  size_t size = 0;
+  TEST_VERIFY (getdelim (&profile, &size, '\0', fp) > 0);
+  xfclose (fp);
+  printf ("%s", profile);
+
+  TEST_VERIFY (strncmp (profile, "lock profile: rate 1, 0 dropped\n",
+			strlen ("lock profile: rate 1, 0 dropped\n")) == 0);
+  TEST_VERIFY (find_entry (profile, "mutex", &mutex));
+  TEST_VERIFY (find_entry (profile, "mutex", &mutex_pi));
+  TEST_VERIFY (find_entry (profile, "rdlock", &rwlock));
+  TEST_VERIFY (find_entry (profile, "wrlock", &rwlock));
+  TEST_VERIFY (find_entry (profile, "cond", &cond));
+  TEST_VERIFY (strstr (profile, "\nMAPPED_LIBRARIES:\n") != NULL);
+
+  free (profile);
+  xpthread_barrier_destroy (&barrier);
+  return 0;
+}
+
+#include <support/test-driver.c>
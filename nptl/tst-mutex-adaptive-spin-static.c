@@ -0,0 +1,84 @@
+/* Test that adaptive mutexes stop spinning on long-held locks.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <pthreadP.h>
+#include <time.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+static pthread_mutex_t mutex;
+static pthread_barrier_t barrier;
+
+/* Hold MUTEX for much longer than any spin.  */
+static void *
+hold (void *closure)
+{
+  xpthread_mutex_lock (&mutex);
+  xpthread_barrier_wait (&barrier);
+  nanosleep (&(struct timespec) { 0, 10 * 1000 * 1000 }, NULL);
+  xpthread_mutex_unlock (&mutex);
+  return NULL;
+}
+
+/* Wait for MUTEX while another thread holds it, and return whether the
+   wait was allowed to spin.  */
+static bool
+contended_lock (void)
+{
+  xpthread_barrier_init (&barrier, NULL, 2);
+  pthread_t thr = xpthread_create (NULL, hold, NULL);
+  xpthread_barrier_wait (&barrier);
+  bool spin = adaptive_spin_limit (&mutex) != 0;
+  xpthread_mutex_lock (&mutex);
+  xpthread_mutex_unlock (&mutex);
+  xpthread_join (thr);
+  xpthread_barrier_destroy (&barrier);
+  return spin;
+}
+
+static int
+do_test (void)
+{
+  pthread_mutexattr_t attr;
+  xpthread_mutexattr_init (&attr);
+  xpthread_mutexattr_settype (&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+  xpthread_mutex_init (&mutex, &attr);
+  xpthread_mutexattr_destroy (&attr);
+
+  if (max_adaptive_count () == 0)
+    FAIL_UNSUPPORTED ("spinning disabled by glibc.pthread.mutex_spin_count");
+
+  /* The first waits spin, and fail to acquire the mutex by spinning.  */
+  TEST_VERIFY (contended_lock ());
+  TEST_VERIFY (contended_lock ());
+
+  /* Then waiters block right away, but try spinning again now and
+     then.  */
+  int spins = 0;
+  for (int i = 0; i < 20; ++i)
+    spins += contended_lock ();
+  printf ("info: %d of 20 waits spun\n", spins);
+  TEST_VERIFY (spins > 0);
+  TEST_VERIFY (spins < 10);
+
+  xpthread_mutex_destroy (&mutex);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,111 @@
+/* Test PTHREAD_MUTEX_QUEUED_NP mutexes.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { nthreads = 16, rounds = 20000 };
+
+static pthread_mutex_t mutex;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+
+/* Protected by MUTEX.  */
+static unsigned long int counter;
+static unsigned long int in_critical_section;
+static unsigned int items;
+
+static void *
+contend (void *closure)
+{
+  for (int i = 0; i < rounds; ++i)
+    {
+      xpthread_mutex_lock (&mutex);
+      TEST_COMPARE (in_critical_section++, 0);
+      ++counter;
+      --in_critical_section;
+      xpthread_mutex_unlock (&mutex);
+    }
+  return NULL;
+}
+
+static void *
+consume (void *closure)
+{
+  for (int i = 0; i < rounds; ++i)
+    {
+      xpthread_mutex_lock (&mutex);
+      while (items == 0)
+	xpthread_cond_wait (&cond, &mutex);
+      --items;
+      xpthread_mutex_unlock (&mutex);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_mutexattr_t attr;
+  int kind;
+  xpthread_mutexattr_init (&attr);
+  xpthread_mutexattr_settype (&attr, PTHREAD_MUTEX_QUEUED_NP);
+  TEST_COMPARE (pthread_mutexattr_gettype (&attr, &kind), 0);
+  TEST_COMPARE (kind, PTHREAD_MUTEX_QUEUED_NP);
+
+  /* The queue cannot be shared between processes, and robust and
+     priority protocol mutexes use their own algorithms.  */
+  pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+  TEST_COMPARE (pthread_mutex_init (&mutex, &attr), ENOTSUP);
+  pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_PRIVATE);
+  pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST);
+  TEST_COMPARE (pthread_mutex_init (&mutex, &attr), ENOTSUP);
+  pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_STALLED);
+  xpthread_mutex_init (&mutex, &attr);
+  xpthread_mutexattr_destroy (&attr);
+
+  TEST_COMPARE (pthread_mutex_trylock (&mutex), 0);
+  TEST_COMPARE (pthread_mutex_trylock (&mutex), EBUSY);
+  xpthread_mutex_unlock (&mutex);
+
+  /* Many threads waiting in the queue.  */
+  pthread_t threads[nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    threads[i] = xpthread_create (NULL, contend, NULL);
+  for (int i = 0; i < nthreads; ++i)
+    xpthread_join (threads[i]);
+  TEST_COMPARE (counter, nthreads * rounds);
+
+  /* The mutex is relocked by condition variable waits.  */
+  pthread_t consumer = xpthread_create (NULL, consume, NULL);
+  for (int i = 0; i < rounds; ++i)
+    {
+      xpthread_mutex_lock (&mutex);
+      ++items;
+      xpthread_cond_signal (&cond);
+      xpthread_mutex_unlock (&mutex);
+    }
+  xpthread_join (consumer);
+  TEST_COMPARE (items, 0);
+
+  xpthread_mutex_destroy (&mutex);
+  return 0;
+}
+
+#include <support/test-driver.c>
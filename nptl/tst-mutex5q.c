@@ -0,0 +1,2 @@
+#define TYPE PTHREAD_MUTEX_QUEUED_NP
+#include "tst-mutex5.c"
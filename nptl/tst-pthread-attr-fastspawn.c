@@ -0,0 +1,100 @@
+/* Test pthread_attr_setfastspawn_np and pthread_attr_getfastspawn_np.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <support/check.h>
+#include <support/xthread.h>
+#include <sys/rseq.h>
+#include <thread_pointer.h>
+
+enum { nthreads = 1000 };
+
+/* Return the cpu_id field of the rseq area of the calling thread.  */
+static int
+rseq_cpu_id (void)
+{
+  struct rseq *rseq = (struct rseq *) ((char *) __thread_pointer ()
+				       + __rseq_offset);
+  return *(volatile int32_t *) &rseq->cpu_id;
+}
+
+static void *
+square (void *closure)
+{
+  uintptr_t n = (uintptr_t) closure;
+  return (void *) (n * n);
+}
+
+static void *
+check_registered (void *closure)
+{
+  TEST_VERIFY (rseq_cpu_id () >= 0);
+  return NULL;
+}
+
+static void *
+check_fast_thread (void *closure)
+{
+  pthread_attr_t attr;
+  int fastspawn;
+  TEST_COMPARE (pthread_getattr_np (pthread_self (), &attr), 0);
+  TEST_COMPARE (pthread_attr_getfastspawn_np (&attr, &fastspawn), 0);
+  TEST_COMPARE (fastspawn, 1);
+  xpthread_attr_destroy (&attr);
+
+  if (__rseq_size > 0)
+    {
+      /* The thread is not registered with rseq, but threads it creates
+	 without the attribute are.  */
+      TEST_COMPARE (rseq_cpu_id (), RSEQ_CPU_ID_REGISTRATION_FAILED);
+      xpthread_join (xpthread_create (NULL, check_registered, NULL));
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_attr_t attr;
+  int fastspawn;
+  xpthread_attr_init (&attr);
+  TEST_COMPARE (pthread_attr_getfastspawn_np (&attr, &fastspawn), 0);
+  TEST_COMPARE (fastspawn, 0);
+  TEST_COMPARE (pthread_attr_setfastspawn_np (&attr, 2), EINVAL);
+  TEST_COMPARE (pthread_attr_setfastspawn_np (&attr, 1), 0);
+  TEST_COMPARE (pthread_attr_getfastspawn_np (&attr, &fastspawn), 0);
+  TEST_COMPARE (fastspawn, 1);
+
+  /* Fast-spawn threads reuse the stacks of their predecessors.  */
+  for (uintptr_t i = 0; i < nthreads; ++i)
+    TEST_VERIFY (xpthread_join (xpthread_create (&attr, square, (void *) i))
+		 == (void *) (i * i));
+
+  xpthread_join (xpthread_create (&attr, check_fast_thread, NULL));
+
+  TEST_COMPARE (pthread_attr_setfastspawn_np (&attr, 0), 0);
+  TEST_COMPARE (pthread_attr_getfastspawn_np (&attr, &fastspawn), 0);
+  TEST_COMPARE (fastspawn, 0);
+  xpthread_attr_destroy (&attr);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,88 @@
+/* Test PTHREAD_RWLOCK_READER_BIASED_NP rwlocks across fork.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <support/check.h>
+#include <support/xthread.h>
+#include <support/xunistd.h>
+#include <sys/wait.h>
+
+static pthread_rwlock_t rwlock;
+
+/* Release the read lock taken before fork, then check that the lock is
+   free.  A stale visible readers slot would make the write lock wait
+   forever, and a release through the normal algorithm would underflow
+   the number of readers.  */
+static void
+check_unlock (void)
+{
+  xpthread_rwlock_unlock (&rwlock);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), 0);
+  TEST_COMPARE (pthread_rwlock_tryrdlock (&rwlock), EBUSY);
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_rwlock_wrlock (&rwlock);
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_rwlock_rdlock (&rwlock);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), EBUSY);
+  xpthread_rwlock_unlock (&rwlock);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), 0);
+  xpthread_rwlock_unlock (&rwlock);
+}
+
+static int
+do_test (void)
+{
+  pthread_rwlockattr_t attr;
+  xpthread_rwlockattr_init (&attr);
+  TEST_COMPARE (pthread_rwlockattr_setkind_np
+		(&attr, PTHREAD_RWLOCK_READER_BIASED_NP), 0);
+  TEST_COMPARE (pthread_rwlock_init (&rwlock, &attr), 0);
+  pthread_rwlockattr_destroy (&attr);
+
+  for (int i = 0; i < 2; ++i)
+    {
+      /* The first time, the read lock uses the visible readers table.
+	 The second time, a preceding write lock has revoked the bias, so
+	 it uses the normal algorithm.  */
+      if (i == 1)
+	{
+	  xpthread_rwlock_wrlock (&rwlock);
+	  xpthread_rwlock_unlock (&rwlock);
+	}
+      xpthread_rwlock_rdlock (&rwlock);
+
+      pid_t pid = xfork ();
+      if (pid == 0)
+	{
+	  check_unlock ();
+	  _exit (support_record_failure_is_failed () ? 1 : 0);
+	}
+      int status;
+      xwaitpid (pid, &status, 0);
+      TEST_VERIFY (WIFEXITED (status));
+      TEST_COMPARE (WEXITSTATUS (status), 0);
+
+      check_unlock ();
+    }
+
+  xpthread_rwlock_destroy (&rwlock);
+  return 0;
+}
+
+#include <support/test-driver.c>
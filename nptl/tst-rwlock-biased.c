@@ -0,0 +1,143 @@
+/* Test PTHREAD_RWLOCK_READER_BIASED_NP rwlocks.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xthread.h>
+#include <support/xtime.h>
+
+enum { nreaders = 8, nwriters = 2, rounds = 20000 };
+
+static pthread_rwlock_t rwlock;
+
+/* Protected by RWLOCK.  Writers keep them equal outside of their critical
+   sections.  */
+static unsigned long int value1;
+static unsigned long int value2;
+
+static void *
+reader (void *closure)
+{
+  for (int i = 0; i < rounds; ++i)
+    {
+      if (i % 4 == 0)
+	{
+	  if (pthread_rwlock_tryrdlock (&rwlock) != 0)
+	    continue;
+	}
+      else
+	xpthread_rwlock_rdlock (&rwlock);
+      TEST_COMPARE (value1, value2);
+      xpthread_rwlock_unlock (&rwlock);
+    }
+  return NULL;
+}
+
+static void *
+writer (void *closure)
+{
+  for (int i = 0; i < rounds / 10; ++i)
+    {
+      if (i % 4 == 0)
+	{
+	  if (pthread_rwlock_trywrlock (&rwlock) != 0)
+	    continue;
+	}
+      else
+	xpthread_rwlock_wrlock (&rwlock);
+      ++value1;
+      ++value2;
+      xpthread_rwlock_unlock (&rwlock);
+    }
+  return NULL;
+}
+
+/* Hold a read lock while the main thread tries to acquire a write
+   lock.  */
+static pthread_barrier_t barrier;
+
+static void *
+hold_read (void *closure)
+{
+  xpthread_rwlock_rdlock (&rwlock);
+  xpthread_barrier_wait (&barrier);
+  xpthread_barrier_wait (&barrier);
+  xpthread_rwlock_unlock (&rwlock);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_rwlockattr_t attr;
+  int kind;
+  xpthread_rwlockattr_init (&attr);
+  TEST_COMPARE (pthread_rwlockattr_setkind_np
+		(&attr, PTHREAD_RWLOCK_READER_BIASED_NP), 0);
+  TEST_COMPARE (pthread_rwlockattr_getkind_np (&attr, &kind), 0);
+  TEST_COMPARE (kind, PTHREAD_RWLOCK_READER_BIASED_NP);
+  TEST_COMPARE (pthread_rwlock_init (&rwlock, &attr), 0);
+  pthread_rwlockattr_destroy (&attr);
+
+  /* Recursive read locks, and a write lock once they are released.  */
+  xpthread_rwlock_rdlock (&rwlock);
+  xpthread_rwlock_rdlock (&rwlock);
+  TEST_COMPARE (pthread_rwlock_tryrdlock (&rwlock), 0);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), EBUSY);
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_rwlock_unlock (&rwlock);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), 0);
+  TEST_COMPARE (pthread_rwlock_tryrdlock (&rwlock), EBUSY);
+  TEST_COMPARE (pthread_rwlock_rdlock (&rwlock), EDEADLK);
+  xpthread_rwlock_unlock (&rwlock);
+
+  /* Writers wait for readers in other threads.  */
+  xpthread_barrier_init (&barrier, NULL, 2);
+  pthread_t thr = xpthread_create (NULL, hold_read, NULL);
+  xpthread_barrier_wait (&barrier);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), EBUSY);
+  struct timespec ts;
+  xclock_gettime (CLOCK_MONOTONIC, &ts);
+  ts = timespec_add (ts, make_timespec (0, 100 * 1000 * 1000));
+  TEST_COMPARE (pthread_rwlock_clockwrlock (&rwlock, CLOCK_MONOTONIC, &ts),
+		ETIMEDOUT);
+  /* Readers may still acquire the lock.  */
+  TEST_COMPARE (pthread_rwlock_tryrdlock (&rwlock), 0);
+  xpthread_rwlock_unlock (&rwlock);
+  xpthread_barrier_wait (&barrier);
+  xpthread_join (thr);
+  xpthread_barrier_destroy (&barrier);
+  TEST_COMPARE (pthread_rwlock_trywrlock (&rwlock), 0);
+  xpthread_rwlock_unlock (&rwlock);
+
+  /* Mixed readers and writers.  */
+  pthread_t threads[nreaders + nwriters];
+  for (int i = 0; i < nreaders + nwriters; ++i)
+    threads[i] = xpthread_create (NULL, i < nreaders ? reader : writer, NULL);
+  for (int i = 0; i < nreaders + nwriters; ++i)
+    xpthread_join (threads[i]);
+  TEST_COMPARE (value1, value2);
+
+  xpthread_rwlock_destroy (&rwlock);
+  return 0;
+}
+
+#include <support/test-driver.c>
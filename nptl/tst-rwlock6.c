@@ -38,6 +38,7 @@ static int kind[] =
     PTHREAD_RWLOCK_PREFER_READER_NP,
     PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
     PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_READER_BIASED_NP,
   };
 
 struct thread_args
@@ -0,0 +1,134 @@
+/* Test sem_waitany and sem_clockwaitany.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xthread.h>
+#include <support/xtime.h>
+
+enum { nsems = 4, nwaiters = 4, tokens = 20000 };
+
+static sem_t sem_storage[nsems];
+static sem_t *sems[nsems];
+
+static atomic_int taken[nsems];
+
+static void *
+take (void *closure)
+{
+  for (int i = 0; i < tokens / nwaiters; ++i)
+    {
+      int index = sem_waitany (sems, nsems);
+      TEST_VERIFY (index >= 0 && index < nsems);
+      atomic_fetch_add (&taken[index], 1);
+    }
+  return NULL;
+}
+
+static void *
+post_last (void *closure)
+{
+  nanosleep (&(struct timespec) { 0, 50 * 1000 * 1000 }, NULL);
+  TEST_COMPARE (sem_post (sems[nsems - 1]), 0);
+  return NULL;
+}
+
+static void *
+wait_forever (void *closure)
+{
+  sem_waitany (sems, nsems);
+  FAIL_EXIT1 ("sem_waitany returned");
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  for (int i = 0; i < nsems; ++i)
+    {
+      TEST_COMPARE (sem_init (&sem_storage[i], 0, 0), 0);
+      sems[i] = &sem_storage[i];
+    }
+
+  errno = 0;
+  TEST_COMPARE (sem_waitany (sems, 0), -1);
+  TEST_COMPARE (errno, EINVAL);
+  errno = 0;
+  TEST_COMPARE (sem_clockwaitany (sems, nsems, CLOCK_PROCESS_CPUTIME_ID,
+				  NULL), -1);
+  TEST_COMPARE (errno, EINVAL);
+
+  /* The semaphore with the lowest index is decremented.  */
+  TEST_COMPARE (sem_post (sems[2]), 0);
+  TEST_COMPARE (sem_post (sems[1]), 0);
+  TEST_COMPARE (sem_waitany (sems, nsems), 1);
+  TEST_COMPARE (sem_waitany (sems, nsems), 2);
+
+  /* Time out, with each of the supported clocks.  */
+  struct timespec ts;
+  xclock_gettime (CLOCK_MONOTONIC, &ts);
+  ts = timespec_add (ts, make_timespec (0, 100 * 1000 * 1000));
+  errno = 0;
+  TEST_COMPARE (sem_clockwaitany (sems, nsems, CLOCK_MONOTONIC, &ts), -1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+  TEST_TIMESPEC_NOW_OR_AFTER (CLOCK_MONOTONIC, ts);
+  xclock_gettime (CLOCK_REALTIME, &ts);
+  ts = timespec_add (ts, make_timespec (0, 100 * 1000 * 1000));
+  errno = 0;
+  TEST_COMPARE (sem_clockwaitany (sems, nsems, CLOCK_REALTIME, &ts), -1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+
+  /* Wake up on a post to any of the semaphores.  */
+  pthread_t thr = xpthread_create (NULL, post_last, NULL);
+  TEST_COMPARE (sem_clockwaitany (sems, nsems, CLOCK_MONOTONIC, NULL),
+		nsems - 1);
+  xpthread_join (thr);
+
+  /* Cancellation leaves the semaphores usable.  */
+  thr = xpthread_create (NULL, wait_forever, NULL);
+  nanosleep (&(struct timespec) { 0, 50 * 1000 * 1000 }, NULL);
+  xpthread_cancel (thr);
+  TEST_VERIFY (xpthread_join (thr) == PTHREAD_CANCELED);
+  TEST_COMPARE (sem_post (sems[0]), 0);
+  TEST_COMPARE (sem_trywait (sems[0]), 0);
+
+  /* Several waiters, and tokens posted to all semaphores.  No wake-up may
+     be lost.  */
+  pthread_t threads[nwaiters];
+  for (int i = 0; i < nwaiters; ++i)
+    threads[i] = xpthread_create (NULL, take, NULL);
+  for (int i = 0; i < tokens; ++i)
+    TEST_COMPARE (sem_post (sems[i % nsems]), 0);
+  for (int i = 0; i < nwaiters; ++i)
+    xpthread_join (threads[i]);
+  for (int i = 0; i < nsems; ++i)
+    {
+      int value;
+      TEST_COMPARE (sem_getvalue (sems[i], &value), 0);
+      TEST_COMPARE (value, 0);
+      TEST_COMPARE (atomic_load (&taken[i]), tokens / nsems);
+      TEST_COMPARE (sem_destroy (sems[i]), 0);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
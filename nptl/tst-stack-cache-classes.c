@@ -0,0 +1,150 @@
+/* Test reuse of cached thread stacks of different size classes.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <alloca.h>
+#include <array_length.h>
+#include <limits.h>
+#include <pthreaddef.h>
+#include <stackinfo.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/check_mem_access.h>
+#include <support/xthread.h>
+#include <sys/param.h>
+#include <unistd.h>
+
+static size_t pagesz;
+
+/* check_mem_access is not thread-safe.  */
+static pthread_mutex_t access_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Stack and guard sizes of the threads, in pages.  They span several
+   size classes of the stack cache, and each class has stacks of
+   different sizes, so that a new thread often finds cached stacks which
+   are too small, or of the next class, or which have another guard
+   size.  */
+static const struct
+{
+  unsigned int stack;
+  unsigned int guard;
+} configs[] =
+  {
+    { 17, 1 },
+    { 48, 16 },
+    { 33, 1 },
+    { 64, 2 },
+    { 96, 1 },
+    { 256, 16 },
+    { 200, 1 },
+    { 768, 4 },
+    { 16, 8 },
+  };
+
+struct thread_args
+{
+  size_t stacksize;
+  size_t guardsize;
+};
+
+static void *
+tf (void *closure)
+{
+  struct thread_args *args = closure;
+
+  pthread_attr_t attr;
+  TEST_COMPARE (pthread_getattr_np (pthread_self (), &attr), 0);
+  void *stackaddr;
+  size_t stacksize;
+  size_t guardsize;
+  TEST_COMPARE (pthread_attr_getstack (&attr, &stackaddr, &stacksize), 0);
+  TEST_COMPARE (pthread_attr_getguardsize (&attr, &guardsize), 0);
+  xpthread_attr_destroy (&attr);
+  char *stack = stackaddr;
+
+  /* A cached stack may be larger than requested, but never smaller, and
+     its guard is adjusted to the requested size.  */
+  TEST_VERIFY (stacksize >= args->stacksize);
+  TEST_COMPARE (guardsize, args->guardsize);
+
+  /* Use most of the requested size.  */
+  size_t used = args->stacksize / 2;
+  char *buf = alloca (used);
+  memset (buf, 0xa5, used);
+  TEST_COMPARE (buf[used - 1], (char) 0xa5);
+
+  xpthread_mutex_lock (&access_lock);
+  TEST_VERIFY (check_mem_access (stack, true));
+  TEST_VERIFY (check_mem_access (&stack[stacksize - 1], false));
+
+#if _STACK_GROWS_DOWN
+  /* The whole guard area is inaccessible, and it directly precedes the
+     stack.  */
+  guardsize = MAX (guardsize, ARCH_MIN_GUARD_SIZE);
+  char *guard = stack - guardsize;
+  TEST_VERIFY (!check_mem_access (guard, false));
+  TEST_VERIFY (!check_mem_access (&guard[guardsize / 2], false));
+  TEST_VERIFY (!check_mem_access (&guard[guardsize - 1], false));
+#endif
+  xpthread_mutex_unlock (&access_lock);
+
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pagesz = sysconf (_SC_PAGESIZE);
+
+  struct thread_args args[array_length (configs)];
+  pthread_attr_t attrs[array_length (configs)];
+  for (size_t i = 0; i < array_length (configs); ++i)
+    {
+      args[i].stacksize = MAX (configs[i].stack * pagesz, PTHREAD_STACK_MIN);
+      args[i].guardsize = configs[i].guard * pagesz;
+      xpthread_attr_init (&attrs[i]);
+      xpthread_attr_setstacksize (&attrs[i], args[i].stacksize);
+      xpthread_attr_setguardsize (&attrs[i], args[i].guardsize);
+    }
+
+  /* In each round, the threads are started in another order, so they
+     pick up the stacks cached by the previous round.  Running some of
+     them concurrently keeps stacks of several classes in the cache.  */
+  for (size_t round = 0; round < 3 * array_length (configs); ++round)
+    {
+      pthread_t threads[array_length (configs)];
+      size_t count = round % 3 + 1;
+      for (size_t first = 0; first < array_length (configs); first += count)
+	{
+	  size_t n = MIN (count, array_length (configs) - first);
+	  for (size_t j = 0; j < n; ++j)
+	    {
+	      size_t i = (first + j + round) % array_length (configs);
+	      threads[j] = xpthread_create (&attrs[i], tf, &args[i]);
+	    }
+	  for (size_t j = 0; j < n; ++j)
+	    xpthread_join (threads[j]);
+	}
+    }
+
+  for (size_t i = 0; i < array_length (configs); ++i)
+    xpthread_attr_destroy (&attrs[i]);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
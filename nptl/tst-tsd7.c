@@ -0,0 +1,112 @@
+/* Test destructors of thread-specific data in different key blocks.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Enough keys for several blocks of 32 keys.  */
+enum { nkeys = 200 };
+
+static pthread_key_t keys[nkeys];
+static unsigned int calls[nkeys];
+
+/* The values are KEY + 1 + (DEPTH << 16).  The destructor for a value
+   with DEPTH < MAX_DEPTH sets the next key in the chain, which is in a
+   later block, so that some destructors run in later rounds and in blocks
+   that have not been used before the thread exited.  MAX_DEPTH stays
+   below PTHREAD_DESTRUCTOR_ITERATIONS, and the chains starting at
+   different keys never meet.  */
+enum { step = 37, spacing = 50, max_depth = 3 };
+
+static void *
+make_value (uintptr_t key, uintptr_t depth)
+{
+  return (void *) (key + 1 + (depth << 16));
+}
+
+static void
+destructor (void *value)
+{
+  uintptr_t i = ((uintptr_t) value & 0xffff) - 1;
+  uintptr_t depth = (uintptr_t) value >> 16;
+  TEST_VERIFY_EXIT (i < nkeys);
+  ++calls[i];
+  TEST_VERIFY (pthread_getspecific (keys[i]) == NULL);
+  if (depth < max_depth && i + step < nkeys)
+    TEST_COMPARE (pthread_setspecific (keys[i + step],
+				       make_value (i + step, depth + 1)), 0);
+}
+
+static void *
+thread_set (void *closure)
+{
+  uintptr_t first = (uintptr_t) closure;
+  for (uintptr_t i = first; i < nkeys; i += spacing)
+    TEST_COMPARE (pthread_setspecific (keys[i], make_value (i, 0)), 0);
+  return NULL;
+}
+
+/* A thread reusing a cached stack sees no data.  */
+static void *
+thread_check (void *closure)
+{
+  for (int i = 0; i < nkeys; ++i)
+    TEST_VERIFY (pthread_getspecific (keys[i]) == NULL);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  for (int i = 0; i < nkeys; ++i)
+    TEST_COMPARE (pthread_key_create (&keys[i], destructor), 0);
+
+  for (uintptr_t first = 0; first < spacing; first += 7)
+    {
+      for (int i = 0; i < nkeys; ++i)
+	calls[i] = 0;
+      xpthread_join (xpthread_create (NULL, thread_set, (void *) first));
+
+      /* All keys which have been set directly, or through a chain of
+	 destructors, have been destroyed once.  */
+      for (int i = 0; i < nkeys; ++i)
+	{
+	  unsigned int expected = 0;
+	  for (int depth = 0; depth <= max_depth; ++depth)
+	    {
+	      int start = i - depth * step;
+	      if (start >= (int) first
+		  && (start - (int) first) % spacing == 0)
+		expected = 1;
+	    }
+	  if (calls[i] != expected)
+	    FAIL ("key %d (first %d): %u destructor calls, expected %u",
+		  i, (int) first, calls[i], expected);
+	}
+
+      xpthread_join (xpthread_create (NULL, thread_check, NULL));
+    }
+
+  for (int i = 0; i < nkeys; ++i)
+    TEST_COMPARE (pthread_key_delete (keys[i]), 0);
+  return 0;
+}
+
+#include <support/test-driver.c>
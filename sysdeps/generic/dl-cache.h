@@ -220,6 +220,18 @@ enum cache_extension_tag
       size must be a multiple of 4.  */
    cache_extension_tag_glibc_hwcaps,
 
+   /* Hash table for the library names in the new-format entries.  An
+      array of uint32_t values.  The first value is the number of
+      slots, a power of two.  Each slot consists of two values, the
+      hash of a library name (see _dl_cache_name_hash) and the index
+      of the first entry with this name, or UINT32_MAX for an empty
+      slot.  Collisions are resolved by linear probing, and at least
+      one slot is empty.  The binary search over the entries is used
+      if this section is missing.
+
+      For this section, 4-byte alignment is required.  */
+   cache_extension_tag_name_hash,
+
    /* Total number of known cache extension tags.  */
    cache_extension_count
   };
@@ -293,6 +305,26 @@ cache_extension_verify (struct cache_extension_all_loaded *loaded)
 	hwcaps->flags = 0;
       }
   }
+
+  {
+    /* Section must be aligned at 4 bytes, and its size must match the
+       number of slots, which is a non-zero power of two.  */
+    struct cache_extension_loaded *hash
+      = &loaded->sections[cache_extension_tag_name_hash];
+    uint32_t slots = 0;
+    if (hash->size >= sizeof (uint32_t)
+	&& ((uintptr_t) hash->base % 4) == 0)
+      slots = *(const uint32_t *) hash->base;
+    if (slots == 0
+	|| (slots & (slots - 1)) != 0
+	|| slots > (UINT32_MAX - sizeof (uint32_t)) / (2 * sizeof (uint32_t))
+	|| hash->size != sizeof (uint32_t) + slots * 2 * sizeof (uint32_t))
+      {
+	hash->base = NULL;
+	hash->size = 0;
+	hash->flags = 0;
+      }
+  }
 }
 
 static bool __attribute__ ((unused))
@@ -352,4 +384,25 @@ cache_extension_load (const struct cache_file_new *cache,
 
 extern int _dl_cache_libcmp (const char *p1, const char *p2) attribute_hidden;
 
+/* Hash function for the cache_extension_tag_name_hash section.  Names
+   which are equal according to _dl_cache_libcmp have the same hash:
+   digit sequences are compared numerically, so their leading zeros are
+   skipped.  */
+static inline uint32_t
+_dl_cache_name_hash (const char *name)
+{
+  uint32_t hash = 5381;
+  bool in_number = false;
+  for (; *name != '\0'; ++name)
+    {
+      bool digit = *name >= '0' && *name <= '9';
+      if (digit && !in_number && *name == '0'
+	  && name[1] >= '0' && name[1] <= '9')
+	continue;
+      in_number = digit;
+      hash = hash * 33 + (unsigned char) *name;
+    }
+  return hash;
+}
+
 #endif /* _DL_CACHE_H */
@@ -367,9 +367,10 @@ struct rtld_global
      the loaded object might as well require a call to this function.
      At this time it is not anymore a problem to modify the tables.  */
   __rtld_lock_define_recursive (EXTERN, _dl_load_lock)
-  /* This lock is used to keep __dl_iterate_phdr from inspecting the
-     list of loaded objects while an object is added to or removed
-     from that list.  */
+  /* This lock is used to keep __dl_iterate_phdr, dladdr and dlsym
+     from inspecting the list of loaded objects while an object is
+     added to or removed from that list.  It is held only briefly by
+     dlopen and dlclose.  */
   __rtld_lock_define_recursive (EXTERN, _dl_load_write_lock)
   /* This lock protects global and module specific TLS related data.
      E.g. it is held in dlopen and dlclose when GL(dl_tls_generation),
@@ -458,8 +459,10 @@ struct rtld_global
   /* List of thread stacks that were allocated by the application.  */
   EXTERN list_t _dl_stack_user;
 
-  /* List of queued thread stacks.  */
-  EXTERN list_t _dl_stack_cache;
+  /* Lists of queued thread stacks, one per size class.  See
+     __nptl_stack_cache_class.  */
+#define DL_STACK_CACHE_CLASSES 12
+  EXTERN list_t _dl_stack_cache[DL_STACK_CACHE_CLASSES];
 
   /* Total size of all stacks in the cache (sum over stackblock_size).  */
   EXTERN size_t _dl_stack_cache_actsize;
@@ -26,3 +26,11 @@ check_may_shrink_heap (void)
 {
   return __libc_enable_secure;
 }
+
+/* Return the CPU the calling thread is running on, or a negative value if
+   it cannot be determined cheaply.  */
+static inline int
+malloc_getcpu (void)
+{
+  return -1;
+}
@@ -25,8 +25,8 @@ struct __pthread_rwlock_arch_t
   unsigned int __writers;
   unsigned int __wrphase_futex;
   unsigned int __writers_futex;
-  unsigned int __pad3;
-  unsigned int __pad4;
+  unsigned int __bias;
+  unsigned int __bias_inhibit;
 #if _MIPS_SIM == _ABI64
   int __cur_writer;
   int __shared;
@@ -32,8 +32,8 @@ struct __pthread_rwlock_arch_t
   unsigned int __writers;
   unsigned int __wrphase_futex;
   unsigned int __writers_futex;
-  unsigned int __pad3;
-  unsigned int __pad4;
+  unsigned int __bias;
+  unsigned int __bias_inhibit;
   /* FLAGS must stay at its position in the structure to maintain
      binary compatibility.  */
 #if __BYTE_ORDER == __BIG_ENDIAN
@@ -99,8 +99,11 @@ struct __pthread_cond_s
   unsigned int __g1_orig_size;
   unsigned int __wrefs;
   unsigned int __g_signals[2];
-  unsigned int __unused_initialized_1;
-  unsigned int __unused_initialized_2;
+  __extension__ union
+  {
+    void *__mutex;
+    unsigned int __unused_initialized[2];
+  };
 };
 
 typedef unsigned int __tss_t;
@@ -24,6 +24,7 @@
 #include <ldsodefs.h>
 #include <list.h>
 #include <mqueue.h>
+#include <nptl-stack.h>
 #include <pthreadP.h>
 #include <sysdep.h>
 #include <getrandom-internal.h>
@@ -44,6 +45,7 @@ fork_system_setup_after_fork (void)
   /* Initialize thread library locks.  */
   GL (dl_stack_cache_lock) = LLL_LOCK_INITIALIZER;
   __default_pthread_attr_lock = LLL_LOCK_INITIALIZER;
+  __nptl_lock_profile_lock = LLL_LOCK_INITIALIZER;
 
   call_function_static_weak (__mq_notify_fork_subprocess);
   call_function_static_weak (__timer_fork_subprocess);
@@ -77,8 +79,13 @@ reclaim_stacks (void)
 
 	  if (GL (dl_stack_used).next->prev != &GL (dl_stack_used))
 	    l = &GL (dl_stack_used);
-	  else if (GL (dl_stack_cache).next->prev != &GL (dl_stack_cache))
-	    l = &GL (dl_stack_cache);
+	  else
+	    for (size_t i = 0; i < DL_STACK_CACHE_CLASSES; ++i)
+	      if (GL (dl_stack_cache)[i].next->prev != &GL (dl_stack_cache)[i])
+		{
+		  l = &GL (dl_stack_cache)[i];
+		  break;
+		}
 
 	  if (l != NULL)
 	    {
@@ -111,13 +118,13 @@ reclaim_stacks (void)
 	  /* Account for the size of the stack.  */
 	  GL (dl_stack_cache_actsize) += curp->stackblock_size;
 
-	  if (curp->specific_used)
+	  if (curp->specific_used != 0)
 	    {
 	      /* Clear the thread-specific data.  */
 	      memset (curp->specific_1stblock, '\0',
 		      sizeof (curp->specific_1stblock));
 
-	      curp->specific_used = false;
+	      curp->specific_used = 0;
 
 	      for (size_t cnt = 1; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
 		if (curp->specific[cnt] != NULL)
@@ -126,8 +133,8 @@ reclaim_stacks (void)
 			    sizeof (curp->specific_1stblock));
 
 		    /* We have allocated the block which we do not
-		       free here so re-set the bit.  */
-		    curp->specific_used = true;
+		       free here so re-set its bit.  */
+		    curp->specific_used |= 1U << cnt;
 		  }
 	    }
 
@@ -143,13 +150,20 @@ reclaim_stacks (void)
 	call_function_static_weak (__getrandom_reset_state, curp);
     }
 
-  /* Add the stack of all running threads to the cache.  */
-  list_splice (&GL (dl_stack_used), &GL (dl_stack_cache));
+  /* Add the stack of all other running threads to the cache, in the list
+     for its size class.  */
+  list_t *prev;
+  list_for_each_prev_safe (runp, prev, &GL (dl_stack_used))
+    {
+      struct pthread *curp = list_entry (runp, struct pthread, list);
+      if (curp != self)
+	list_add (runp, &GL (dl_stack_cache)[__nptl_stack_cache_class
+					     (curp->stackblock_size)]);
+    }
 
-  /* Remove the entry for the current thread to from the cache list
-     and add it to the list of running threads.  Which of the two
-     lists is decided by the user_stack flag.  */
-  list_del (&self->list);
+  /* Add the entry for the current thread to the list of running
+     threads.  Which of the two lists is decided by the user_stack
+     flag.  */
 
   /* Re-initialize the lists for all the threads.  */
   INIT_LIST_HEAD (&GL (dl_stack_used));
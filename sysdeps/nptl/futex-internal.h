@@ -23,6 +23,7 @@
 #include <sys/time.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <lowlevellock-futex.h>
 #include <libc-diag.h>
 
@@ -206,6 +207,40 @@ futex_wake (unsigned int* futex_word, int processes_to_wake, int private)
     }
 }
 
+/* If *FUTEX_WORD == EXPECTED, wakes up to PROCESSES_TO_WAKE of the waiters
+   blocked on FUTEX_WORD and moves up to PROCESSES_TO_MOVE of the others to
+   block on FUTEX_WORD2 instead, and returns true.  Both futex words must be
+   either process-private or process-shared, as indicated by PRIVATE.
+   Returns false if *FUTEX_WORD != EXPECTED, in which case no waiters are
+   woken or moved.
+
+   Like futex_wake, this can be called on past futexes whose memory has been
+   reused, so it returns false instead of aborting on the resulting
+   errors.  */
+static __always_inline bool
+futex_requeue (unsigned int *futex_word, unsigned int expected,
+	       int processes_to_wake, int processes_to_move,
+	       unsigned int *futex_word2, int private)
+{
+  int res = lll_futex_requeue (futex_word, processes_to_wake,
+			       processes_to_move, futex_word2, expected,
+			       private);
+  /* No error.  Ignore the number of woken and moved processes.  */
+  if (res >= 0)
+    return true;
+  switch (res)
+    {
+    case -EAGAIN: /* *FUTEX_WORD has changed.  */
+    case -EFAULT: /* Could have happened due to memory reuse.  */
+    case -EINVAL: /* Could be due to memory reuse for a PI futex.  */
+      return false;
+    case -ENOSYS: /* Must have been caused by a glibc bug.  */
+    /* No other errors are documented at this time.  */
+    default:
+      futex_fatal_error ();
+    }
+}
+
 /* The operation checks the value of the futex, if the value is 0, then
    it is atomically set to the caller's thread ID.  If the futex value is
    nonzero, it is atomically sets the FUTEX_WAITERS bit, which signals wrt
@@ -292,6 +327,48 @@ __futex_abstimed_wait64 (unsigned int* futex_word, unsigned int expected,
                          int private);
 libc_hidden_proto (__futex_abstimed_wait64);
 
+/* A futex word to wait on with __futex_abstimed_waitv_cancelable64, laid
+   out like struct futex_waitv of the kernel.  */
+struct futex_waitv_entry
+{
+  uint64_t expected;
+  uint64_t futex_word;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+/* The maximum number of futex words of a futex_waitv call.  */
+#define FUTEX_WAITV_MAX 128
+
+/* Set ENTRY to wait while *FUTEX_WORD == EXPECTED.  */
+static __always_inline void
+futex_waitv_entry_init (struct futex_waitv_entry *entry,
+			unsigned int *futex_word, unsigned int expected,
+			int private)
+{
+  entry->expected = expected;
+  entry->futex_word = (uintptr_t) futex_word;
+  entry->flags = (FUTEX2_SIZE_U32 | FUTEX2_PRIVATE) ^ private;
+  entry->reserved = 0;
+}
+
+/* Like __futex_abstimed_wait_cancelable64, but waits on the N futex words
+   described by ENTRIES at once, until one of them is woken up.  N must be
+   at most FUTEX_WAITV_MAX.  The private flag is part of each entry.
+
+   Returns the same values as __futex_abstimed_wait_cancelable64;
+   additionally, returns ENOSYS if the kernel does not support futex_waitv
+   (Linux 5.16 and later do) or the system call is not permitted, for
+   example by a seccomp filter.  In that case, the caller has to wait on
+   the futex words one at a time.
+
+   The call acts as a cancellation entrypoint.  */
+int
+__futex_abstimed_waitv_cancelable64 (struct futex_waitv_entry *entries,
+				     unsigned int n, clockid_t clockid,
+				     const struct __timespec64 *abstime);
+libc_hidden_proto (__futex_abstimed_waitv_cancelable64);
+
 
 static __always_inline int
 __futex_clocklock64 (int *futex, clockid_t clockid,
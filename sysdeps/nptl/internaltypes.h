@@ -51,6 +51,7 @@ struct pthread_attr
 #define ATTR_FLAG_SCHED_SET		0x0020
 #define ATTR_FLAG_POLICY_SET		0x0040
 #define ATTR_FLAG_DO_RSEQ		0x0080
+#define ATTR_FLAG_FAST_SPAWN		0x0100
 
 /* Used to allocate a pthread_attr_t object which is also accessed
    internally.  */
@@ -108,17 +109,30 @@ struct pthread_rwlockattr
 
 
 /* Barrier data structure.  See pthread_barrier_wait for a description
-   of how these fields are used.  */
+   of how these fields are used.  COUNT is 0 for barriers which use a
+   combining tree, see pthread_barrier_tree.c; TREE points to the tree
+   then.  */
 struct pthread_barrier
 {
-  unsigned int in;
-  unsigned int current_round;
+  union
+  {
+    struct
+    {
+      unsigned int in;
+      unsigned int current_round;
+    };
+    struct pthread_barrier_tree *tree;
+  };
   unsigned int count;
   int shared;
   unsigned int out;
 };
 /* See pthread_barrier_wait for a description.  */
 #define BARRIER_IN_THRESHOLD (UINT_MAX/2)
+/* Process-private barriers for at least BARRIER_TREE_THRESHOLD and at
+   most BARRIER_TREE_MAX threads use a combining tree.  */
+#define BARRIER_TREE_THRESHOLD 32
+#define BARRIER_TREE_MAX 65536
 
 
 /* Barrier variable attribute data structure.  */
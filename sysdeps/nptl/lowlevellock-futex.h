@@ -43,6 +43,10 @@
 
 #define FUTEX_BITSET_MATCH_ANY	0xffffffff
 
+/* Flags of the futex words passed to futex_waitv.  */
+#define FUTEX2_SIZE_U32		0x02
+#define FUTEX2_PRIVATE		FUTEX_PRIVATE_FLAG
+
 /* Values for 'private' parameter of locking macros.  Yes, the
    definition seems to be backwards.  But it is not.  The bit will be
    reversed before passing to the system call.  */
@@ -0,0 +1,50 @@
+/* Helper threads for malloc.  NPTL version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <signal.h>
+#include <stdbool.h>
+#include <pthreadP.h>
+
+/* Start a detached thread running START with all signals blocked.  Return
+   false if that is not possible, in which case malloc does the work of the
+   helper thread synchronously.  Static programs never use helper threads,
+   so that malloc does not pull in thread creation.  */
+static inline bool
+malloc_create_helper_thread (void *(*start) (void *))
+{
+#ifndef SHARED
+  return false;
+#else
+  /* The helper thread needs only very little resources.  */
+  pthread_attr_t attr;
+  __pthread_attr_init (&attr);
+  __pthread_attr_setstacksize (&attr, __pthread_get_minstack (&attr));
+  __pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+
+  /* Block all signals in the helper thread but SIGSETXID.  */
+  sigset_t ss;
+  __sigfillset (&ss);
+  __sigdelset (&ss, SIGSETXID);
+  pthread_t th;
+  bool ok = (__pthread_attr_setsigmask_internal (&attr, &ss) == 0
+	     && __pthread_create (&th, &attr, start, NULL) == 0);
+
+  __pthread_attr_destroy (&attr);
+  return ok;
+#endif
+}
@@ -60,6 +60,9 @@ enum
 #ifdef __USE_GNU
   /* For compatibility.  */
   , PTHREAD_MUTEX_FAST_NP = PTHREAD_MUTEX_TIMED_NP
+  /* Waiters queue up and the lock is preferably handed over within a
+     NUMA node.  */
+  , PTHREAD_MUTEX_QUEUED_NP = PTHREAD_MUTEX_ADAPTIVE_NP + 1
 #endif
 };
 
@@ -96,6 +99,8 @@ enum
  { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_ERRORCHECK_NP) } }
 # define PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP \
  { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_ADAPTIVE_NP) } }
+# define PTHREAD_QUEUED_MUTEX_INITIALIZER_NP \
+ { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_QUEUED_NP) } }
 #endif
 
 
@@ -106,6 +111,7 @@ enum
   PTHREAD_RWLOCK_PREFER_READER_NP,
   PTHREAD_RWLOCK_PREFER_WRITER_NP,
   PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+  PTHREAD_RWLOCK_READER_BIASED_NP,
   PTHREAD_RWLOCK_DEFAULT_NP = PTHREAD_RWLOCK_PREFER_READER_NP
 };
 
@@ -152,7 +158,7 @@ enum
 
 
 /* Conditional variable handling.  */
-#define PTHREAD_COND_INITIALIZER { { {0}, {0}, {0, 0}, 0, 0, {0, 0}, 0, 0 } }
+#define PTHREAD_COND_INITIALIZER { { {0}, {0}, {0, 0}, 0, 0, {0, 0}, {0} } }
 
 
 /* Cleanup buffers */
@@ -421,6 +427,20 @@ extern int pthread_attr_getsigmask_np (const pthread_attr_t *__attr,
    mask has not been set.  */
 #define PTHREAD_ATTR_NO_SIGMASK_NP (-1)
 
+/* If FASTSPAWN is 1, create threads with *ATTR without the per-thread
+   setup that only some threads need: no rseq or robust mutex list
+   registration, and no release of unused stack memory on exit.  If
+   FASTSPAWN is 0, restore the default.  */
+extern int pthread_attr_setfastspawn_np (pthread_attr_t *__attr,
+					 int __fastspawn)
+     __THROW __nonnull ((1));
+
+/* Store 1 in *FASTSPAWN if threads created with *ATTR are spawned
+   fast, and 0 otherwise.  */
+extern int pthread_attr_getfastspawn_np (const pthread_attr_t *__attr,
+					 int *__fastspawn)
+     __THROW __nonnull ((1, 2));
+
 /* Set the default attributes to be used by pthread_create in this
    process.  */
 extern int pthread_setattr_default_np (const pthread_attr_t *__attr)
@@ -866,6 +886,14 @@ pthread_mutex_consistent_np is deprecated, use pthread_mutex_consistent");
 # endif
 #endif
 
+#ifdef __USE_GNU
+/* Write the profile of blocking waits in mutexes, read-write locks and
+   condition variables collected if the glibc.pthread.lock_profile_rate
+   tunable is set, as text, to FD.  Return 0 on success, or an error
+   number.  */
+extern int pthread_lock_profile_dump_np (int __fd) __THROW;
+#endif
+
 
 /* Functions for handling mutex attributes.  */
 
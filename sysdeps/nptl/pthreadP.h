@@ -23,6 +23,8 @@
 #include <pthread.h>
 #include <setjmp.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/param.h>
 #include <sys/syscall.h>
 #include <nptl/descr.h>
 #include <tls.h>
@@ -48,6 +50,62 @@ static inline short max_adaptive_count (void)
   return __mutex_aconf.spin_count;
 }
 
+/* The __spins field of an adaptive mutex holds two statistics of recent
+   acquisitions which had to wait.  The low bits are a moving average of
+   the number of spins they needed, which bounds the next spin.  The top
+   bits count spins which did not acquire the mutex because the owner
+   held it longer than the spin budget, or was not running: once enough
+   of them accumulated, waiters block without spinning, and only spin
+   again after some acquisitions, to see whether holds got shorter.
+   __spins is only updated by the owner, after acquiring the mutex.  */
+#define PTHREAD_MUTEX_SPINS_MASK		0x0fff
+#define PTHREAD_MUTEX_SPINS_FUTILE_SHIFT	12
+#define PTHREAD_MUTEX_SPINS_FUTILE_MAX		15
+#define PTHREAD_MUTEX_SPINS_FUTILE_STEP		4
+#define PTHREAD_MUTEX_SPINS_FUTILE_BLOCK	8
+
+/* Return the maximum number of spins for a waiter of the adaptive
+   MUTEX, or 0 if it should block right away.  */
+static inline int
+adaptive_spin_limit (const pthread_mutex_t *mutex)
+{
+  unsigned int spins = (unsigned short) mutex->__data.__spins;
+  if ((spins >> PTHREAD_MUTEX_SPINS_FUTILE_SHIFT)
+      >= PTHREAD_MUTEX_SPINS_FUTILE_BLOCK)
+    return 0;
+  int avg = spins & PTHREAD_MUTEX_SPINS_MASK;
+  return MIN (max_adaptive_count (), avg * 2 + 10);
+}
+
+/* Record in MUTEX, just acquired, that the waiter spun CNT times out of
+   MAX_CNT allowed by adaptive_spin_limit.  */
+static inline void
+adaptive_spin_update (pthread_mutex_t *mutex, int cnt, int max_cnt)
+{
+  unsigned int spins = (unsigned short) mutex->__data.__spins;
+  int avg = spins & PTHREAD_MUTEX_SPINS_MASK;
+  unsigned int futile = spins >> PTHREAD_MUTEX_SPINS_FUTILE_SHIFT;
+
+  if (max_cnt == 0)
+    {
+      /* Blocked without spinning.  */
+      if (futile > 0)
+	--futile;
+    }
+  else
+    {
+      avg += (cnt - avg) / 8;
+      avg = MIN (avg, PTHREAD_MUTEX_SPINS_MASK);
+      if (cnt >= max_cnt)
+	futile = MIN (futile + PTHREAD_MUTEX_SPINS_FUTILE_STEP,
+		      PTHREAD_MUTEX_SPINS_FUTILE_MAX);
+      else
+	futile /= 2;
+    }
+
+  mutex->__data.__spins = avg | (futile << PTHREAD_MUTEX_SPINS_FUTILE_SHIFT);
+}
+
 
 /* Magic cookie representing robust mutex with dead owner.  */
 #define PTHREAD_MUTEX_INCONSISTENT	INT_MAX
@@ -145,6 +203,83 @@ enum
 					 << (sizeof (unsigned int) * 8 - 1))
 #define PTHREAD_RWLOCK_FUTEX_USED	2
 
+/* Bits of __bias of PTHREAD_RWLOCK_READER_BIASED_NP rwlocks.  */
+#define PTHREAD_RWLOCK_BIAS_KIND	1
+#define PTHREAD_RWLOCK_BIAS_ENABLED	2
+
+/* Visible readers table of biased rwlocks, see pthread_rwlock_common.c.  */
+#define PTHREAD_RWLOCK_BIAS_SLOTS	4096
+struct pthread_rwlock_bias_slot
+{
+  pthread_rwlock_t *rwlock;
+  struct pthread *thread;
+};
+extern struct pthread_rwlock_bias_slot
+  __pthread_rwlock_bias_slots[PTHREAD_RWLOCK_BIAS_SLOTS] attribute_hidden;
+extern unsigned int __pthread_rwlock_bias_waiters attribute_hidden;
+extern unsigned int __pthread_rwlock_bias_wake_seq attribute_hidden;
+extern void __pthread_rwlock_bias_wake (void) attribute_hidden;
+extern int __pthread_rwlock_bias_revoke (pthread_rwlock_t *rwlock,
+					 clockid_t clockid,
+					 const struct __timespec64 *abstime,
+					 bool try) attribute_hidden;
+extern void __pthread_rwlock_bias_enable (pthread_rwlock_t *rwlock)
+     attribute_hidden;
+
+/* Combining-tree barriers, see pthread_barrier_tree.c.  */
+extern int __pthread_barrier_tree_create (struct pthread_barrier_tree **treep,
+					 unsigned int count) attribute_hidden;
+extern int __pthread_barrier_tree_wait (struct pthread_barrier_tree *tree)
+     attribute_hidden;
+extern void __pthread_barrier_tree_destroy (struct pthread_barrier_tree *tree)
+     attribute_hidden;
+
+
+/* Kinds of waits recorded by the lock contention profiler, see
+   pthread_lock_profile.c.  */
+enum
+{
+  LOCK_PROFILE_MUTEX,
+  LOCK_PROFILE_RDLOCK,
+  LOCK_PROFILE_WRLOCK,
+  LOCK_PROFILE_COND
+};
+
+/* One in this many contended acquisitions is sampled by the profiler,
+   or none if 0.  Set by glibc.pthread.lock_profile_rate.  */
+extern unsigned int __nptl_lock_profile_rate attribute_hidden;
+/* Protects the profile.  */
+extern int __nptl_lock_profile_lock attribute_hidden;
+extern uint64_t __nptl_lock_profile_wait (void) attribute_hidden;
+extern void __nptl_lock_profile_done (void *lock, unsigned int kind,
+				      void *site, uint64_t start)
+     attribute_hidden;
+
+/* Profiler state of an acquisition: 0 before the first wait,
+   LOCK_PROFILE_SKIP if the acquisition is not sampled, and the time the
+   first wait started otherwise.  */
+#define LOCK_PROFILE_SKIP UINT64_MAX
+
+/* Call before each futex wait of an acquisition with profiler state
+   *STATE.  */
+static __always_inline void
+lock_profile_wait (uint64_t *state)
+{
+  if (__glibc_unlikely (__nptl_lock_profile_rate != 0) && *state == 0)
+    *state = __nptl_lock_profile_wait ();
+}
+
+/* Call once the acquisition of LOCK of KIND with profiler state STATE
+   is complete.  SITE is the return address of the caller of the public
+   locking function.  */
+static __always_inline void
+lock_profile_done (void *lock, unsigned int kind, void *site,
+		   uint64_t state)
+{
+  if (__glibc_unlikely (state != 0) && state != LOCK_PROFILE_SKIP)
+    __nptl_lock_profile_done (lock, kind, site, state);
+}
+
 
 /* Bits used in robust mutex implementation.  */
 #define FUTEX_WAITERS		0x80000000
@@ -348,6 +483,8 @@ extern int __pthread_mutex_cond_lock (pthread_mutex_t *__mutex)
      attribute_hidden;
 extern void __pthread_mutex_cond_lock_adjust (pthread_mutex_t *__mutex)
      attribute_hidden;
+extern void __pthread_mutex_queued_lock (pthread_mutex_t *__mutex,
+					 bool __cond) attribute_hidden;
 extern int __pthread_mutex_unlock (pthread_mutex_t *__mutex);
 libc_hidden_proto (__pthread_mutex_unlock)
 extern int __pthread_mutex_unlock_usercnt (pthread_mutex_t *__mutex,
@@ -96,6 +96,37 @@ extern int __REDIRECT (sem_clockwait,
 # endif
 #endif
 
+#ifdef __USE_GNU
+/* Wait until one of the NSEMS semaphores in SEMS can be decremented,
+   decrement it, and return its index.  If several can, the one with the
+   lowest index is decremented.
+
+   These functions are cancellation points and therefore not marked with
+   __THROW.  */
+extern int sem_waitany (sem_t *const __sems[], unsigned int __nsems)
+  __nonnull ((1));
+
+/* Similar to `sem_waitany' but wait only until ABSTIME, measured against
+   CLOCK, or forever if ABSTIME is null.  */
+# ifndef __USE_TIME64_REDIRECTS
+extern int sem_clockwaitany (sem_t *const __sems[], unsigned int __nsems,
+			     clockid_t __clock,
+			     const struct timespec *__abstime)
+  __nonnull ((1));
+# else
+#  ifdef __REDIRECT
+extern int __REDIRECT (sem_clockwaitany,
+		       (sem_t *const __sems[], unsigned int __nsems,
+			clockid_t __clock,
+			const struct timespec *__abstime),
+		       __sem_clockwaitany64)
+  __nonnull ((1));
+#  else
+#   define sem_clockwaitany __sem_clockwaitany64
+#  endif
+# endif
+#endif
+
 /* Test whether SEM is posted.  */
 extern int sem_trywait (sem_t *__sem) __THROWNL __nonnull ((1));
 
@@ -0,0 +1,430 @@
+/* Parallel relocation of the initial objects.  Linux version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The objects are relocated in waves.  An object is placed in the wave
+   after the last wave containing one of its dependencies, so that its
+   IFUNC resolvers and those it binds to only run once the objects they
+   may call into are relocated, as with serial relocation.  The main
+   program, which may have copy relocations against any object, is left
+   to the caller and relocated after all others.
+
+   Objects which define IFUNC symbols or have IRELATIVE relocations are
+   relocated alone, by the main thread, once all objects preceding them
+   in the order of serial relocation are relocated, exactly as with
+   serial relocation.  Only the objects between two such objects are
+   scheduled in waves.  Thus an IFUNC resolver never runs while the
+   object containing it is relocated concurrently, or before an object
+   which interposes symbols it uses has been relocated serially.
+   Resolvers may still run in a helper thread, when an object relocated
+   there binds to an IFUNC symbol.
+
+   The helper threads are created with clone before libc is initialized.
+   They share the thread pointer of the main thread and only run
+   relocation code.  They wait for the start of a wave on a futex, take
+   objects from the wave until it is exhausted, and exit once all waves
+   are done.  Relocation errors terminate the process, as they do during
+   serial relocation at startup.
+
+   The statistics counters for symbol lookups are not updated atomically,
+   and parallel relocation is disabled with LD_DEBUG.  */
+
+#include <atomic.h>
+#include <clone_internal.h>
+#include <dl-bind-cache.h>
+#include <dl-reloc-parallel.h>
+#include <futex-internal.h>
+#include <sched.h>
+#include <stackinfo.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <dl-tunables.h>
+
+#ifndef MAP_STACK
+# define MAP_STACK 0
+#endif
+
+bool _dl_relocate_parallel_active;
+int _dl_relocate_parallel_lock;
+
+/* The maximum number of helper threads, which corresponds to the
+   maximum of the glibc.rtld.relocation_threads tunable.  */
+enum { reloc_max_helpers = 63 };
+
+/* Relocation needs little stack space, but IFUNC resolvers run on the
+   helper stacks as well.  */
+#define RELOC_HELPER_STACK_SIZE (256 * 1024)
+
+struct reloc_helper
+{
+  void *mapping;
+  size_t mapping_size;
+  /* Cleared by the kernel when the thread exits.  */
+  pid_t tid;
+};
+
+static struct
+{
+  /* The objects in wave order.  */
+  struct link_map **order;
+  int reloc_mode;
+
+  /* The next object to relocate, and the end of the current wave.  */
+  unsigned int next;
+  unsigned int end;
+
+  /* Number of helpers which have not finished the current wave.  */
+  unsigned int busy;
+
+  /* Incremented to start a wave, or to terminate the helpers.  */
+  unsigned int generation;
+  bool exiting;
+} reloc_state;
+
+/* Relocate objects of the current wave until none are left.  */
+static void
+reloc_wave_objects (void)
+{
+  while (true)
+    {
+      unsigned int i = atomic_fetch_add_relaxed (&reloc_state.next, 1);
+      if (i >= reloc_state.end)
+	break;
+      struct link_map *l = reloc_state.order[i];
+      _dl_relocate_object (l, l->l_scope, reloc_state.reloc_mode, 0);
+    }
+}
+
+/* CLOSURE is the generation at the time the helper was created.  */
+static int
+reloc_helper_start (void *closure)
+{
+  unsigned int seen = (uintptr_t) closure;
+  while (true)
+    {
+      unsigned int generation = atomic_load_acquire (&reloc_state.generation);
+      if (generation == seen)
+	{
+	  futex_wait_simple (&reloc_state.generation, generation,
+			     FUTEX_PRIVATE);
+	  continue;
+	}
+      seen = generation;
+      if (reloc_state.exiting)
+	return 0;
+
+      reloc_wave_objects ();
+      if (atomic_fetch_add_release (&reloc_state.busy, -1) == 1)
+	futex_wake (&reloc_state.busy, 1, FUTEX_PRIVATE);
+    }
+}
+
+static bool
+reloc_helper_create (struct reloc_helper *helper)
+{
+  size_t guard = GLRO(dl_pagesize);
+  size_t size = RELOC_HELPER_STACK_SIZE + guard;
+  char *mapping = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+			  MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (mapping == MAP_FAILED)
+    return false;
+#if _STACK_GROWS_DOWN
+  char *stack = mapping + guard;
+  __mprotect (mapping, guard, PROT_NONE);
+#else
+  char *stack = mapping;
+  __mprotect (mapping + RELOC_HELPER_STACK_SIZE, guard, PROT_NONE);
+#endif
+
+  /* The helper does not get its own thread pointer.  */
+  struct clone_args args =
+    {
+      .flags = (CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND
+		| CLONE_THREAD | CLONE_SYSVSEM | CLONE_PARENT_SETTID
+		| CLONE_CHILD_CLEARTID),
+      .parent_tid = (uintptr_t) &helper->tid,
+      .child_tid = (uintptr_t) &helper->tid,
+      .stack = (uintptr_t) stack,
+      .stack_size = RELOC_HELPER_STACK_SIZE,
+    };
+  void *generation
+    = (void *) (uintptr_t) atomic_load_relaxed (&reloc_state.generation);
+  if (__clone_internal (&args, reloc_helper_start, generation) == -1)
+    {
+      __munmap (mapping, size);
+      return false;
+    }
+  helper->mapping = mapping;
+  helper->mapping_size = size;
+  return true;
+}
+
+/* Relocate the objects from START to END, using NHELPERS helpers.  */
+static void
+reloc_wave (unsigned int start, unsigned int end, unsigned int nhelpers)
+{
+  atomic_store_relaxed (&reloc_state.next, start);
+  reloc_state.end = end;
+  if (end - start < 2)
+    {
+      reloc_wave_objects ();
+      return;
+    }
+
+  atomic_store_relaxed (&reloc_state.busy, nhelpers);
+  atomic_fetch_add_release (&reloc_state.generation, 1);
+  futex_wake (&reloc_state.generation, INT_MAX, FUTEX_PRIVATE);
+
+  reloc_wave_objects ();
+
+  unsigned int busy;
+  while ((busy = atomic_load_acquire (&reloc_state.busy)) != 0)
+    futex_wait_simple (&reloc_state.busy, busy, FUTEX_PRIVATE);
+}
+
+/* Return true if relocation table START of SIZE bytes, with entries of
+   ENTSIZE bytes, contains IRELATIVE relocations.  */
+static bool
+reloc_table_has_irelative (const void *start, size_t size, size_t entsize)
+{
+  for (const char *p = start; p + entsize <= (const char *) start + size;
+       p += entsize)
+    {
+      /* ElfW(Rel) and ElfW(Rela) start with the same fields.  */
+      ElfW(Addr) info = ((const ElfW(Rel) *) p)->r_info;
+#ifdef ELF_MACHINE_IRELATIVE
+      if (ELFW(R_TYPE) (info) == ELF_MACHINE_IRELATIVE)
+	return true;
+#else
+      /* Without the relocation type, be conservative: in the PLT
+	 relocations, which are the only ones passed here, IRELATIVE
+	 relocations are those without a symbol.  IRELATIVE relocations
+	 for the addresses of local IFUNC symbols are in the other tables
+	 and not detected, but objects with local IFUNC symbols nearly
+	 always call them through the PLT, or define global ones.  */
+      if (ELFW(R_SYM) (info) == 0)
+	return true;
+#endif
+    }
+  return false;
+}
+
+/* Return true if L must be relocated alone, because IFUNC resolvers run
+   while it is relocated, or because it contains IFUNC resolvers which
+   other objects may invoke.  */
+static bool
+reloc_needs_serial (struct link_map *l)
+{
+  const ElfW(Sym) *symtab = (const void *) D_PTR (l, l_info[DT_SYMTAB]);
+  if (l->l_info[ELF_MACHINE_GNU_HASH_ADDRIDX] != NULL)
+    {
+      /* All defined symbols are hashed.  */
+      for (Elf32_Word b = 0; b < l->l_nbuckets; ++b)
+	{
+	  Elf32_Word i = l->l_gnu_buckets[b];
+	  if (i == 0)
+	    continue;
+	  do
+	    {
+	      const ElfW(Sym) *sym
+		= &symtab[ELF_MACHINE_HASH_SYMIDX (l, &l->l_gnu_chain_zero[i])];
+	      if (ELFW(ST_TYPE) (sym->st_info) == STT_GNU_IFUNC
+		  && sym->st_shndx != SHN_UNDEF)
+		return true;
+	    }
+	  while ((l->l_gnu_chain_zero[i++] & 1) == 0);
+	}
+    }
+  else if (l->l_info[DT_HASH] != NULL)
+    {
+      Elf_Symndx nchain
+	= ((const Elf_Symndx *) D_PTR (l, l_info[DT_HASH]))[1];
+      for (Elf_Symndx i = 0; i < nchain; ++i)
+	if (ELFW(ST_TYPE) (symtab[i].st_info) == STT_GNU_IFUNC
+	    && symtab[i].st_shndx != SHN_UNDEF)
+	  return true;
+    }
+  else
+    return true;
+
+  if (l->l_info[DT_JMPREL] != NULL
+      && reloc_table_has_irelative
+	   ((const void *) D_PTR (l, l_info[DT_JMPREL]),
+	    l->l_info[DT_PLTRELSZ]->d_un.d_val,
+	    (l->l_info[DT_PLTREL]->d_un.d_val == DT_RELA
+	     ? sizeof (ElfW(Rela)) : sizeof (ElfW(Rel)))))
+    return true;
+#ifdef ELF_MACHINE_IRELATIVE
+  if (l->l_info[DT_RELA] != NULL
+      && reloc_table_has_irelative
+	   ((const void *) D_PTR (l, l_info[DT_RELA]),
+	    l->l_info[DT_RELASZ]->d_un.d_val, sizeof (ElfW(Rela))))
+    return true;
+  if (l->l_info[DT_REL] != NULL
+      && reloc_table_has_irelative
+	   ((const void *) D_PTR (l, l_info[DT_REL]),
+	    l->l_info[DT_RELSZ]->d_un.d_val, sizeof (ElfW(Rel))))
+    return true;
+#endif
+  return false;
+}
+
+void
+_dl_relocate_parallel (struct link_map *main_map, int reloc_mode)
+{
+  int32_t nthreads = TUNABLE_GET (glibc, rtld, relocation_threads, int32_t,
+				  NULL);
+  if (nthreads < 2
+      || GLRO(dl_naudit) > 0
+      || GLRO(dl_profile) != NULL
+      || GLRO(dl_debug_mask) != 0
+      || _dl_bind_cache_mode != dl_bind_cache_disabled)
+    return;
+
+  unsigned int nlist = main_map->l_searchlist.r_nlist;
+  struct link_map **objects = malloc (2 * nlist * sizeof (*objects));
+  unsigned int *level = malloc (nlist * sizeof (*level));
+  unsigned int *wave_end = malloc ((nlist + 1) * sizeof (*wave_end));
+  if (objects == NULL || level == NULL || wave_end == NULL)
+    goto out;
+
+  /* Collect the objects in the order of serial relocation, which
+     relocates dependencies first.  L_IDX is the index in OBJECTS, or -1
+     if the object is not relocated here or has not been visited yet
+     (because of a dependency cycle).  LEVEL is 1 for objects which must
+     be relocated alone, until it is set to the wave of the object
+     below.  */
+  for (unsigned int i = 0; i < nlist; ++i)
+    main_map->l_initfini[i]->l_idx = -1;
+  unsigned int n = 0;
+  unsigned int nserial = 0;
+  for (unsigned int i = nlist; i-- > 0; )
+    {
+      struct link_map *l = main_map->l_initfini[i];
+      if (l == main_map || l->l_relocated)
+	continue;
+      l->l_idx = n;
+      level[n] = reloc_needs_serial (l);
+      nserial += level[n];
+      objects[n++] = l;
+    }
+
+  /* There is nothing to do in parallel if all objects are relocated
+     alone.  */
+  if (n - nserial < 2)
+    goto out;
+
+  reloc_state.reloc_mode = reloc_mode;
+  reloc_state.exiting = false;
+  reloc_state.generation = 0;
+
+  struct reloc_helper helpers[reloc_max_helpers];
+  unsigned int created = 0;
+  _dl_relocate_parallel_active = true;
+
+  /* Relocate the objects between two objects which must be relocated
+     alone, [START, I), in waves, and then the object at I.  */
+  struct link_map **order = objects + nlist;
+  unsigned int start = 0;
+  for (unsigned int i = 0; i <= n; ++i)
+    {
+      bool serial = i < n && level[i] != 0;
+      if (i < n && !serial)
+	continue;
+
+      /* Compute the waves.  Dependencies before START are relocated
+	 already.  */
+      unsigned int nwaves = 0;
+      unsigned int largest = 0;
+      for (unsigned int j = start; j < i; ++j)
+	{
+	  struct link_map *l = objects[j];
+	  unsigned int wave = 0;
+	  if (l->l_initfini != NULL)
+	    for (struct link_map **dep = &l->l_initfini[1]; *dep != NULL;
+		 ++dep)
+	      if ((*dep)->l_idx >= (int) start && (*dep)->l_idx < (int) j
+		  && level[(*dep)->l_idx] + 1 > wave)
+		wave = level[(*dep)->l_idx] + 1;
+	  level[j] = wave;
+	  if (wave + 1 > nwaves)
+	    {
+	      wave_end[wave] = 0;
+	      nwaves = wave + 1;
+	    }
+	  ++wave_end[wave];
+	  if (wave_end[wave] > largest)
+	    largest = wave_end[wave];
+	}
+
+      /* Sort the objects by wave, keeping the serial order within a
+	 wave.  WAVE_END[W] is the number of objects in wave W, then the
+	 end of wave W in ORDER.  */
+      for (unsigned int w = 0, total = start; w < nwaves; ++w)
+	{
+	  total += wave_end[w];
+	  wave_end[w] = total;
+	}
+      for (unsigned int j = i; j-- > start; )
+	order[--wave_end[level[j]]] = objects[j];
+      /* Now WAVE_END[W] is the start of wave W.  */
+      wave_end[nwaves] = i;
+
+      if (largest >= 2)
+	{
+	  unsigned int nhelpers = nthreads - 1;
+	  if (nhelpers > reloc_max_helpers)
+	    nhelpers = reloc_max_helpers;
+	  if (nhelpers > largest - 1)
+	    nhelpers = largest - 1;
+	  while (created < nhelpers
+		 && reloc_helper_create (&helpers[created]))
+	    ++created;
+	}
+
+      reloc_state.order = order;
+      for (unsigned int w = 0; w < nwaves; ++w)
+	reloc_wave (wave_end[w], wave_end[w + 1], created);
+
+      if (serial)
+	_dl_relocate_object (objects[i], objects[i]->l_scope, reloc_mode, 0);
+      start = i + 1;
+    }
+
+  if (created > 0)
+    {
+      reloc_state.exiting = true;
+      atomic_fetch_add_release (&reloc_state.generation, 1);
+      futex_wake (&reloc_state.generation, INT_MAX, FUTEX_PRIVATE);
+      for (unsigned int i = 0; i < created; ++i)
+	{
+	  unsigned int tid;
+	  while ((tid = atomic_load_acquire ((unsigned int *) &helpers[i].tid))
+		 != 0)
+	    futex_wait_simple ((unsigned int *) &helpers[i].tid, tid,
+			       FUTEX_SHARED);
+	  __munmap (helpers[i].mapping, helpers[i].mapping_size);
+	}
+    }
+  _dl_relocate_parallel_active = false;
+
+ out:
+  free (wave_end);
+  free (level);
+  free (objects);
+}
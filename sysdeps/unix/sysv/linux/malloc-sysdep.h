@@ -18,6 +18,7 @@
 
 #include <fcntl.h>
 #include <not-cancel.h>
+#include <rseq-internal.h>
 
 /* The Linux kernel overcommits address space by default and if there is not
    enough memory available, it uses various parameters to decide the process to
@@ -56,4 +57,14 @@ check_may_shrink_heap (void)
   return may_shrink_heap;
 }
 
+/* Return the CPU the calling thread is currently running on, as published
+   by the kernel in the rseq area, or a negative value if rseq registration
+   failed or is disabled.  The result may be stale as soon as it is read, so
+   callers must only use it as a placement hint.  */
+static inline int
+malloc_getcpu (void)
+{
+  return (int) RSEQ_GETMEM_ONCE (cpu_id);
+}
+
 #define HAVE_MREMAP 1
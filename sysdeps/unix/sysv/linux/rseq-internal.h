@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <kernel-features.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <sys/rseq.h>
 #include <ldsodefs.h>
@@ -93,6 +94,25 @@ RSEQ_SELF (void)
   return (struct rseq_area *) ((char *) __thread_pointer () + __rseq_offset);
 }
 
+/* Return the CPU the calling thread runs on, or a negative value if the
+   thread is not registered with rseq.  */
+static inline int
+rseq_current_cpu (void)
+{
+  return (int) RSEQ_GETMEM_ONCE (cpu_id);
+}
+
+/* Return the NUMA node of the CPU the calling thread runs on, or -1 if
+   the kernel does not report it through rseq.  */
+static inline int
+rseq_current_node (void)
+{
+  if (__rseq_size >= offsetof (struct rseq_area, node_id) + sizeof (uint32_t)
+      && (int) RSEQ_GETMEM_ONCE (cpu_id) >= 0)
+    return RSEQ_GETMEM_ONCE (node_id);
+  return -1;
+}
+
 #ifdef RSEQ_SIG
 static inline bool
 rseq_register_current_thread (struct pthread *self, bool do_rseq)
@@ -0,0 +1,108 @@
+/* Test per-CPU malloc arenas (glibc.malloc.percpu_arena=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Many more threads than CPUs allocate memory concurrently and free
+   part of it on another thread.  With per-CPU arenas, the number of
+   arenas must not exceed the number of configured CPUs.  */
+
+#include <array_length.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/rseq.h>
+#include <sys/sysinfo.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+#include <support/xthread.h>
+
+enum
+  {
+    thread_count = 64,
+    allocations = 1000,
+  };
+
+static pthread_barrier_t barrier;
+
+/* Blocks allocated by thread I are freed by thread I + 1.  */
+static void *blocks[thread_count][allocations];
+
+static void *
+thread_function (void *closure)
+{
+  size_t self = (uintptr_t) closure;
+  size_t peer = (self + thread_count - 1) % thread_count;
+
+  for (size_t i = 0; i < allocations; ++i)
+    {
+      size_t size = 16 + (i * 37) % 4096;
+      blocks[self][i] = xmalloc (size);
+      memset (blocks[self][i], (int) self, size);
+    }
+
+  xpthread_barrier_wait (&barrier);
+
+  for (size_t i = 0; i < allocations; ++i)
+    free (blocks[peer][i]);
+
+  return NULL;
+}
+
+/* Return the number of arenas reported by malloc_info.  */
+static size_t
+count_arenas (void)
+{
+  struct xmemstream info;
+  xopen_memstream (&info);
+  TEST_COMPARE (malloc_info (0, info.out), 0);
+  xfclose_memstream (&info);
+
+  size_t count = 0;
+  for (const char *p = info.buffer; (p = strstr (p, "<heap nr=")) != NULL;
+       ++p)
+    ++count;
+  free (info.buffer);
+  return count;
+}
+
+static int
+do_test (void)
+{
+  if (__rseq_size == 0)
+    FAIL_UNSUPPORTED ("rseq registration is not available");
+
+  xpthread_barrier_init (&barrier, NULL, thread_count);
+
+  pthread_t threads[thread_count];
+  for (size_t i = 0; i < array_length (threads); ++i)
+    threads[i] = xpthread_create (NULL, thread_function, (void *) i);
+  for (size_t i = 0; i < array_length (threads); ++i)
+    xpthread_join (threads[i]);
+
+  size_t arenas = count_arenas ();
+  int cpus = get_nprocs_conf ();
+  printf ("info: %zu arenas for %d configured CPUs\n", arenas, cpus);
+  TEST_VERIFY (arenas >= 1);
+  TEST_VERIFY (arenas <= (size_t) cpus);
+
+  xpthread_barrier_destroy (&barrier);
+  return 0;
+}
+
+#include <support/test-driver.c>